@@ -85,6 +85,22 @@ static bpReaderTypes::cReadOptions Convert(bpReaderTypesC_OptionsPtr aOptions)
 }
 
 
+static bpReaderTypes::cReadOptions Convert(bpReaderTypesC_OptionsV2Ptr aOptions)
+{
+  if (!aOptions) {
+    return{};
+  }
+
+  bpReaderTypes::cReadOptions vOptions;
+  vOptions.mSWMR = aOptions->mSWMR;
+  vOptions.mFileDriver = static_cast<bpReaderTypes::tFileDriver>(aOptions->mFileDriver);
+  vOptions.mFileImage = aOptions->mFileImage;
+  vOptions.mFileImageSizeBytes = static_cast<bpSize>(aOptions->mFileImageSize);
+  vOptions.mPageBufferSizeBytes = static_cast<bpSize>(aOptions->mPageBufferSize);
+  return vOptions;
+}
+
+
 static bpVec3 Convert(bpReaderTypesC_IndexTCRPtr aIndex) {
   bpVec3 vIndex;
   vIndex[0] = aIndex->mT;
@@ -299,6 +315,12 @@ bpReaderTypesC_DataTypeVectorPtr bpImageReaderC_GetFileImagesInformation(bpReade
   return vDataTypeVectorPtr;
 }
 
+bpReaderTypesC_DataTypeVectorPtr bpImageReaderC_GetFileImagesInformationWithOptions(bpReaderTypesC_String aInputFile, bpReaderTypesC_OptionsV2Ptr aOptions) {
+  bpReaderTypesC_DataTypeVectorPtr vDataTypeVectorPtr = new bpReaderTypesC_DataTypeVector;
+  Convert(vDataTypeVectorPtr, GetFileImagesInformation(Convert(aInputFile), Convert(aOptions)));
+  return vDataTypeVectorPtr;
+}
+
 void bpImageReaderC_FreeDataTypes(bpReaderTypesC_DataTypeVectorPtr aDataTypes) {
   free(aDataTypes->mDataTypes);
 }
@@ -316,6 +338,18 @@ bpImageReaderCPtr bpImageReaderC_CreateUInt32(bpReaderTypesC_String aInputFile,
 bpImageReaderCPtr bpImageReaderC_CreateFloat(bpReaderTypesC_String aInputFile, unsigned int aImageIndex, bpReaderTypesC_OptionsPtr aOptions) {
   return reinterpret_cast<bpImageReaderCPtr>(new bpImageReader<bpFloat>(Convert(aInputFile), aImageIndex, Convert(aOptions)));
 }
+bpImageReaderCPtr bpImageReaderC_CreateUInt8WithOptions(bpReaderTypesC_String aInputFile, unsigned int aImageIndex, bpReaderTypesC_OptionsV2Ptr aOptions) {
+  return reinterpret_cast<bpImageReaderCPtr>(new bpImageReader<bpUInt8>(Convert(aInputFile), aImageIndex, Convert(aOptions)));
+}
+bpImageReaderCPtr bpImageReaderC_CreateUInt16WithOptions(bpReaderTypesC_String aInputFile, unsigned int aImageIndex, bpReaderTypesC_OptionsV2Ptr aOptions) {
+  return reinterpret_cast<bpImageReaderCPtr>(new bpImageReader<bpUInt16>(Convert(aInputFile), aImageIndex, Convert(aOptions)));
+}
+bpImageReaderCPtr bpImageReaderC_CreateUInt32WithOptions(bpReaderTypesC_String aInputFile, unsigned int aImageIndex, bpReaderTypesC_OptionsV2Ptr aOptions) {
+  return reinterpret_cast<bpImageReaderCPtr>(new bpImageReader<bpUInt32>(Convert(aInputFile), aImageIndex, Convert(aOptions)));
+}
+bpImageReaderCPtr bpImageReaderC_CreateFloatWithOptions(bpReaderTypesC_String aInputFile, unsigned int aImageIndex, bpReaderTypesC_OptionsV2Ptr aOptions) {
+  return reinterpret_cast<bpImageReaderCPtr>(new bpImageReader<bpFloat>(Convert(aInputFile), aImageIndex, Convert(aOptions)));
+}
 
 
 void bpImageReaderC_DestroyUInt8(bpImageReaderCPtr aImageReaderC) {
@@ -350,6 +384,40 @@ void bpImageReaderC_ReadDataFloat(bpImageReaderCPtr aImageReaderC, bpReaderTypes
 }
 
 
+template<typename TDataType>
+static void ReadDataBatch(bpImageReaderCPtr aImageReaderC, bpReaderTypesC_Index5DPtr aBegins, bpReaderTypesC_Index5DPtr aEnds,
+                          const unsigned int* aResolutionIndices, TDataType** aData, unsigned int aNumberOfRequests)
+{
+  if (aNumberOfRequests > 0 && (!aResolutionIndices || !aData)) {
+    throw "Requests are not optional.";
+  }
+
+  std::vector<typename bpImageReader<TDataType>::cReadRequest> vRequests;
+  vRequests.reserve(aNumberOfRequests);
+  for (unsigned int vIndex = 0; vIndex < aNumberOfRequests; ++vIndex) {
+    vRequests.push_back({ Convert(aBegins + vIndex), Convert(aEnds + vIndex), aResolutionIndices[vIndex], aData[vIndex] });
+  }
+  reinterpret_cast<bpImageReader<TDataType>*>(aImageReaderC)->ReadDataBatch(vRequests);
+}
+
+void bpImageReaderC_ReadDataBatchUInt8(bpImageReaderCPtr aImageReaderC, bpReaderTypesC_Index5DPtr aBegins, bpReaderTypesC_Index5DPtr aEnds,
+                                       const unsigned int* aResolutionIndices, bpReaderTypesC_UInt8** aData, unsigned int aNumberOfRequests) {
+  ReadDataBatch<bpUInt8>(aImageReaderC, aBegins, aEnds, aResolutionIndices, aData, aNumberOfRequests);
+}
+void bpImageReaderC_ReadDataBatchUInt16(bpImageReaderCPtr aImageReaderC, bpReaderTypesC_Index5DPtr aBegins, bpReaderTypesC_Index5DPtr aEnds,
+                                        const unsigned int* aResolutionIndices, bpReaderTypesC_UInt16** aData, unsigned int aNumberOfRequests) {
+  ReadDataBatch<bpUInt16>(aImageReaderC, aBegins, aEnds, aResolutionIndices, aData, aNumberOfRequests);
+}
+void bpImageReaderC_ReadDataBatchUInt32(bpImageReaderCPtr aImageReaderC, bpReaderTypesC_Index5DPtr aBegins, bpReaderTypesC_Index5DPtr aEnds,
+                                        const unsigned int* aResolutionIndices, bpReaderTypesC_UInt32** aData, unsigned int aNumberOfRequests) {
+  ReadDataBatch<bpUInt32>(aImageReaderC, aBegins, aEnds, aResolutionIndices, aData, aNumberOfRequests);
+}
+void bpImageReaderC_ReadDataBatchFloat(bpImageReaderCPtr aImageReaderC, bpReaderTypesC_Index5DPtr aBegins, bpReaderTypesC_Index5DPtr aEnds,
+                                       const unsigned int* aResolutionIndices, bpReaderTypesC_Float** aData, unsigned int aNumberOfRequests) {
+  ReadDataBatch<bpFloat>(aImageReaderC, aBegins, aEnds, aResolutionIndices, aData, aNumberOfRequests);
+}
+
+
 void bpImageReaderC_ReadMetadataUInt8(bpImageReaderCPtr aImageReaderC, bpReaderTypesC_Size5DVectorPtr aImageSizePerResolution,
                                  bpReaderTypesC_Size5DVectorPtr aBlockSizePerResolution, bpReaderTypesC_ImageExtentPtr aImageExtent,
                                  bpReaderTypesC_TimeInfoVectorPtr aTimeInfoPerTimePoint, bpReaderTypesC_ColorInfoVectorPtr aColorInfoPerChannel,
@@ -431,6 +499,58 @@ void bpImageReaderC_ReadMetadataFloat(bpImageReaderCPtr aImageReaderC, bpReaderT
   aCompressionAlgorithmType = Convert(vCompressionAlgorithmType);
 }
 
+template<typename TDataType>
+static void ReadMetadataFields(bpImageReaderCPtr aImageReaderC, unsigned int aFields, bpReaderTypesC_Size5DVectorPtr aImageSizePerResolution,
+                               bpReaderTypesC_Size5DVectorPtr aBlockSizePerResolution, bpReaderTypesC_ImageExtentPtr aImageExtent,
+                               bpReaderTypesC_TimeInfoVectorPtr aTimeInfoPerTimePoint, bpReaderTypesC_ColorInfoVectorPtr aColorInfoPerChannel,
+                               bpReaderTypesC_CompressionAlgorithmType& aCompressionAlgorithmType)
+{
+  std::vector<bpConverterTypes::tSize5D> vImageSizePerResolution;
+  std::vector<bpConverterTypes::tSize5D> vBlockSizePerResolution;
+  bpConverterTypes::cImageExtent vImageExtent{};
+  bpConverterTypes::tTimeInfoVector vTimeInfoPerTimePoint;
+  bpConverterTypes::tColorInfoVector vColorInfoPerChannel;
+  bpConverterTypes::tCompressionAlgorithmType vCompressionAlgorithmType = bpConverterTypes::eCompressionAlgorithmNone;
+  reinterpret_cast<bpImageReader<TDataType>*>(aImageReaderC)->ReadMetadata(aFields, vImageSizePerResolution, vBlockSizePerResolution,
+                                                                           vImageExtent, vTimeInfoPerTimePoint,
+                                                                           vColorInfoPerChannel, vCompressionAlgorithmType);
+  Convert(aImageSizePerResolution, vImageSizePerResolution);
+  Convert(aBlockSizePerResolution, vBlockSizePerResolution);
+  Convert(aImageExtent, vImageExtent);
+  Convert(aTimeInfoPerTimePoint, vTimeInfoPerTimePoint);
+  Convert(aColorInfoPerChannel, vColorInfoPerChannel);
+  aCompressionAlgorithmType = Convert(vCompressionAlgorithmType);
+}
+
+void bpImageReaderC_ReadMetadataFieldsUInt8(bpImageReaderCPtr aImageReaderC, unsigned int aFields, bpReaderTypesC_Size5DVectorPtr aImageSizePerResolution,
+                                            bpReaderTypesC_Size5DVectorPtr aBlockSizePerResolution, bpReaderTypesC_ImageExtentPtr aImageExtent,
+                                            bpReaderTypesC_TimeInfoVectorPtr aTimeInfoPerTimePoint, bpReaderTypesC_ColorInfoVectorPtr aColorInfoPerChannel,
+                                            bpReaderTypesC_CompressionAlgorithmType& aCompressionAlgorithmType) {
+  ReadMetadataFields<bpUInt8>(aImageReaderC, aFields, aImageSizePerResolution, aBlockSizePerResolution, aImageExtent,
+                              aTimeInfoPerTimePoint, aColorInfoPerChannel, aCompressionAlgorithmType);
+}
+void bpImageReaderC_ReadMetadataFieldsUInt16(bpImageReaderCPtr aImageReaderC, unsigned int aFields, bpReaderTypesC_Size5DVectorPtr aImageSizePerResolution,
+                                             bpReaderTypesC_Size5DVectorPtr aBlockSizePerResolution, bpReaderTypesC_ImageExtentPtr aImageExtent,
+                                             bpReaderTypesC_TimeInfoVectorPtr aTimeInfoPerTimePoint, bpReaderTypesC_ColorInfoVectorPtr aColorInfoPerChannel,
+                                             bpReaderTypesC_CompressionAlgorithmType& aCompressionAlgorithmType) {
+  ReadMetadataFields<bpUInt16>(aImageReaderC, aFields, aImageSizePerResolution, aBlockSizePerResolution, aImageExtent,
+                               aTimeInfoPerTimePoint, aColorInfoPerChannel, aCompressionAlgorithmType);
+}
+void bpImageReaderC_ReadMetadataFieldsUInt32(bpImageReaderCPtr aImageReaderC, unsigned int aFields, bpReaderTypesC_Size5DVectorPtr aImageSizePerResolution,
+                                             bpReaderTypesC_Size5DVectorPtr aBlockSizePerResolution, bpReaderTypesC_ImageExtentPtr aImageExtent,
+                                             bpReaderTypesC_TimeInfoVectorPtr aTimeInfoPerTimePoint, bpReaderTypesC_ColorInfoVectorPtr aColorInfoPerChannel,
+                                             bpReaderTypesC_CompressionAlgorithmType& aCompressionAlgorithmType) {
+  ReadMetadataFields<bpUInt32>(aImageReaderC, aFields, aImageSizePerResolution, aBlockSizePerResolution, aImageExtent,
+                               aTimeInfoPerTimePoint, aColorInfoPerChannel, aCompressionAlgorithmType);
+}
+void bpImageReaderC_ReadMetadataFieldsFloat(bpImageReaderCPtr aImageReaderC, unsigned int aFields, bpReaderTypesC_Size5DVectorPtr aImageSizePerResolution,
+                                            bpReaderTypesC_Size5DVectorPtr aBlockSizePerResolution, bpReaderTypesC_ImageExtentPtr aImageExtent,
+                                            bpReaderTypesC_TimeInfoVectorPtr aTimeInfoPerTimePoint, bpReaderTypesC_ColorInfoVectorPtr aColorInfoPerChannel,
+                                            bpReaderTypesC_CompressionAlgorithmType& aCompressionAlgorithmType) {
+  ReadMetadataFields<bpFloat>(aImageReaderC, aFields, aImageSizePerResolution, aBlockSizePerResolution, aImageExtent,
+                              aTimeInfoPerTimePoint, aColorInfoPerChannel, aCompressionAlgorithmType);
+}
+
 void bpImageReaderC_FreeMetadata(bpReaderTypesC_Size5DVectorPtr aImageSizePerResolution, bpReaderTypesC_Size5DVectorPtr aBlockSizePerResolution,
                                  bpReaderTypesC_TimeInfoVectorPtr aTimeInfoPerTimePoint, bpReaderTypesC_ColorInfoVectorPtr aColorInfoPerChannel) {
   free(aImageSizePerResolution->mSizePerResolution);
@@ -29,6 +29,14 @@ class bpfImageConverterImpl;
  // image reader template should be created according to the given type for a specific image
 BP_IMARISREADER_DLL_API std::vector<bpConverterTypes::tDataType> GetFileImagesInformation(const bpString& aInputFile, bool aSWMR);
 
+// as above, opening the file as a reader with aOptions would, e.g. from a file image
+BP_IMARISREADER_DLL_API std::vector<bpConverterTypes::tDataType> GetFileImagesInformation(const bpString& aInputFile, const bpReaderTypes::cReadOptions& aOptions);
+
+
+// opens image aImageIndex as a bpImageReader of the type GetFileImagesInformation returns for it, nullptr if that
+// type has no reader; the converted, display and RGBA reads of bpImageReaderBaseInterface need no knowledge of the type
+BP_IMARISREADER_DLL_API bpUniquePtr<bpImageReaderBaseInterface> CreateImageReader(const bpString& aInputFile, bpSize aImageIndex, const bpReaderTypes::cReadOptions& aOptions);
+
 
 template<class TDataType>
 class BP_IMARISREADER_DLL_API bpImageReader : public bpImageReaderInterface<TDataType>
@@ -45,14 +53,53 @@ public:
     bpConverterTypes::tColorInfoVector& aColorInfoPerChannel,
     bpConverterTypes::tCompressionAlgorithmType& aCompressionAlgorithmType) override;
 
+  void ReadMetadata(
+    bpReaderTypes::tMetadataFields aFields,
+    std::vector<bpConverterTypes::tSize5D>& aImageSizePerResolution,
+    std::vector<bpConverterTypes::tSize5D>& aFileBlockSizePerResolution,
+    bpConverterTypes::cImageExtent& aImageExtent,
+    bpConverterTypes::tTimeInfoVector& aTimeInfoPerTimePoint,
+    bpConverterTypes::tColorInfoVector& aColorInfoPerChannel,
+    bpConverterTypes::tCompressionAlgorithmType& aCompressionAlgorithmType) override;
+
   void ReadParameters(bpConverterTypes::tParameters& aParameters) override;
 
   void ReadData(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData) override;
 
+  void ReadData(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData, const bpConverterTypes::tSize5D& aByteStrides, TDataType aFillValue) override;
+
+  using typename bpImageReaderInterface<TDataType>::cReadRequest;
+
+  void ReadDataBatch(const std::vector<cReadRequest>& aRequests) override;
+
+  const TDataType* ReadDataView(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex) override;
+
+  void ReadDataConverted(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpFloat* aData, bpFloat aScale, bpFloat aOffset) override;
+
+  void ReadDataConverted(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpReaderTypes::cFloat16* aData, bpFloat aScale, bpFloat aOffset) override;
+
+  void ReadDataConverted(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, bpFloat aScale, bpFloat aOffset) override;
+
+  void ReadDataDisplay(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, const bpConverterTypes::tColorInfoVector& aColorInfoPerChannel) override;
+
+  void ReadDataRGBA(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, const bpConverterTypes::tColorInfoVector& aColorInfoPerChannel) override;
+
+  using typename bpImageReaderInterface<TDataType>::tReadCallback;
+
+  std::future<bpReaderTypes::tReadStatus> ReadDataAsync(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData,
+    bpReaderTypes::tReadPriority aPriority, const bpReaderTypes::cCancellationToken& aToken) override;
+
+  void ReadDataAsync(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData, tReadCallback aCallback,
+    bpReaderTypes::tReadPriority aPriority, const bpReaderTypes::cCancellationToken& aToken) override;
+
   bpImageReaderBaseInterface::cHistogram ReadHistogram(const bpVec3& aIndexTCR) override;
 
   bpImageReaderBaseInterface::cThumbnail ReadThumbnail() override;
 
+  bpReaderTypes::cChunkCacheStatistics GetChunkCacheStatistics() override;
+
+  std::vector<bpReaderTypes::cReadPlanItem> PlanRead(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex) override;
+
 private:
   class cThreadSafeDecorator;
 
@@ -21,6 +21,8 @@
 
 #include "bpReaderTypes.h"
 
+#include <future>
+
 
 class bpImageReaderBaseInterface
 {
@@ -49,11 +51,40 @@ public:
     bpConverterTypes::tColorInfoVector& aColorInfoPerChannel,
     bpConverterTypes::tCompressionAlgorithmType& aCompressionAlgorithmType) = 0;
 
+  // as above, but only the fields in aFields are read, the other arguments are left unchanged
+  virtual void ReadMetadata(
+    bpReaderTypes::tMetadataFields aFields,
+    std::vector<bpConverterTypes::tSize5D>& aImageSizePerResolution,
+    std::vector<bpConverterTypes::tSize5D>& aFileBlockSizePerResolution,
+    bpConverterTypes::cImageExtent& aImageExtent,
+    bpConverterTypes::tTimeInfoVector& aTimeInfoPerTimePoint,
+    bpConverterTypes::tColorInfoVector& aColorInfoPerChannel,
+    bpConverterTypes::tCompressionAlgorithmType& aCompressionAlgorithmType) = 0;
+
   virtual void ReadParameters(bpConverterTypes::tParameters& aParameters) = 0;
 
   virtual cHistogram ReadHistogram(const bpVec3& aIndexTCR) = 0;
 
   virtual cThumbnail ReadThumbnail() = 0;
+
+  virtual bpReaderTypes::cChunkCacheStatistics GetChunkCacheStatistics() = 0;
+
+  // reads like ReadData of the stored type into a dense destination of another type, writing voxel * aScale + aOffset;
+  // uint8 results are rounded and clamped to [0, 255]
+  virtual void ReadDataConverted(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpFloat* aData, bpFloat aScale = 1, bpFloat aOffset = 0) = 0;
+  virtual void ReadDataConverted(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpReaderTypes::cFloat16* aData, bpFloat aScale = 1, bpFloat aOffset = 0) = 0;
+  virtual void ReadDataConverted(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, bpFloat aScale = 1, bpFloat aOffset = 0) = 0;
+
+  // reads like ReadData of the stored type into dense uint8, mapping each channel's [mRangeMin, mRangeMax] with mGammaCorrection
+  // to [0, 255] as cColorInfo::GetColor does; channels without an entry in aColorInfoPerChannel use the defaults
+  virtual void ReadDataDisplay(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, const bpConverterTypes::tColorInfoVector& aColorInfoPerChannel) = 0;
+
+  // reads like ReadDataDisplay and blends the channels additively into interleaved RGBA8, 4 bytes per voxel and
+  // one image per time point; each channel adds cColorInfo::GetColor times its opacity, saturating at 255
+  virtual void ReadDataRGBA(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, const bpConverterTypes::tColorInfoVector& aColorInfoPerChannel) = 0;
+
+  // the chunk parts ReadData(aBegin, aEnd, aResolutionIndex) would decode, parts outside of the image are not listed
+  virtual std::vector<bpReaderTypes::cReadPlanItem> PlanRead(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex) = 0;
 };
 
 
@@ -61,7 +92,36 @@ template<typename TDataType>
 class bpImageReaderInterface : public bpImageReaderBaseInterface
 {
 public:
+  // one dense destination of ReadDataBatch, laid out as by ReadData
+  struct cReadRequest
+  {
+    bpConverterTypes::tIndex5D mBegin;
+    bpConverterTypes::tIndex5D mEnd;
+    bpSize mResolutionIndex;
+    TDataType* mData;
+  };
+
   virtual void ReadData(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData) = 0;
+
+  // writes voxel (x, y, z, c, t) to aData + sum of (index - aBegin) * aByteStrides, parts outside of the image are set to aFillValue
+  virtual void ReadData(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData, const bpConverterTypes::tSize5D& aByteStrides, TDataType aFillValue = 0) = 0;
+
+  // reads all requests together, chunks shared by several requests are read and decoded once
+  virtual void ReadDataBatch(const std::vector<cReadRequest>& aRequests) = 0;
+
+  // the voxels of exactly one whole chunk of one time point and channel inside the file mapping, x fastest,
+  // valid as long as the reader; nullptr if mMemoryMapUncompressed is off, the chunk is compressed or not written
+  virtual const TDataType* ReadDataView(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex) = 0;
+
+  using tReadCallback = std::function<void(bpReaderTypes::tReadStatus)>;
+
+  // queues ReadData on the reader's executor, aData must stay valid until the returned future is ready
+  virtual std::future<bpReaderTypes::tReadStatus> ReadDataAsync(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData,
+    bpReaderTypes::tReadPriority aPriority = bpReaderTypes::eReadPriorityNormal, const bpReaderTypes::cCancellationToken& aToken = bpReaderTypes::cCancellationToken()) = 0;
+
+  // as above, aCallback is called on an executor thread once the read has finished or was dropped
+  virtual void ReadDataAsync(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData, tReadCallback aCallback,
+    bpReaderTypes::tReadPriority aPriority = bpReaderTypes::eReadPriorityNormal, const bpReaderTypes::cCancellationToken& aToken = bpReaderTypes::cCancellationToken()) = 0;
 };
 
 
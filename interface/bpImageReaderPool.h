@@ -0,0 +1,62 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BP_IMAGE_READER_POOL__
+#define __BP_IMAGE_READER_POOL__
+
+#include "bpImarisReaderDllAPI.h"
+#include "bpImageReader.h"
+
+
+/**
+ * Process-wide cache of readers for servers reading many files. Readers are
+ * keyed by (file, image index, data type) and constructed on first use; once
+ * more than aMaxOpenReaders are open, the least recently used readers that
+ * nobody holds are closed and reopened by the next GetReader.
+ *
+ * Readers still held by a caller are never closed, so the bound may be
+ * exceeded while they are in use; the readers over the bound are closed as
+ * soon as their callers release them. All methods may be called concurrently.
+ */
+class BP_IMARISREADER_DLL_API bpImageReaderPool
+{
+public:
+  bpImageReaderPool(bpSize aMaxOpenReaders, const bpReaderTypes::cReadOptions& aOptions);
+  ~bpImageReaderPool();
+
+  bpImageReaderPool(const bpImageReaderPool&) = delete;
+  bpImageReaderPool& operator=(const bpImageReaderPool&) = delete;
+
+  // the reader of image aImageIndex in aInputFile, TDataType as reported by GetFileImagesInformation;
+  // nullptr if the image cannot be opened, failed opens are not cached
+  template<typename TDataType>
+  bpSharedPtr<bpImageReader<TDataType>> GetReader(const bpString& aInputFile, bpSize aImageIndex);
+
+  // closes all readers nobody holds
+  void Clear();
+
+  bpReaderTypes::cReaderPoolStatistics GetStatistics();
+
+private:
+  class cCache;
+
+  bpSharedPtr<cCache> mCache;
+};
+
+
+#endif // __BP_IMAGE_READER_POOL__
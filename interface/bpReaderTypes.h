@@ -267,11 +267,178 @@ namespace bpConverterTypes
 
 #endif
 
+#include <atomic>
+
+class bpStorageInterface;
+
 namespace bpReaderTypes
 {
+  // order in which queued asynchronous reads are started, interactive reads overtake prefetching
+  enum tReadPriority {
+    eReadPriorityPrefetch = 0,
+    eReadPriorityNormal = 1,
+    eReadPriorityInteractive = 2
+  };
+
+  enum tReadStatus {
+    eReadStatusCompleted = 0,
+    eReadStatusCancelled = 1,
+    eReadStatusFailed = 2
+  };
+
+  // copies share their state, a cancelled read is dropped before its chunks are decoded
+  class cCancellationToken
+  {
+  public:
+    cCancellationToken()
+      : mIsCancelled(std::make_shared<std::atomic<bool>>(false))
+    {
+    }
+
+    void Cancel()
+    {
+      *mIsCancelled = true;
+    }
+
+    bool IsCancelled() const
+    {
+      return *mIsCancelled;
+    }
+
+  private:
+    bpSharedPtr<std::atomic<bool>> mIsCancelled;
+  };
+
+  enum tChunkCacheEvictionPolicy {
+    eChunkCacheEvictLeastRecentlyUsed = 0,
+    eChunkCacheEvictFirstInFirstOut = 1
+  };
+
+  // sizing of hdf5's own chunk cache of each open "Data" dataset
+  enum tH5ChunkCacheMode {
+    // hdf5's default of 1 MiB
+    eH5ChunkCacheDefault = 0,
+    // mH5ChunkCacheSizeBytes
+    eH5ChunkCacheFixed = 1,
+    // the chunks of the largest one chunk thick x, y or z slab of the dataset, at least one chunk, at most mH5ChunkCacheSizeBytes
+    eH5ChunkCacheAuto = 2
+  };
+
+  // how the file is opened
+  enum tFileDriver {
+    // reads the file on demand (hdf5 sec2 driver)
+    eFileDriverDefault = 0,
+    // loads the whole file into memory when it is opened (hdf5 core driver)
+    eFileDriverCore = 1,
+    // opens the bytes at mFileImage, the file name only identifies the image
+    eFileDriverImage = 2,
+    // reads through mStorage, the file name only identifies the storage
+    eFileDriverStorage = 3
+  };
+
+  struct cChunkCacheStatistics
+  {
+    bpUInt64 mHits = 0;
+    bpUInt64 mMisses = 0;
+    bpUInt64 mEvictions = 0;
+    bpSize mNumberOfChunks = 0;
+    bpSize mSizeBytes = 0;
+  };
+
+  struct cReaderPoolStatistics
+  {
+    // GetReader calls served by an open reader
+    bpUInt64 mHits = 0;
+    // readers constructed, including reopens of evicted readers
+    bpUInt64 mOpens = 0;
+    bpUInt64 mEvictions = 0;
+    bpSize mNumberOfOpenReaders = 0;
+    // wall time spent constructing readers
+    bpUInt64 mTotalOpenMicroseconds = 0;
+    bpUInt64 mMaxOpenMicroseconds = 0;
+  };
+
+  // IEEE 754 half precision value, as written by ReadDataConverted
+  struct cFloat16
+  {
+    bpUInt16 mBits;
+  };
+
+  // fields of the selective ReadMetadata, combined with |
+  enum tMetadataField {
+    eMetadataImageSize = 1 << 0,
+    eMetadataFileBlockSize = 1 << 1,
+    eMetadataImageExtent = 1 << 2,
+    eMetadataTimeInfo = 1 << 3,
+    eMetadataColorInfo = 1 << 4,
+    eMetadataCompressionAlgorithm = 1 << 5,
+    eMetadataAll = (1 << 6) - 1
+  };
+  using tMetadataFields = bpUInt32;
+
+  // the part of one chunk that a read copies, coordinates are [x, y, z] voxels of the resolution level
+  struct cReadPlanItem
+  {
+    bpSize mTimePointIndex = 0;
+    bpSize mChannelIndex = 0;
+    bpVec3 mChunkIndex{};
+    bpVec3 mChunkSize{};
+    // intersection of the chunk with the read
+    bpVec3 mBegin{};
+    bpVec3 mEnd{};
+    // offset of mBegin in elements from the start of the dense ReadData destination
+    bpSize mDestinationOffset = 0;
+  };
+
   struct cReadOptions
   {
     bool mSWMR = false;
+    // maximum number of (resolution, time point, channel) datasets kept open between ReadData calls
+    bpSize mDataSetHandleCacheSize = 64;
+    // read the raw chunks with H5Dread_chunk and decompress them on a pool of worker threads,
+    // reads of fewer chunks than threads also decode the blocks of an lz4 chunk in parallel
+    bool mParallelDecode = false;
+    // number of decode worker threads, 0 uses one per hardware thread
+    bpSize mNumberOfDecodeThreads = 0;
+    // memory budget for decoded chunks kept between ReadData calls, 0 disables the cache (ignored with SWMR)
+    bpSize mChunkCacheSizeBytes = 0;
+    tChunkCacheEvictionPolicy mChunkCacheEvictionPolicy = eChunkCacheEvictLeastRecentlyUsed;
+    // ReadData holds the reader lock only while calling hdf5, decompression and padding run concurrently
+    bool mConcurrentReadData = false;
+    // threads running ReadDataAsync requests, more than one only overlap with mConcurrentReadData
+    bpSize mNumberOfAsyncThreads = 1;
+    // maps the file and copies chunks of datasets without filters straight from the mapping (ignored with SWMR)
+    bool mMemoryMapUncompressed = false;
+    // hdf5's cache of decompressed chunks, one per open dataset, at most mDataSetHandleCacheSize are open.
+    // It only serves the datasets that ReadData reads with H5Dread; the raw chunk reads of mParallelDecode,
+    // mChunkCacheSizeBytes, mConcurrentReadData, mMemoryMapUncompressed, mCoalesceChunkReads, ReadDataBatch and
+    // mUnshuffleIntoDestination bypass it.
+    tH5ChunkCacheMode mH5ChunkCacheMode = eH5ChunkCacheDefault;
+    bpSize mH5ChunkCacheSizeBytes = 64 << 20;
+    // hash table slots, 0 picks a prime about 100 times the number of chunks that fit
+    bpSize mH5ChunkCacheSlots = 0;
+    // preemption policy in [0, 1], 1 evicts fully read chunks first
+    bpFloat mH5ChunkCachePreemption = 0.75f;
+    // core, image and storage drivers cannot be combined with mSWMR, image and storage ignore mMemoryMapUncompressed
+    tFileDriver mFileDriver = eFileDriverDefault;
+    // with eFileDriverImage, the bytes of an .ims file; copied when the file is opened
+    const void* mFileImage = nullptr;
+    bpSize mFileImageSizeBytes = 0;
+    // hdf5 page buffer for files written with paged aggregation, 0 disables it; ignored for other files
+    bpSize mPageBufferSizeBytes = 0;
+    // with eFileDriverStorage, the bytes of the file
+    bpSharedPtr<bpStorageInterface> mStorage;
+    // metadata reads from mStorage are widened to blocks of this size, which are kept for later reads; 0 disables it
+    bpSize mStorageReadAheadBytes = 64 << 10;
+    // ReadData locates the raw chunks with hdf5 but reads them from the file (or mStorage) itself, sorted by offset;
+    // chunks at most mCoalesceGapBytes apart are fetched with one read of up to mCoalesceMaxReadBytes
+    // (ignored with SWMR and with the core and image drivers)
+    bool mCoalesceChunkReads = false;
+    bpSize mCoalesceGapBytes = 64 << 10;
+    bpSize mCoalesceMaxReadBytes = 16 << 20;
+    // shuffled datasets are read as raw chunks and unshuffled straight into the destination instead of through
+    // H5Dread and hdf5's chunk cache (mParallelDecode and the other options that read raw chunks do so as well)
+    bool mUnshuffleIntoDestination = false;
   };
 };
 
@@ -0,0 +1,57 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BP_STORAGE__
+#define __BP_STORAGE__
+
+#include "bpImarisReaderDllAPI.h"
+#include "bpStorageInterface.h"
+
+
+/**
+ * A local file read with positioned reads, ReadRanges reads each run of
+ * contiguous ranges with one vectored read.
+ */
+class BP_IMARISREADER_DLL_API bpLocalStorage : public bpStorageInterface
+{
+public:
+  explicit bpLocalStorage(const bpString& aFileName);
+  ~bpLocalStorage();
+
+  bpLocalStorage(const bpLocalStorage&) = delete;
+  bpLocalStorage& operator=(const bpLocalStorage&) = delete;
+
+  bool IsOpen() const;
+
+  bpUInt64 GetSize() override;
+
+  bool Read(bpUInt64 aOffset, bpSize aSize, void* aData) override;
+
+  bool ReadRanges(const std::vector<cRange>& aRanges) override;
+
+private:
+#if defined(_WIN32)
+  void* mFile;
+#else
+  int mFile;
+#endif
+  bpUInt64 mSize;
+};
+
+
+#endif // __BP_STORAGE__
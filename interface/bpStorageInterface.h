@@ -0,0 +1,63 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BP_STORAGE_INTERFACE__
+#define __BP_STORAGE_INTERFACE__
+
+
+#include "bpReaderTypes.h"
+
+
+/**
+ * Random access to the bytes of one .ims file, e.g. a local file or an object
+ * in a remote store read with ranged requests. Readers opened with
+ * bpReaderTypes::eFileDriverStorage do all their file I/O through it.
+ * Methods may be called concurrently.
+ */
+class bpStorageInterface
+{
+public:
+  struct cRange
+  {
+    bpUInt64 mOffset;
+    bpSize mSize;
+    void* mData;
+  };
+
+  virtual ~bpStorageInterface() = default;
+
+  virtual bpUInt64 GetSize() = 0;
+
+  // reads the aSize bytes at aOffset, false if they cannot be read completely
+  virtual bool Read(bpUInt64 aOffset, bpSize aSize, void* aData) = 0;
+
+  // reads all ranges, ranges that start where the previous one ends may be read as one request
+  // (e.g. one preadv or one ranged request to a remote store); the default reads them one by one
+  virtual bool ReadRanges(const std::vector<cRange>& aRanges)
+  {
+    for (const cRange& vRange : aRanges) {
+      if (!Read(vRange.mOffset, vRange.mSize, vRange.mData)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+
+#endif // __BP_STORAGE_INTERFACE__
@@ -45,6 +45,7 @@ struct bpImageReaderC;
 typedef struct bpImageReaderC* bpImageReaderCPtr;
 
 BP_IMARISREADER_DLL_API bpReaderTypesC_DataTypeVectorPtr bpImageReaderC_GetFileImagesInformation(bpReaderTypesC_String aInputFile, bool aSWMR);
+BP_IMARISREADER_DLL_API bpReaderTypesC_DataTypeVectorPtr bpImageReaderC_GetFileImagesInformationWithOptions(bpReaderTypesC_String aInputFile, bpReaderTypesC_OptionsV2Ptr aOptions);
 
 BP_IMARISREADER_DLL_API void bpImageReaderC_FreeDataTypes(bpReaderTypesC_DataTypeVectorPtr aDataTypes);
 
@@ -52,6 +53,10 @@ BP_IMARISREADER_DLL_API bpImageReaderCPtr bpImageReaderC_CreateUInt8(bpReaderTyp
 BP_IMARISREADER_DLL_API bpImageReaderCPtr bpImageReaderC_CreateUInt16(bpReaderTypesC_String aInputFile, unsigned int aImageIndex, bpReaderTypesC_OptionsPtr aOptions);
 BP_IMARISREADER_DLL_API bpImageReaderCPtr bpImageReaderC_CreateUInt32(bpReaderTypesC_String aInputFile, unsigned int aImageIndex, bpReaderTypesC_OptionsPtr aOptions);
 BP_IMARISREADER_DLL_API bpImageReaderCPtr bpImageReaderC_CreateFloat(bpReaderTypesC_String aInputFile, unsigned int aImageIndex, bpReaderTypesC_OptionsPtr aOptions);
+BP_IMARISREADER_DLL_API bpImageReaderCPtr bpImageReaderC_CreateUInt8WithOptions(bpReaderTypesC_String aInputFile, unsigned int aImageIndex, bpReaderTypesC_OptionsV2Ptr aOptions);
+BP_IMARISREADER_DLL_API bpImageReaderCPtr bpImageReaderC_CreateUInt16WithOptions(bpReaderTypesC_String aInputFile, unsigned int aImageIndex, bpReaderTypesC_OptionsV2Ptr aOptions);
+BP_IMARISREADER_DLL_API bpImageReaderCPtr bpImageReaderC_CreateUInt32WithOptions(bpReaderTypesC_String aInputFile, unsigned int aImageIndex, bpReaderTypesC_OptionsV2Ptr aOptions);
+BP_IMARISREADER_DLL_API bpImageReaderCPtr bpImageReaderC_CreateFloatWithOptions(bpReaderTypesC_String aInputFile, unsigned int aImageIndex, bpReaderTypesC_OptionsV2Ptr aOptions);
 
 BP_IMARISREADER_DLL_API void bpImageReaderC_DestroyUInt8(bpImageReaderCPtr aImageReaderC);
 BP_IMARISREADER_DLL_API void bpImageReaderC_DestroyUInt16(bpImageReaderCPtr aImageReaderC);
@@ -67,6 +72,16 @@ BP_IMARISREADER_DLL_API void bpImageReaderC_ReadDataUInt32(bpImageReaderCPtr aIm
 BP_IMARISREADER_DLL_API void bpImageReaderC_ReadDataFloat(bpImageReaderCPtr aImageReaderC, bpReaderTypesC_Index5DPtr aBegin, bpReaderTypesC_Index5DPtr aEnd,
                                                           unsigned int aResolutionIndex, bpReaderTypesC_Float* aData);
 
+// request i reads [aBegins[i], aEnds[i]) of resolution aResolutionIndices[i] into aData[i], as bpImageReaderC_ReadData*
+BP_IMARISREADER_DLL_API void bpImageReaderC_ReadDataBatchUInt8(bpImageReaderCPtr aImageReaderC, bpReaderTypesC_Index5DPtr aBegins, bpReaderTypesC_Index5DPtr aEnds,
+                                                               const unsigned int* aResolutionIndices, bpReaderTypesC_UInt8** aData, unsigned int aNumberOfRequests);
+BP_IMARISREADER_DLL_API void bpImageReaderC_ReadDataBatchUInt16(bpImageReaderCPtr aImageReaderC, bpReaderTypesC_Index5DPtr aBegins, bpReaderTypesC_Index5DPtr aEnds,
+                                                                const unsigned int* aResolutionIndices, bpReaderTypesC_UInt16** aData, unsigned int aNumberOfRequests);
+BP_IMARISREADER_DLL_API void bpImageReaderC_ReadDataBatchUInt32(bpImageReaderCPtr aImageReaderC, bpReaderTypesC_Index5DPtr aBegins, bpReaderTypesC_Index5DPtr aEnds,
+                                                                const unsigned int* aResolutionIndices, bpReaderTypesC_UInt32** aData, unsigned int aNumberOfRequests);
+BP_IMARISREADER_DLL_API void bpImageReaderC_ReadDataBatchFloat(bpImageReaderCPtr aImageReaderC, bpReaderTypesC_Index5DPtr aBegins, bpReaderTypesC_Index5DPtr aEnds,
+                                                               const unsigned int* aResolutionIndices, bpReaderTypesC_Float** aData, unsigned int aNumberOfRequests);
+
 BP_IMARISREADER_DLL_API void bpImageReaderC_ReadMetadataUInt8(bpImageReaderCPtr aImageReaderC, bpReaderTypesC_Size5DVectorPtr aImageSizePerResolution,
                                                          bpReaderTypesC_Size5DVectorPtr aBlockSizePerResolution, bpReaderTypesC_ImageExtentPtr aImageExtent,
                                                          bpReaderTypesC_TimeInfoVectorPtr aTimeInfoPerTimePoint, bpReaderTypesC_ColorInfoVectorPtr aColorInfoPerChannel,
@@ -84,6 +99,24 @@ BP_IMARISREADER_DLL_API void bpImageReaderC_ReadMetadataFloat(bpImageReaderCPtr
                                                          bpReaderTypesC_TimeInfoVectorPtr aTimeInfoPerTimePoint, bpReaderTypesC_ColorInfoVectorPtr aColorInfoPerChannel,
                                                          bpReaderTypesC_CompressionAlgorithmType& aCompressionAlgorithmType);
 
+// as bpImageReaderC_ReadMetadata*, but only the bpReaderTypesC_MetadataField bits of aFields are read, the other fields are returned empty
+BP_IMARISREADER_DLL_API void bpImageReaderC_ReadMetadataFieldsUInt8(bpImageReaderCPtr aImageReaderC, unsigned int aFields, bpReaderTypesC_Size5DVectorPtr aImageSizePerResolution,
+                                                                    bpReaderTypesC_Size5DVectorPtr aBlockSizePerResolution, bpReaderTypesC_ImageExtentPtr aImageExtent,
+                                                                    bpReaderTypesC_TimeInfoVectorPtr aTimeInfoPerTimePoint, bpReaderTypesC_ColorInfoVectorPtr aColorInfoPerChannel,
+                                                                    bpReaderTypesC_CompressionAlgorithmType& aCompressionAlgorithmType);
+BP_IMARISREADER_DLL_API void bpImageReaderC_ReadMetadataFieldsUInt16(bpImageReaderCPtr aImageReaderC, unsigned int aFields, bpReaderTypesC_Size5DVectorPtr aImageSizePerResolution,
+                                                                     bpReaderTypesC_Size5DVectorPtr aBlockSizePerResolution, bpReaderTypesC_ImageExtentPtr aImageExtent,
+                                                                     bpReaderTypesC_TimeInfoVectorPtr aTimeInfoPerTimePoint, bpReaderTypesC_ColorInfoVectorPtr aColorInfoPerChannel,
+                                                                     bpReaderTypesC_CompressionAlgorithmType& aCompressionAlgorithmType);
+BP_IMARISREADER_DLL_API void bpImageReaderC_ReadMetadataFieldsUInt32(bpImageReaderCPtr aImageReaderC, unsigned int aFields, bpReaderTypesC_Size5DVectorPtr aImageSizePerResolution,
+                                                                     bpReaderTypesC_Size5DVectorPtr aBlockSizePerResolution, bpReaderTypesC_ImageExtentPtr aImageExtent,
+                                                                     bpReaderTypesC_TimeInfoVectorPtr aTimeInfoPerTimePoint, bpReaderTypesC_ColorInfoVectorPtr aColorInfoPerChannel,
+                                                                     bpReaderTypesC_CompressionAlgorithmType& aCompressionAlgorithmType);
+BP_IMARISREADER_DLL_API void bpImageReaderC_ReadMetadataFieldsFloat(bpImageReaderCPtr aImageReaderC, unsigned int aFields, bpReaderTypesC_Size5DVectorPtr aImageSizePerResolution,
+                                                                    bpReaderTypesC_Size5DVectorPtr aBlockSizePerResolution, bpReaderTypesC_ImageExtentPtr aImageExtent,
+                                                                    bpReaderTypesC_TimeInfoVectorPtr aTimeInfoPerTimePoint, bpReaderTypesC_ColorInfoVectorPtr aColorInfoPerChannel,
+                                                                    bpReaderTypesC_CompressionAlgorithmType& aCompressionAlgorithmType);
+
 BP_IMARISREADER_DLL_API void bpImageReaderC_FreeMetadata(bpReaderTypesC_Size5DVectorPtr aImageSizePerResolution, bpReaderTypesC_Size5DVectorPtr aBlockSizePerResolution,
                                                          bpReaderTypesC_TimeInfoVectorPtr aTimeInfoPerTimePoint, bpReaderTypesC_ColorInfoVectorPtr aColorInfoPerChannel);
 
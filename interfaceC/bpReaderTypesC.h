@@ -66,6 +66,27 @@ typedef struct
 } bpReaderTypesC_Options;
 typedef bpReaderTypesC_Options* bpReaderTypesC_OptionsPtr;
 
+// file drivers of bpReaderTypesC_OptionsV2
+typedef enum {
+  eFileDriverDefault = 0,
+  eFileDriverCore = 1,
+  eFileDriverImage = 2
+} bpReaderTypesC_FileDriver;
+
+// options of the ...WithOptions functions, bpReaderTypesC_Options stays unchanged for existing callers
+typedef struct
+{
+  bool mSWMR;
+  // a bpReaderTypesC_FileDriver
+  unsigned int mFileDriver;
+  // with eFileDriverImage, the bytes of an .ims file; copied when the reader is created
+  const void* mFileImage;
+  unsigned long long mFileImageSize;
+  // page buffer for files written with paged aggregation, 0 disables it
+  unsigned long long mPageBufferSize;
+} bpReaderTypesC_OptionsV2;
+typedef bpReaderTypesC_OptionsV2* bpReaderTypesC_OptionsV2Ptr;
+
 typedef struct
 {
   unsigned int mT;
@@ -171,6 +192,17 @@ typedef enum {
   eCompressionAlgorithmLShuffleLZ4 = 31
 } bpReaderTypesC_CompressionAlgorithmType;
 
+// metadata fields, combined with |
+typedef enum {
+  eMetadataImageSize = 1,
+  eMetadataFileBlockSize = 2,
+  eMetadataImageExtent = 4,
+  eMetadataTimeInfo = 8,
+  eMetadataColorInfo = 16,
+  eMetadataCompressionAlgorithm = 32,
+  eMetadataAll = 63
+} bpReaderTypesC_MetadataField;
+
 // parameters
 typedef struct {
   bpReaderTypesC_String mName;
@@ -30,6 +30,10 @@ import java.util.HashMap;
 public class jImarisReader {
 
     // --- C types ---
+    public static final int eFileDriverDefault = 0;
+    public static final int eFileDriverCore = 1;
+    public static final int eFileDriverImage = 2;
+
     public static class bpReaderTypesC_Options extends Structure {
         public boolean mSWMR;
 
@@ -39,6 +43,20 @@ public class jImarisReader {
         }
     }
 
+    public static class bpReaderTypesC_OptionsV2 extends Structure {
+        public boolean mSWMR;
+        public int mFileDriver;
+        // with eFileDriverImage, the bytes of an .ims file, e.g. a Memory
+        public Pointer mFileImage;
+        public long mFileImageSize;
+        public long mPageBufferSize;
+
+        @Override
+        protected List<String> getFieldOrder() {
+            return Arrays.asList("mSWMR", "mFileDriver", "mFileImage", "mFileImageSize", "mPageBufferSize");
+        }
+    }
+
     public static class bpReaderTypesC_DataTypesVector extends Structure {
         public Pointer mDataTypes;
         public int mDataTypesSize;
@@ -369,9 +387,11 @@ public class jImarisReader {
         Native.load("bpImarisReader", javaReader.class);
 
         bpReaderTypesC_DataTypesVector bpImageReaderC_GetFileImagesInformation(String aInputFile, boolean aSWMR);
+        bpReaderTypesC_DataTypesVector bpImageReaderC_GetFileImagesInformationWithOptions(String aInputFile, bpReaderTypesC_OptionsV2 aOptions);
         void bpImageReaderC_FreeDataTypes(bpReaderTypesC_DataTypesVector aDataTypes);
 
         Pointer bpImageReaderC_CreateUInt8(String aInputFile, int aImageIndex, bpReaderTypesC_Options aOptions);
+        Pointer bpImageReaderC_CreateUInt8WithOptions(String aInputFile, int aImageIndex, bpReaderTypesC_OptionsV2 aOptions);
         void bpImageReaderC_DestroyUInt8(Pointer aImageReaderC);
         void bpImageReaderC_ReadDataUInt8(Pointer aImageReaderC, bpReaderTypesC_5D aBegin, bpReaderTypesC_5D aEnd, int aResolutionIndex, Memory aData);
         void bpImageReaderC_ReadMetadataUInt8(Pointer aImageReaderC, bpReaderTypesC_5DVector aImageSizePerResolution,
@@ -383,6 +403,7 @@ public class jImarisReader {
         bpReaderTypesC_Thumbnail bpImageReaderC_ReadThumbnailUInt8(Pointer aImageReaderC);
 
         Pointer bpImageReaderC_CreateUInt16(String aInputFile, int aImageIndex, bpReaderTypesC_Options aOptions);
+        Pointer bpImageReaderC_CreateUInt16WithOptions(String aInputFile, int aImageIndex, bpReaderTypesC_OptionsV2 aOptions);
         void bpImageReaderC_DestroyUInt16(Pointer aImageReaderC);
         void bpImageReaderC_ReadDataUInt16(Pointer aImageReaderC, bpReaderTypesC_5D aBegin, bpReaderTypesC_5D aEnd, int aResolutionIndex, Memory aData);
         void bpImageReaderC_ReadMetadataUInt16(Pointer aImageReaderC, bpReaderTypesC_5DVector aImageSizePerResolution,
@@ -394,6 +415,7 @@ public class jImarisReader {
         bpReaderTypesC_Thumbnail bpImageReaderC_ReadThumbnailUInt16(Pointer aImageReaderC);
 
         Pointer bpImageReaderC_CreateUInt32(String aInputFile, int aImageIndex, bpReaderTypesC_Options aOptions);
+        Pointer bpImageReaderC_CreateUInt32WithOptions(String aInputFile, int aImageIndex, bpReaderTypesC_OptionsV2 aOptions);
         void bpImageReaderC_DestroyUInt32(Pointer aImageReaderC);
         void bpImageReaderC_ReadDataUInt32(Pointer aImageReaderC, bpReaderTypesC_5D aBegin, bpReaderTypesC_5D aEnd, int aResolutionIndex, Memory aData);
         void bpImageReaderC_ReadMetadataUInt32(Pointer aImageReaderC, bpReaderTypesC_5DVector aImageSizePerResolution,
@@ -405,6 +427,7 @@ public class jImarisReader {
         bpReaderTypesC_Thumbnail bpImageReaderC_ReadThumbnailUInt32(Pointer aImageReaderC);
 
         Pointer bpImageReaderC_CreateFloat(String aInputFile, int aImageIndex, bpReaderTypesC_Options aOptions);
+        Pointer bpImageReaderC_CreateFloatWithOptions(String aInputFile, int aImageIndex, bpReaderTypesC_OptionsV2 aOptions);
         void bpImageReaderC_DestroyFloat(Pointer aImageReaderC);
         void bpImageReaderC_ReadDataFloat(Pointer aImageReaderC, bpReaderTypesC_5D aBegin, bpReaderTypesC_5D aEnd, int aResolutionIndex, Memory aData);
         void bpImageReaderC_ReadMetadataFloat(Pointer aImageReaderC, bpReaderTypesC_5DVector aImageSizePerResolution,
@@ -425,14 +448,23 @@ public class jImarisReader {
     public static class bpFileImagesInfo {
         public String mInputFile;
         public boolean mSWMR;
+        bpReaderTypesC_OptionsV2 mOptions;
 
         public bpFileImagesInfo(String aFileName, boolean aSWMR) {
             this.mInputFile = aFileName;
             this.mSWMR = aSWMR;
         }
 
+        public bpFileImagesInfo(String aFileName, bpReaderTypesC_OptionsV2 aOptions) {
+            this.mInputFile = aFileName;
+            this.mSWMR = aOptions.mSWMR;
+            this.mOptions = aOptions;
+        }
+
         public ArrayList<Integer> GetFileImagesInformation() {
-            bpReaderTypesC_DataTypesVector vDataTypesC = javaReader.INSTANCE.bpImageReaderC_GetFileImagesInformation(this.mInputFile, this.mSWMR);
+            bpReaderTypesC_DataTypesVector vDataTypesC = this.mOptions != null
+                ? javaReader.INSTANCE.bpImageReaderC_GetFileImagesInformationWithOptions(this.mInputFile, this.mOptions)
+                : javaReader.INSTANCE.bpImageReaderC_GetFileImagesInformation(this.mInputFile, this.mSWMR);
             ArrayList<Integer> vDataTypes = new ArrayList<>();
             for (int vI = 0; vI < vDataTypesC.mDataTypesSize; vI++) {
                 vDataTypes.add(vDataTypesC.mDataTypes.getInt(vI * 4));
@@ -456,6 +488,12 @@ public class jImarisReader {
             this.mImageReaderPtr = javaReader.INSTANCE.bpImageReaderC_CreateUInt8(mInputFile, mImageIndex, mOptions);
         }
 
+        public bpImageReaderUInt8(String aFileName, int aIndex, bpReaderTypesC_OptionsV2 aOptions) {
+            this.mInputFile = aFileName;
+            this.mImageIndex = aIndex;
+            this.mImageReaderPtr = javaReader.INSTANCE.bpImageReaderC_CreateUInt8WithOptions(mInputFile, mImageIndex, aOptions);
+        }
+
         public void Destroy() {
             javaReader.INSTANCE.bpImageReaderC_DestroyUInt8(mImageReaderPtr);
         }
@@ -617,6 +655,12 @@ public class jImarisReader {
             this.mImageReaderPtr = javaReader.INSTANCE.bpImageReaderC_CreateUInt16(mInputFile, mImageIndex, mOptions);
         }
 
+        public bpImageReaderUInt16(String aFileName, int aIndex, bpReaderTypesC_OptionsV2 aOptions) {
+            this.mInputFile = aFileName;
+            this.mImageIndex = aIndex;
+            this.mImageReaderPtr = javaReader.INSTANCE.bpImageReaderC_CreateUInt16WithOptions(mInputFile, mImageIndex, aOptions);
+        }
+
         public void Destroy() {
             javaReader.INSTANCE.bpImageReaderC_DestroyUInt16(mImageReaderPtr);
         }
@@ -778,6 +822,12 @@ public class jImarisReader {
             this.mImageReaderPtr = javaReader.INSTANCE.bpImageReaderC_CreateUInt32(mInputFile, mImageIndex, mOptions);
         }
 
+        public bpImageReaderUInt32(String aFileName, int aIndex, bpReaderTypesC_OptionsV2 aOptions) {
+            this.mInputFile = aFileName;
+            this.mImageIndex = aIndex;
+            this.mImageReaderPtr = javaReader.INSTANCE.bpImageReaderC_CreateUInt32WithOptions(mInputFile, mImageIndex, aOptions);
+        }
+
         public void Destroy() {
             javaReader.INSTANCE.bpImageReaderC_DestroyUInt32(mImageReaderPtr);
         }
@@ -939,6 +989,12 @@ public class jImarisReader {
             this.mImageReaderPtr = javaReader.INSTANCE.bpImageReaderC_CreateFloat(mInputFile, mImageIndex, mOptions);
         }
 
+        public bpImageReaderFloat(String aFileName, int aIndex, bpReaderTypesC_OptionsV2 aOptions) {
+            this.mInputFile = aFileName;
+            this.mImageIndex = aIndex;
+            this.mImageReaderPtr = javaReader.INSTANCE.bpImageReaderC_CreateFloatWithOptions(mInputFile, mImageIndex, aOptions);
+        }
+
         public void Destroy() {
             javaReader.INSTANCE.bpImageReaderC_DestroyFloat(mImageReaderPtr);
         }
@@ -27,10 +27,22 @@ class bpImageReaderCPtr(Structure):
 
 bpReaderTypesC_String = c_char_p
 
+eFileDriverDefault = 0
+eFileDriverCore = 1
+eFileDriverImage = 2
+
 class bpReaderTypesC_Options(Structure):
     _fields_ = [('mSWMR', c_bool)]
 bpReaderTypesC_OptionsPtr = POINTER(bpReaderTypesC_Options)
 
+class bpReaderTypesC_OptionsV2(Structure):
+    _fields_ = [('mSWMR', c_bool),
+                ('mFileDriver', c_uint),
+                ('mFileImage', c_void_p),
+                ('mFileImageSize', c_ulonglong),
+                ('mPageBufferSize', c_ulonglong)]
+bpReaderTypesC_OptionsV2Ptr = POINTER(bpReaderTypesC_OptionsV2)
+
 bpReaderTypesC_DataType = c_int
 bpReaderTypesC_DataTypePtr = POINTER(bpReaderTypesC_DataType)
 class bpReaderTypesC_DataTypeVector(Structure):
@@ -138,6 +150,17 @@ bpReaderTypesC_ThumbnailPtr = POINTER(bpReaderTypesC_Thumbnail)
 class Options:
     def __init__(self):
         self.mSWMR = False
+        # eFileDriverDefault, eFileDriverCore or eFileDriverImage
+        self.mFileDriver = eFileDriverDefault
+        # with eFileDriverImage, the bytes of an .ims file
+        self.mFileImage : bytes = None
+        self.mPageBufferSize = 0
+
+    def get_c_options(self):
+        file_image = self.mFileImage if self.mFileImage else b''
+        c_options = bpReaderTypesC_OptionsV2(self.mSWMR, self.mFileDriver, cast(c_char_p(file_image), c_void_p),
+                                             len(file_image), self.mPageBufferSize)
+        return bpReaderTypesC_OptionsV2Ptr(c_options)
 
 class Index5D:
     def __init__(self, X, Y, Z, C, T):
@@ -213,10 +236,12 @@ class Parameters:
 class FileImagesInfo:
     def __init__(self,
                  input_filename : str,
-                 aSWMR : bool):
+                 aSWMR : bool,
+                 options : Options = None):
         self._load_dll()
         self._store_filename(input_filename)
         self.mSWMR = aSWMR
+        self.mOptions = options
 
     def _store_filename(self, input_filename):
         self.mInputFilename = self._get_c_char(input_filename)
@@ -241,9 +266,14 @@ class FileImagesInfo:
         self.mcdll = CDLL(lib_filename)
 
     def GetFileImagesInformation(self):
-        self.mcdll.bpImageReaderC_GetFileImagesInformation.argtypes = [bpReaderTypesC_String, c_bool]
-        self.mcdll.bpImageReaderC_GetFileImagesInformation.restype = bpReaderTypesC_DataTypeVectorPtr
-        dataTypes = self.mcdll.bpImageReaderC_GetFileImagesInformation(self.mInputFilename, self.mSWMR)
+        if self.mOptions:
+            self.mcdll.bpImageReaderC_GetFileImagesInformationWithOptions.argtypes = [bpReaderTypesC_String, bpReaderTypesC_OptionsV2Ptr]
+            self.mcdll.bpImageReaderC_GetFileImagesInformationWithOptions.restype = bpReaderTypesC_DataTypeVectorPtr
+            dataTypes = self.mcdll.bpImageReaderC_GetFileImagesInformationWithOptions(self.mInputFilename, self.mOptions.get_c_options())
+        else:
+            self.mcdll.bpImageReaderC_GetFileImagesInformation.argtypes = [bpReaderTypesC_String, c_bool]
+            self.mcdll.bpImageReaderC_GetFileImagesInformation.restype = bpReaderTypesC_DataTypeVectorPtr
+            dataTypes = self.mcdll.bpImageReaderC_GetFileImagesInformation(self.mInputFilename, self.mSWMR)
         dataTypes_py = []
         for i in range(dataTypes.contents.mDataTypesSize):
             dataTypes_py.append(dataTypes.contents.mDataTypes[i])
@@ -278,7 +308,9 @@ class ImageReaderUInt8:
         self.mImageIndex = image_index
 
     def _store_options(self, options):
-        self.mOptions = bpReaderTypesC_OptionsPtr(bpReaderTypesC_Options(options.mSWMR))
+        # the file image must stay alive until the reader is created
+        self.mFileImage = options.mFileImage
+        self.mOptions = options.get_c_options()
 
     def _get_lib_filename(self):
         if platform.system() == 'Windows':
@@ -296,11 +328,11 @@ class ImageReaderUInt8:
         self.mcdll = CDLL(lib_filename)
 
     def _create(self):
-        self.mcdll.bpImageReaderC_CreateUInt8.argtypes = [bpReaderTypesC_String, c_uint, bpReaderTypesC_OptionsPtr]
-        self.mcdll.bpImageReaderC_CreateUInt8.restype = bpImageReaderCPtr
-        self.mImageReaderPtr = self.mcdll.bpImageReaderC_CreateUInt8(self.mInputFilename,
-                                                                    self.mImageIndex,
-                                                                    self.mOptions)
+        self.mcdll.bpImageReaderC_CreateUInt8WithOptions.argtypes = [bpReaderTypesC_String, c_uint, bpReaderTypesC_OptionsV2Ptr]
+        self.mcdll.bpImageReaderC_CreateUInt8WithOptions.restype = bpImageReaderCPtr
+        self.mImageReaderPtr = self.mcdll.bpImageReaderC_CreateUInt8WithOptions(self.mInputFilename,
+                                                                                self.mImageIndex,
+                                                                                self.mOptions)
 
     def ReadData(self, begin : Index5D, end : Index5D, resolution_index : int, buffer):
         self.mcdll.bpImageReaderC_ReadDataUInt8.argtypes = [bpImageReaderCPtr, bpReaderTypesC_Index5DPtr, bpReaderTypesC_Index5DPtr, c_uint, POINTER(bpReaderTypesC_UInt8)]
@@ -426,7 +458,9 @@ class ImageReaderUInt16:
         self.mImageIndex = image_index
 
     def _store_options(self, options):
-        self.mOptions = bpReaderTypesC_OptionsPtr(bpReaderTypesC_Options(options.mSWMR))
+        # the file image must stay alive until the reader is created
+        self.mFileImage = options.mFileImage
+        self.mOptions = options.get_c_options()
 
     def _get_lib_filename(self):
         if platform.system() == 'Windows':
@@ -444,11 +478,11 @@ class ImageReaderUInt16:
         self.mcdll = CDLL(lib_filename)
 
     def _create(self):
-        self.mcdll.bpImageReaderC_CreateUInt16.argtypes = [bpReaderTypesC_String, c_uint, bpReaderTypesC_OptionsPtr]
-        self.mcdll.bpImageReaderC_CreateUInt16.restype = bpImageReaderCPtr
-        self.mImageReaderPtr = self.mcdll.bpImageReaderC_CreateUInt16(self.mInputFilename,
-                                                                    self.mImageIndex,
-                                                                    self.mOptions)
+        self.mcdll.bpImageReaderC_CreateUInt16WithOptions.argtypes = [bpReaderTypesC_String, c_uint, bpReaderTypesC_OptionsV2Ptr]
+        self.mcdll.bpImageReaderC_CreateUInt16WithOptions.restype = bpImageReaderCPtr
+        self.mImageReaderPtr = self.mcdll.bpImageReaderC_CreateUInt16WithOptions(self.mInputFilename,
+                                                                                 self.mImageIndex,
+                                                                                 self.mOptions)
 
     def ReadData(self, begin : Index5D, end : Index5D, resolution_index : int, buffer):
         self.mcdll.bpImageReaderC_ReadDataUInt16.argtypes = [bpImageReaderCPtr, bpReaderTypesC_Index5DPtr, bpReaderTypesC_Index5DPtr, c_uint, POINTER(bpReaderTypesC_UInt16)]
@@ -574,7 +608,9 @@ class ImageReaderUInt32:
         self.mImageIndex = image_index
 
     def _store_options(self, options):
-        self.mOptions = bpReaderTypesC_OptionsPtr(bpReaderTypesC_Options(options.mSWMR))
+        # the file image must stay alive until the reader is created
+        self.mFileImage = options.mFileImage
+        self.mOptions = options.get_c_options()
 
     def _get_lib_filename(self):
         if platform.system() == 'Windows':
@@ -592,11 +628,11 @@ class ImageReaderUInt32:
         self.mcdll = CDLL(lib_filename)
 
     def _create(self):
-        self.mcdll.bpImageReaderC_CreateUInt32.argtypes = [bpReaderTypesC_String, c_uint, bpReaderTypesC_OptionsPtr]
-        self.mcdll.bpImageReaderC_CreateUInt32.restype = bpImageReaderCPtr
-        self.mImageReaderPtr = self.mcdll.bpImageReaderC_CreateUInt32(self.mInputFilename,
-                                                                    self.mImageIndex,
-                                                                    self.mOptions)
+        self.mcdll.bpImageReaderC_CreateUInt32WithOptions.argtypes = [bpReaderTypesC_String, c_uint, bpReaderTypesC_OptionsV2Ptr]
+        self.mcdll.bpImageReaderC_CreateUInt32WithOptions.restype = bpImageReaderCPtr
+        self.mImageReaderPtr = self.mcdll.bpImageReaderC_CreateUInt32WithOptions(self.mInputFilename,
+                                                                                 self.mImageIndex,
+                                                                                 self.mOptions)
 
     def ReadData(self, begin : Index5D, end : Index5D, resolution_index : int, buffer):
         self.mcdll.bpImageReaderC_ReadDataUInt32.argtypes = [bpImageReaderCPtr, bpReaderTypesC_Index5DPtr, bpReaderTypesC_Index5DPtr, c_uint, POINTER(bpReaderTypesC_UInt32)]
@@ -722,7 +758,9 @@ class ImageReaderFloat:
         self.mImageIndex = image_index
 
     def _store_options(self, options):
-        self.mOptions = bpReaderTypesC_OptionsPtr(bpReaderTypesC_Options(options.mSWMR))
+        # the file image must stay alive until the reader is created
+        self.mFileImage = options.mFileImage
+        self.mOptions = options.get_c_options()
 
     def _get_lib_filename(self):
         if platform.system() == 'Windows':
@@ -740,11 +778,11 @@ class ImageReaderFloat:
         self.mcdll = CDLL(lib_filename)
 
     def _create(self):
-        self.mcdll.bpImageReaderC_CreateFloat.argtypes = [bpReaderTypesC_String, c_uint, bpReaderTypesC_OptionsPtr]
-        self.mcdll.bpImageReaderC_CreateFloat.restype = bpImageReaderCPtr
-        self.mImageReaderPtr = self.mcdll.bpImageReaderC_CreateFloat(self.mInputFilename,
-                                                                    self.mImageIndex,
-                                                                    self.mOptions)
+        self.mcdll.bpImageReaderC_CreateFloatWithOptions.argtypes = [bpReaderTypesC_String, c_uint, bpReaderTypesC_OptionsV2Ptr]
+        self.mcdll.bpImageReaderC_CreateFloatWithOptions.restype = bpImageReaderCPtr
+        self.mImageReaderPtr = self.mcdll.bpImageReaderC_CreateFloatWithOptions(self.mInputFilename,
+                                                                                self.mImageIndex,
+                                                                                self.mOptions)
 
     def ReadData(self, begin : Index5D, end : Index5D, resolution_index : int, buffer):
         self.mcdll.bpImageReaderC_ReadDataFloat.argtypes = [bpImageReaderCPtr, bpReaderTypesC_Index5DPtr, bpReaderTypesC_Index5DPtr, c_uint, POINTER(bpReaderTypesC_Float)]
@@ -0,0 +1,67 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#include "ImarisReader/reader/bpBufferPool.h"
+
+
+bpBufferPool::bpBufferPool(bpfSize aMaxBuffers, bpfSize aMaxSizeBytes)
+  : mMaxBuffers(aMaxBuffers),
+    mMaxSizeBytes(aMaxSizeBytes),
+    mSizeBytes(0)
+{
+}
+
+
+std::vector<bpfUInt8> bpBufferPool::Get(bpfSize aSize)
+{
+  std::vector<bpfUInt8> vBuffer;
+  {
+    std::lock_guard<std::mutex> vLock(mMutex);
+    auto vBest = mBuffers.end();
+    for (auto vIt = mBuffers.begin(); vIt != mBuffers.end(); ++vIt) {
+      if (vIt->capacity() >= aSize && (vBest == mBuffers.end() || vIt->capacity() < vBest->capacity())) {
+        vBest = vIt;
+      }
+    }
+    if (vBest != mBuffers.end()) {
+      mSizeBytes -= vBest->capacity();
+      vBuffer.swap(*vBest);
+      std::swap(*vBest, mBuffers.back());
+      mBuffers.pop_back();
+    }
+  }
+  vBuffer.resize(aSize);
+  return vBuffer;
+}
+
+
+void bpBufferPool::Put(std::vector<bpfUInt8>&& aBuffer)
+{
+  std::vector<bpfUInt8> vBuffer;
+  vBuffer.swap(aBuffer);
+  bpfSize vCapacity = vBuffer.capacity();
+  if (vCapacity == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> vLock(mMutex);
+  if (mBuffers.size() < mMaxBuffers && mSizeBytes + vCapacity <= mMaxSizeBytes) {
+    mSizeBytes += vCapacity;
+    mBuffers.push_back(std::move(vBuffer));
+  }
+}
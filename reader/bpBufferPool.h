@@ -0,0 +1,64 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BP_BUFFER_POOL__
+#define __BP_BUFFER_POOL__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+
+#include <mutex>
+#include <vector>
+
+
+/**
+ * Keeps byte buffers that the reader allocates and releases itself, such as raw chunks,
+ * so that a read does not allocate a fresh buffer for every chunk.
+ *
+ * At most aMaxBuffers buffers with a total capacity of aMaxSizeBytes are kept.
+ * All methods may be called concurrently.
+ */
+class bpBufferPool
+{
+public:
+  bpBufferPool(bpfSize aMaxBuffers, bpfSize aMaxSizeBytes);
+
+  bpBufferPool(const bpBufferPool&) = delete;
+  bpBufferPool& operator=(const bpBufferPool&) = delete;
+
+  /**
+   * Returns a buffer of aSize bytes, the smallest kept buffer that fits or a new one.
+   */
+  std::vector<bpfUInt8> Get(bpfSize aSize);
+
+  /**
+   * Takes aBuffer back, it is released if the pool is full.
+   */
+  void Put(std::vector<bpfUInt8>&& aBuffer);
+
+private:
+  const bpfSize mMaxBuffers;
+  const bpfSize mMaxSizeBytes;
+
+  std::mutex mMutex;
+  std::vector<std::vector<bpfUInt8>> mBuffers;
+  bpfSize mSizeBytes;
+};
+
+
+#endif // __BP_BUFFER_POOL__
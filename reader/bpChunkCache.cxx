@@ -0,0 +1,107 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/reader/bpChunkCache.h"
+
+
+bpChunkCache::bpChunkCache(bpfSize aMaxSizeBytes, bpReaderTypes::tChunkCacheEvictionPolicy aEvictionPolicy)
+  : mMaxSizeBytes(aMaxSizeBytes),
+    mEvictionPolicy(aEvictionPolicy),
+    mSizeBytes(0),
+    mHits(0),
+    mMisses(0),
+    mEvictions(0)
+{
+}
+
+
+bool bpChunkCache::IsEnabled() const
+{
+  return mMaxSizeBytes > 0;
+}
+
+
+bpChunkCache::tChunk bpChunkCache::Get(const cKey& aKey)
+{
+  std::lock_guard<std::mutex> vLock(mMutex);
+  auto vIndexIt = mIndex.find(aKey);
+  if (vIndexIt == mIndex.end()) {
+    ++mMisses;
+    return nullptr;
+  }
+
+  ++mHits;
+  if (mEvictionPolicy == bpReaderTypes::eChunkCacheEvictLeastRecentlyUsed) {
+    mEntries.splice(mEntries.begin(), mEntries, vIndexIt->second);
+  }
+  return vIndexIt->second->second;
+}
+
+
+void bpChunkCache::Insert(const cKey& aKey, tChunk aChunk)
+{
+  bpfSize vSize = aChunk->size();
+  if (vSize > mMaxSizeBytes) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> vLock(mMutex);
+  auto vIndexIt = mIndex.find(aKey);
+  if (vIndexIt != mIndex.end()) {
+    // decoded concurrently by another read
+    return;
+  }
+
+  while (mSizeBytes + vSize > mMaxSizeBytes) {
+    Erase(std::prev(mEntries.end()));
+    ++mEvictions;
+  }
+
+  mEntries.emplace_front(aKey, std::move(aChunk));
+  mIndex[aKey] = mEntries.begin();
+  mSizeBytes += vSize;
+}
+
+
+void bpChunkCache::Clear()
+{
+  std::lock_guard<std::mutex> vLock(mMutex);
+  mEntries.clear();
+  mIndex.clear();
+  mSizeBytes = 0;
+}
+
+
+bpReaderTypes::cChunkCacheStatistics bpChunkCache::GetStatistics() const
+{
+  std::lock_guard<std::mutex> vLock(mMutex);
+  bpReaderTypes::cChunkCacheStatistics vStatistics;
+  vStatistics.mHits = mHits;
+  vStatistics.mMisses = mMisses;
+  vStatistics.mEvictions = mEvictions;
+  vStatistics.mNumberOfChunks = mEntries.size();
+  vStatistics.mSizeBytes = mSizeBytes;
+  return vStatistics;
+}
+
+
+void bpChunkCache::Erase(tEntries::iterator aEntry)
+{
+  mSizeBytes -= aEntry->second->size();
+  mIndex.erase(aEntry->first);
+  mEntries.erase(aEntry);
+}
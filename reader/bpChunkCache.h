@@ -0,0 +1,104 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#ifndef __BP_CHUNK_CACHE__
+#define __BP_CHUNK_CACHE__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+#include "ImarisReader/interface/bpReaderTypes.h"
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+
+/**
+ * Keeps decoded chunks between ReadData calls, so that overlapping reads
+ * do not decompress the same chunks again.
+ *
+ * The total size of the cached chunks is kept below the configured number of
+ * bytes, chunks are dropped in least recently used or insertion order.
+ * All methods may be called concurrently.
+ */
+class bpChunkCache
+{
+public:
+  struct cKey
+  {
+    bpfSize mImageIndex;
+    bpfSize mResolutionIndex;
+    bpfSize mTimePointIndex;
+    bpfSize mChannelIndex;
+    // chunk coordinate, hdf5 order [z, y, x]
+    bpfUInt64 mChunkIndex[3];
+
+    bool operator<(const cKey& aOther) const
+    {
+      return std::tie(mImageIndex, mResolutionIndex, mTimePointIndex, mChannelIndex, mChunkIndex[0], mChunkIndex[1], mChunkIndex[2]) <
+        std::tie(aOther.mImageIndex, aOther.mResolutionIndex, aOther.mTimePointIndex, aOther.mChannelIndex, aOther.mChunkIndex[0], aOther.mChunkIndex[1], aOther.mChunkIndex[2]);
+    }
+  };
+
+  using tChunk = bpfSharedPtr<const std::vector<bpfUInt8>>;
+
+  bpChunkCache(bpfSize aMaxSizeBytes, bpReaderTypes::tChunkCacheEvictionPolicy aEvictionPolicy);
+
+  bpChunkCache(const bpChunkCache&) = delete;
+  bpChunkCache& operator=(const bpChunkCache&) = delete;
+
+  bool IsEnabled() const;
+
+  /**
+   * Returns the cached chunk for aKey or nullptr, and counts the hit or miss.
+   */
+  tChunk Get(const cKey& aKey);
+
+  /**
+   * Adds aChunk, dropping other chunks until it fits. Chunks larger than the budget are not cached.
+   */
+  void Insert(const cKey& aKey, tChunk aChunk);
+
+  void Clear();
+
+  bpReaderTypes::cChunkCacheStatistics GetStatistics() const;
+
+private:
+  using tEntry = std::pair<cKey, tChunk>;
+  using tEntries = std::list<tEntry>;
+
+  void Erase(tEntries::iterator aEntry);
+
+  const bpfSize mMaxSizeBytes;
+  const bpReaderTypes::tChunkCacheEvictionPolicy mEvictionPolicy;
+
+  mutable std::mutex mMutex;
+
+  // next to be dropped last
+  tEntries mEntries;
+  std::map<cKey, tEntries::iterator> mIndex;
+  bpfSize mSizeBytes;
+
+  bpfUInt64 mHits;
+  bpfUInt64 mMisses;
+  bpfUInt64 mEvictions;
+};
+
+
+#endif // __BP_CHUNK_CACHE__
@@ -0,0 +1,218 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/reader/bpDataSetHandleCache.h"
+
+
+bpDataSetHandleCache::bpDataSetHandleCache(bpfSize aMaxNumberOfHandles, const cH5ChunkCacheOptions& aH5ChunkCacheOptions)
+  : mMaxNumberOfHandles(std::max<bpfSize>(aMaxNumberOfHandles, 1)),
+    mH5ChunkCacheOptions(aH5ChunkCacheOptions)
+{
+}
+
+
+bpDataSetHandleCache::~bpDataSetHandleCache()
+{
+  Invalidate();
+  for (auto& vAccessPropertyList : mAccessPropertyLists) {
+    if (vAccessPropertyList.second != H5P_DEFAULT) {
+      H5Pclose(vAccessPropertyList.second);
+    }
+  }
+}
+
+
+bpDataSetHandleCache::cHandle* bpDataSetHandleCache::Get(hid_t aFileId, const bpfString& aDataSetDirectory, const cKey& aKey)
+{
+  auto vIndexIt = mIndex.find(aKey);
+  if (vIndexIt != mIndex.end()) {
+    // move to front
+    mEntries.splice(mEntries.begin(), mEntries, vIndexIt->second);
+    return &vIndexIt->second->second;
+  }
+
+  bpfString vPath = aDataSetDirectory +
+    "/ResolutionLevel " + bpfToString(aKey.mResolutionIndex) +
+    "/TimePoint " + bpfToString(aKey.mTimePointIndex) +
+    "/Channel " + bpfToString(aKey.mChannelIndex) +
+    "/Data";
+
+  hid_t vAccessPropertyList = H5P_DEFAULT;
+  bool vIsNewLevel = false;
+  if (mH5ChunkCacheOptions.mMode != bpReaderTypes::eH5ChunkCacheDefault) {
+    auto vAccessPropertyListIt = mAccessPropertyLists.find(aKey.mResolutionIndex);
+    if (vAccessPropertyListIt != mAccessPropertyLists.end()) {
+      vAccessPropertyList = vAccessPropertyListIt->second;
+    }
+    else {
+      vIsNewLevel = true;
+    }
+  }
+
+  cHandle vHandle;
+  if (!Open(aFileId, vPath, vAccessPropertyList, vHandle)) {
+    return nullptr;
+  }
+
+  if (vIsNewLevel) {
+    // the chunk cache is fixed when the dataset is opened, reopen it once the chunk size is known
+    vAccessPropertyList = CreateAccessPropertyList(vHandle);
+    mAccessPropertyLists[aKey.mResolutionIndex] = vAccessPropertyList;
+    if (vAccessPropertyList != H5P_DEFAULT) {
+      Close(vHandle);
+      if (!Open(aFileId, vPath, vAccessPropertyList, vHandle)) {
+        return nullptr;
+      }
+    }
+  }
+
+  while (mEntries.size() >= mMaxNumberOfHandles) {
+    Close(mEntries.back().second);
+    mIndex.erase(mEntries.back().first);
+    mEntries.pop_back();
+  }
+
+  mEntries.emplace_front(aKey, vHandle);
+  mIndex[aKey] = mEntries.begin();
+  return &mEntries.front().second;
+}
+
+
+bool bpDataSetHandleCache::Refresh(cHandle& aHandle)
+{
+  if (H5Drefresh(aHandle.mDataId) < 0) {
+    return false;
+  }
+
+  hid_t vDataSpaceId = H5Dget_space(aHandle.mDataId);
+  if (vDataSpaceId < 0) {
+    return false;
+  }
+
+  H5Sclose(aHandle.mDataSpaceId);
+  aHandle.mDataSpaceId = vDataSpaceId;
+  H5Sget_simple_extent_dims(aHandle.mDataSpaceId, aHandle.mFileDim, nullptr);
+  return true;
+}
+
+
+void bpDataSetHandleCache::Invalidate()
+{
+  for (auto& vEntry : mEntries) {
+    Close(vEntry.second);
+  }
+  mEntries.clear();
+  mIndex.clear();
+}
+
+
+bool bpDataSetHandleCache::Open(hid_t aFileId, const bpfString& aPath, hid_t aAccessPropertyList, cHandle& aHandle)
+{
+  aHandle.mDataId = H5Dopen(aFileId, aPath.c_str(), aAccessPropertyList);
+  if (aHandle.mDataId < 0) {
+    BP_DEBUG_MSG("bpDataSetHandleCache::Open() - Could not open dataset " + aPath);
+    return false;
+  }
+
+  aHandle.mDataSpaceId = H5Dget_space(aHandle.mDataId);
+  if (aHandle.mDataSpaceId < 0 || H5Sget_simple_extent_ndims(aHandle.mDataSpaceId) != 3) {
+    BP_DEBUG_MSG("bpDataSetHandleCache::Open() - Invalid dataspace of dataset " + aPath);
+    if (aHandle.mDataSpaceId >= 0) {
+      H5Sclose(aHandle.mDataSpaceId);
+    }
+    H5Dclose(aHandle.mDataId);
+    return false;
+  }
+
+  H5Sget_simple_extent_dims(aHandle.mDataSpaceId, aHandle.mFileDim, nullptr);
+
+  aHandle.mChunkDim[0] = aHandle.mChunkDim[1] = aHandle.mChunkDim[2] = 0;
+  hid_t vPlist = H5Dget_create_plist(aHandle.mDataId);
+  if (vPlist >= 0) {
+    if (H5Pget_layout(vPlist) == H5D_CHUNKED) {
+      H5Pget_chunk(vPlist, 3, aHandle.mChunkDim);
+    }
+    H5Pclose(vPlist);
+  }
+  return true;
+}
+
+
+void bpDataSetHandleCache::Close(cHandle& aHandle)
+{
+  H5Sclose(aHandle.mDataSpaceId);
+  H5Dclose(aHandle.mDataId);
+  aHandle.mDecoder.reset();
+  aHandle.mMappedChunks.clear();
+}
+
+
+hid_t bpDataSetHandleCache::CreateAccessPropertyList(const cHandle& aHandle) const
+{
+  if (aHandle.mChunkDim[0] == 0 || aHandle.mChunkDim[1] == 0 || aHandle.mChunkDim[2] == 0) {
+    // not chunked, hdf5 does not cache it
+    return H5P_DEFAULT;
+  }
+
+  bpfSize vTypeSize = 1;
+  hid_t vTypeId = H5Dget_type(aHandle.mDataId);
+  if (vTypeId >= 0) {
+    vTypeSize = std::max<bpfSize>(H5Tget_size(vTypeId), 1);
+    H5Tclose(vTypeId);
+  }
+  bpfSize vChunkSizeBytes = aHandle.mChunkDim[0] * aHandle.mChunkDim[1] * aHandle.mChunkDim[2] * vTypeSize;
+
+  bpfSize vSizeBytes = mH5ChunkCacheOptions.mSizeBytes;
+  if (mH5ChunkCacheOptions.mMode == bpReaderTypes::eH5ChunkCacheAuto) {
+    // chunks along z, y and x
+    bpfSize vNumberOfChunks[3];
+    for (bpfSize vIndex = 0; vIndex < 3; ++vIndex) {
+      vNumberOfChunks[vIndex] = (aHandle.mFileDim[vIndex] + aHandle.mChunkDim[vIndex] - 1) / aHandle.mChunkDim[vIndex];
+    }
+    bpfSize vSlabChunks = std::max({ vNumberOfChunks[2] * vNumberOfChunks[1], vNumberOfChunks[2] * vNumberOfChunks[0], vNumberOfChunks[1] * vNumberOfChunks[0] });
+    vSizeBytes = std::max(std::min(vSlabChunks * vChunkSizeBytes, vSizeBytes), vChunkSizeBytes);
+  }
+
+  bpfSize vSlots = mH5ChunkCacheOptions.mSlots;
+  if (vSlots == 0) {
+    vSlots = NextPrime(100 * std::max<bpfSize>(vSizeBytes / vChunkSizeBytes, 1));
+  }
+
+  hid_t vAccessPropertyList = H5Pcreate(H5P_DATASET_ACCESS);
+  if (vAccessPropertyList < 0) {
+    return H5P_DEFAULT;
+  }
+  if (H5Pset_chunk_cache(vAccessPropertyList, vSlots, vSizeBytes, mH5ChunkCacheOptions.mPreemption) < 0) {
+    H5Pclose(vAccessPropertyList);
+    return H5P_DEFAULT;
+  }
+  return vAccessPropertyList;
+}
+
+
+bpfSize bpDataSetHandleCache::NextPrime(bpfSize aValue)
+{
+  for (bpfSize vValue = std::max<bpfSize>(aValue, 2); ; ++vValue) {
+    bool vIsPrime = true;
+    for (bpfSize vDivisor = 2; vDivisor * vDivisor <= vValue && vIsPrime; ++vDivisor) {
+      vIsPrime = vValue % vDivisor != 0;
+    }
+    if (vIsPrime) {
+      return vValue;
+    }
+  }
+}
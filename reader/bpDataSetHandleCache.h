@@ -0,0 +1,129 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#ifndef __BP_DATASET_HANDLE_CACHE__
+#define __BP_DATASET_HANDLE_CACHE__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+#include "ImarisReader/interface/bpReaderTypes.h"
+
+#include "hdf5.h"
+
+#include <list>
+#include <map>
+#include <tuple>
+
+
+class bpfH5ChunkDecoder;
+
+
+/**
+ * Keeps the "Data" datasets of recently read (resolution, time point, channel)
+ * blocks open, together with their file dataspace and extent, so that
+ * repeated reads do not need to traverse the group hierarchy again.
+ *
+ * The least recently used handle is closed once more than the configured
+ * number of handles is open. Datasets are opened with hdf5's chunk cache
+ * sized by cH5ChunkCacheOptions.
+ */
+class bpDataSetHandleCache
+{
+public:
+  struct cKey
+  {
+    bpfSize mResolutionIndex;
+    bpfSize mTimePointIndex;
+    bpfSize mChannelIndex;
+
+    bool operator<(const cKey& aOther) const
+    {
+      return std::tie(mResolutionIndex, mTimePointIndex, mChannelIndex) <
+        std::tie(aOther.mResolutionIndex, aOther.mTimePointIndex, aOther.mChannelIndex);
+    }
+  };
+
+  struct cHandle
+  {
+    hid_t mDataId;
+    hid_t mDataSpaceId;
+    // hdf5 order, [sizeZ, sizeY, sizeX]
+    hsize_t mFileDim[3];
+    // all zero if the dataset is not chunked
+    hsize_t mChunkDim[3];
+    // created on first use by the reader
+    bpfSharedPtr<const bpfH5ChunkDecoder> mDecoder;
+    // chunks inside the memory mapped file by chunk index [z, y, x], nullptr if not mapped, resolved on first use
+    std::map<std::tuple<hsize_t, hsize_t, hsize_t>, const bpfUInt8*> mMappedChunks;
+  };
+
+  struct cH5ChunkCacheOptions
+  {
+    bpReaderTypes::tH5ChunkCacheMode mMode = bpReaderTypes::eH5ChunkCacheDefault;
+    bpfSize mSizeBytes = 0;
+    bpfSize mSlots = 0;
+    bpfFloat mPreemption = 0.75f;
+  };
+
+  bpDataSetHandleCache(bpfSize aMaxNumberOfHandles, const cH5ChunkCacheOptions& aH5ChunkCacheOptions);
+  ~bpDataSetHandleCache();
+
+  bpDataSetHandleCache(const bpDataSetHandleCache&) = delete;
+  bpDataSetHandleCache& operator=(const bpDataSetHandleCache&) = delete;
+
+  /**
+   * Returns the open handle for aKey, opening "aDataSetDirectory/ResolutionLevel r/TimePoint t/Channel c/Data"
+   * below aFileId if it is not cached yet. Returns nullptr if the dataset cannot be opened.
+   * The returned pointer stays valid until the next call to Get, Refresh or Invalidate.
+   */
+  cHandle* Get(hid_t aFileId, const bpfString& aDataSetDirectory, const cKey& aKey);
+
+  /**
+   * Refreshes the dataset of aHandle (SWMR) and replaces its cached dataspace and extent,
+   * which may have grown since it was opened.
+   */
+  bool Refresh(cHandle& aHandle);
+
+  /**
+   * Closes all cached handles. Must be called before the file is closed.
+   */
+  void Invalidate();
+
+private:
+  using tEntry = std::pair<cKey, cHandle>;
+  using tEntries = std::list<tEntry>;
+
+  static bool Open(hid_t aFileId, const bpfString& aPath, hid_t aAccessPropertyList, cHandle& aHandle);
+  static void Close(cHandle& aHandle);
+
+  // the dataset access property list with the chunk cache for aHandle's resolution level, all datasets of one level share their layout
+  hid_t CreateAccessPropertyList(const cHandle& aHandle) const;
+  static bpfSize NextPrime(bpfSize aValue);
+
+  bpfSize mMaxNumberOfHandles;
+  cH5ChunkCacheOptions mH5ChunkCacheOptions;
+
+  // by resolution index, created when the first dataset of the level is opened
+  std::map<bpfSize, hid_t> mAccessPropertyLists;
+
+  // most recently used first
+  tEntries mEntries;
+  std::map<cKey, tEntries::iterator> mIndex;
+};
+
+
+#endif // __BP_DATASET_HANDLE_CACHE__
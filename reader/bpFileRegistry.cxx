@@ -0,0 +1,257 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#include "ImarisReader/reader/bpFileRegistry.h"
+
+#include "ImarisReader/utils/bpfFileTools.h"
+#include "ImarisReader/utils/bpfH5Attribute.h"
+#include "ImarisReader/utils/bpfH5StorageDriver.h"
+
+
+bpFileRegistry::cFile::cFile(hid_t aFileId, bpfSize aNumberOfDataSets)
+  : mFileId(aFileId),
+    mNumberOfDataSets(aNumberOfDataSets)
+{
+}
+
+
+bpFileRegistry::cFile::~cFile()
+{
+  H5Fclose(mFileId);
+}
+
+
+hid_t bpFileRegistry::cFile::GetId() const
+{
+  return mFileId;
+}
+
+
+bpfSize bpFileRegistry::cFile::GetNumberOfDataSets() const
+{
+  return mNumberOfDataSets;
+}
+
+
+bpFileRegistry::bpFileRegistry()
+{
+}
+
+
+bpFileRegistry& bpFileRegistry::GetInstance()
+{
+  // never destroyed, files still open at exit are closed by hdf5
+  static bpFileRegistry* vInstance = new bpFileRegistry();
+  return *vInstance;
+}
+
+
+bpFileRegistry::tFile bpFileRegistry::Open(const bpfString& aFileName, const bpReaderTypes::cReadOptions& aOptions)
+{
+  bool vIsImage = aOptions.mFileDriver == bpReaderTypes::eFileDriverImage;
+  bool vIsStorage = aOptions.mFileDriver == bpReaderTypes::eFileDriverStorage;
+  const bpfString vFileName = vIsImage || vIsStorage ? aFileName : bpfFileTools::AddExtendedPathPrefix(aFileName);
+  const void* vSource = vIsImage ? aOptions.mFileImage : vIsStorage ? aOptions.mStorage.get() : nullptr;
+  // an open file holds its storage, so the address cannot be reused by another storage while it is registered
+  const tKey vKey(vFileName, aOptions.mSWMR, aOptions.mFileDriver, vIsStorage ? aOptions.mStorage.get() : nullptr);
+
+  if (vIsImage || vIsStorage) {
+    if (!vSource || (vIsImage && aOptions.mFileImageSizeBytes == 0)) {
+      BP_DEBUG_MSG("bpFileRegistry::Open() - No file image or storage given for: " + aFileName);
+      return nullptr;
+    }
+  }
+  else if (!bpfFileTools::FileExists(aFileName)) {
+    BP_DEBUG_MSG("bpFileRegistry::Open() - File does not exist: " + aFileName);
+    return nullptr;
+  }
+
+  // files read with SWMR change while they are open
+  tIdentity vIdentity(0, 0);
+  if (!vIsImage && !vIsStorage && !aOptions.mSWMR) {
+    try {
+      vIdentity = tIdentity(bpfFileTools::GetFileSize(aFileName), bpfFileTools::GetFileModificationTime(aFileName));
+    }
+    catch (...) {
+      BP_DEBUG_MSG("bpFileRegistry::Open() - Could not read the file status: " + aFileName);
+      return nullptr;
+    }
+  }
+
+  // hdf5 copies file images, a new image at the address of a freed one would find the old copy
+  if (vIsImage) {
+    return OpenUnregistered(vFileName, aOptions);
+  }
+
+  std::lock_guard<std::mutex> vLock(mMutex);
+
+  // a replaced file is opened again, its current users keep the old handle
+  auto vFileIt = mFiles.find(vKey);
+  if (vFileIt != mFiles.end()) {
+    tFile vFile = vFileIt->second.mFile.lock();
+    if (vFile && vFileIt->second.mIdentity == vIdentity) {
+      return vFile;
+    }
+    mFiles.erase(vFileIt);
+  }
+
+  // test if file is a hdf5 format file
+  if (!vIsStorage && H5Fis_hdf5(vFileName.c_str()) <= 0) {
+    BP_DEBUG_MSG("bpFileRegistry::Open() - Not a HDF5 file format!");
+    return nullptr;
+  }
+
+  tFile vFile = OpenUnregistered(vFileName, aOptions);
+  if (!vFile) {
+    return nullptr;
+  }
+
+  // entries of files that nobody holds anymore are dropped, so that the registry does not grow with every file ever opened
+  for (auto vEntryIt = mFiles.begin(); vEntryIt != mFiles.end();) {
+    vEntryIt = vEntryIt->second.mFile.expired() ? mFiles.erase(vEntryIt) : std::next(vEntryIt);
+  }
+  mFiles[vKey] = { vFile, vIdentity };
+  return vFile;
+}
+
+
+bpFileRegistry::tFile bpFileRegistry::OpenUnregistered(const bpfString& aFileName, const bpReaderTypes::cReadOptions& aOptions)
+{
+  hid_t vFileId = OpenFile(aFileName, aOptions);
+  if (vFileId < 0) {
+    BP_DEBUG_MSG("bpFileRegistry::Open() - Could not open the file!");
+    return nullptr;
+  }
+
+  bpfSize vNumberOfDataSets = 1;
+  if (!IsFormat(vFileId, vNumberOfDataSets)) {
+    H5Fclose(vFileId);
+    return nullptr;
+  }
+
+  return bpfMakeSharedPtr<const cFile>(vFileId, vNumberOfDataSets);
+}
+
+
+hid_t bpFileRegistry::OpenFile(const bpfString& aFileName, const bpReaderTypes::cReadOptions& aOptions)
+{
+  unsigned vFlags = aOptions.mSWMR ? H5F_ACC_RDONLY | H5F_ACC_SWMR_READ : H5F_ACC_RDONLY;
+  hid_t vFileId = H5I_INVALID_HID;
+
+  if (aOptions.mPageBufferSizeBytes > 0) {
+    // hdf5 refuses page buffering for files written without paged aggregation, those are opened without it below
+    hid_t vAccessPropertyList = CreateAccessPropertyList(aOptions, true);
+    if (vAccessPropertyList >= 0) {
+      H5E_BEGIN_TRY {
+        vFileId = H5Fopen(aFileName.c_str(), vFlags, vAccessPropertyList);
+      } H5E_END_TRY;
+      H5Pclose(vAccessPropertyList);
+    }
+  }
+
+  if (vFileId < 0) {
+    hid_t vAccessPropertyList = CreateAccessPropertyList(aOptions, false);
+    if (vAccessPropertyList < 0) {
+      return H5I_INVALID_HID;
+    }
+    vFileId = H5Fopen(aFileName.c_str(), vFlags, vAccessPropertyList);
+    H5Pclose(vAccessPropertyList);
+  }
+  return vFileId;
+}
+
+
+hid_t bpFileRegistry::CreateAccessPropertyList(const bpReaderTypes::cReadOptions& aOptions, bool aPageBuffer)
+{
+  hid_t vAccessPropertyList = H5Pcreate(H5P_FILE_ACCESS);
+  if (vAccessPropertyList < 0) {
+    return H5I_INVALID_HID;
+  }
+
+  // the core driver grows its buffer by this increment, unused for read only files
+  const size_t vIncrement = 1 << 20;
+  bool vIsValid = true;
+  if (aOptions.mFileDriver == bpReaderTypes::eFileDriverCore) {
+    vIsValid = H5Pset_fapl_core(vAccessPropertyList, vIncrement, false) >= 0;
+  }
+  else if (aOptions.mFileDriver == bpReaderTypes::eFileDriverImage) {
+    vIsValid = H5Pset_fapl_core(vAccessPropertyList, vIncrement, false) >= 0 &&
+      H5Pset_file_image(vAccessPropertyList, const_cast<void*>(aOptions.mFileImage), aOptions.mFileImageSizeBytes) >= 0;
+  }
+  else if (aOptions.mFileDriver == bpReaderTypes::eFileDriverStorage) {
+    vIsValid = H5Pset_fapl_storage(vAccessPropertyList, aOptions.mStorage, aOptions.mStorageReadAheadBytes) >= 0;
+  }
+  if (vIsValid && aPageBuffer) {
+    vIsValid = H5Pset_page_buffer_size(vAccessPropertyList, aOptions.mPageBufferSizeBytes, 0, 0) >= 0;
+  }
+
+  if (!vIsValid) {
+    H5Pclose(vAccessPropertyList);
+    return H5I_INVALID_HID;
+  }
+  return vAccessPropertyList;
+}
+
+
+bool bpFileRegistry::IsFormat(hid_t aFileId, bpfSize& aNumberOfDataSets)
+{
+  // open the root group
+  hid_t vRootId = H5Gopen(aFileId, "/", H5P_DEFAULT);
+
+  if (vRootId < 0) {
+    // could not open the group
+    BP_DEBUG_MSG("IsFormat() - Could not open root group in file!");
+    return false;
+  }
+
+  // look for some attributes
+  if (H5Aget_num_attrs(vRootId) <= 0) {
+    // operation failed
+    H5Gclose(vRootId);
+    BP_DEBUG_MSG("IsFormat() - Could not find any attributes in root group!");
+    return false;
+  }
+
+  // look for file format version
+  bpfString vAttributeValue = "";
+
+  if (!bpfH5ReadAttributeString("ImarisVersion", vAttributeValue, vRootId) || vAttributeValue != "5.5.0") {
+    // wrong file format
+    H5Gclose(vRootId);
+    BP_DEBUG_MSG("IsFormat() - Could not read attributes in root group!");
+    return false;
+  }
+
+  if (H5Aexists(vRootId, "NumberOfDataSets") > 0) {
+    hid_t vAttr = H5Aopen_name(vRootId, "NumberOfDataSets");
+    bpfUInt32 vNumberOfDataSets = 1;
+    H5Aread(vAttr, H5T_NATIVE_UINT32, &vNumberOfDataSets);
+    aNumberOfDataSets = vNumberOfDataSets;
+    H5Aclose(vAttr);
+  }
+
+  if (!bpfH5ReadAttributeString("ImarisDataSet", vAttributeValue, vRootId) || vAttributeValue != "ImarisDataSet") {
+    // it is an encoded file or there is some other problem
+    H5Gclose(vRootId);
+    BP_DEBUG_MSG("IsFormat() - Invalid attribute content!");
+    return false;
+  }
+
+  H5Gclose(vRootId);
+  return true;
+}
@@ -0,0 +1,102 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BP_FILE_REGISTRY__
+#define __BP_FILE_REGISTRY__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+#include "ImarisReader/interface/bpReaderTypes.h"
+
+#include "hdf5.h"
+
+#include <map>
+#include <mutex>
+#include <tuple>
+
+
+/**
+ * Process-wide registry of open Imaris files. GetFileImagesInformation and all
+ * readers of one file, for any image index and data type, share one H5Fopen and
+ * with it the hdf5 metadata cache; the root attributes are checked once when the
+ * file is opened. A file is closed when its last handle is released, its entry is dropped with the next open.
+ *
+ * Files opened for SWMR reading, with another driver or from another storage are
+ * registered separately, files opened from a file image are never shared. A file on disk that was modified or replaced
+ * since it was opened is opened again, except with SWMR. The page buffer size of the first open applies to
+ * all users of a file. All methods may be called concurrently, the hdf5 calls on
+ * a shared file are not serialized by the registry.
+ */
+class bpFileRegistry
+{
+public:
+  class cFile
+  {
+  public:
+    cFile(hid_t aFileId, bpfSize aNumberOfDataSets);
+    ~cFile();
+
+    cFile(const cFile&) = delete;
+    cFile& operator=(const cFile&) = delete;
+
+    hid_t GetId() const;
+
+    // the NumberOfDataSets root attribute, 1 if the file has none
+    bpfSize GetNumberOfDataSets() const;
+
+  private:
+    hid_t mFileId;
+    bpfSize mNumberOfDataSets;
+  };
+
+  using tFile = bpfSharedPtr<const cFile>;
+
+  static bpFileRegistry& GetInstance();
+
+  /**
+   * Returns the open file aFileName, opening it with mSWMR, mFileDriver, mFileImage,
+   * mStorage and mPageBufferSizeBytes of aOptions if nobody holds it yet.
+   * Returns nullptr if it cannot be opened or is not an Imaris 5.5 file.
+   */
+  tFile Open(const bpfString& aFileName, const bpReaderTypes::cReadOptions& aOptions);
+
+private:
+  bpFileRegistry();
+
+  static tFile OpenUnregistered(const bpfString& aFileName, const bpReaderTypes::cReadOptions& aOptions);
+  static hid_t OpenFile(const bpfString& aFileName, const bpReaderTypes::cReadOptions& aOptions);
+  static hid_t CreateAccessPropertyList(const bpReaderTypes::cReadOptions& aOptions, bool aPageBuffer);
+  static bool IsFormat(hid_t aFileId, bpfSize& aNumberOfDataSets);
+
+  using tKey = std::tuple<bpfString, bool, bpReaderTypes::tFileDriver, const bpStorageInterface*>;
+
+  // size and modification time of a file on disk when it was opened, zero for SWMR and storages
+  using tIdentity = std::tuple<bpfUInt64, bpfInt64>;
+
+  struct cEntry
+  {
+    bpfWeakPtr<const cFile> mFile;
+    tIdentity mIdentity;
+  };
+
+  std::mutex mMutex;
+  std::map<tKey, cEntry> mFiles;
+};
+
+
+#endif // __BP_FILE_REGISTRY__
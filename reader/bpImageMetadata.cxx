@@ -0,0 +1,73 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#include "ImarisReader/reader/bpImageMetadata.h"
+
+
+bpImageMetadata::bpImageMetadata()
+  : mState(bpfMakeSharedPtr<cState>())
+{
+}
+
+
+bpImageMetadata::bpImageMetadata(std::vector<bpConverterTypes::tSize5D> aImageSizePerResolution, cLoaders aLoaders)
+  : mState(bpfMakeSharedPtr<cState>())
+{
+  mState->mImageSizePerResolution = std::move(aImageSizePerResolution);
+  mState->mFileBlockSizePerResolution.SetLoader(std::move(aLoaders.mFileBlockSizeLoader));
+  mState->mImageExtent.SetLoader(std::move(aLoaders.mImageExtentLoader));
+  mState->mTimeInfoPerTimePoint.SetLoader(std::move(aLoaders.mTimeInfoLoader));
+  mState->mColorInfoPerChannel.SetLoader(std::move(aLoaders.mColorInfoLoader));
+  mState->mCompressionAlgorithmType.SetLoader(std::move(aLoaders.mCompressionAlgorithmLoader));
+}
+
+
+const std::vector<bpConverterTypes::tSize5D>& bpImageMetadata::GetImageSizePerResolution() const
+{
+  return mState->mImageSizePerResolution;
+}
+
+
+const std::vector<bpConverterTypes::tSize5D>& bpImageMetadata::GetFileBlockSizePerResolution() const
+{
+  return mState->mFileBlockSizePerResolution.Get();
+}
+
+
+const bpConverterTypes::cImageExtent& bpImageMetadata::GetImageExtent() const
+{
+  return mState->mImageExtent.Get();
+}
+
+
+const bpConverterTypes::tTimeInfoVector& bpImageMetadata::GetTimeInfoPerTimePoint() const
+{
+  return mState->mTimeInfoPerTimePoint.Get();
+}
+
+
+const bpConverterTypes::tColorInfoVector& bpImageMetadata::GetColorInfoPerChannel() const
+{
+  return mState->mColorInfoPerChannel.Get();
+}
+
+
+bpConverterTypes::tCompressionAlgorithmType bpImageMetadata::GetCompressionAlgorithmType() const
+{
+  return mState->mCompressionAlgorithmType.Get();
+}
@@ -0,0 +1,109 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BP_IMAGE_METADATA__
+#define __BP_IMAGE_METADATA__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+#include "ImarisReader/interface/bpReaderTypes.h"
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+
+/**
+ * Immutable metadata of one image, built once when the file is opened. Copies share
+ * their state and are cheap. The image sizes are known at open, every other field is
+ * read by its loader on first access, so that a query touches only the hdf5 objects
+ * of the fields it asks for.
+ */
+class bpImageMetadata
+{
+public:
+  struct cLoaders
+  {
+    std::function<std::vector<bpConverterTypes::tSize5D>()> mFileBlockSizeLoader;
+    std::function<bpConverterTypes::cImageExtent()> mImageExtentLoader;
+    std::function<bpConverterTypes::tTimeInfoVector()> mTimeInfoLoader;
+    std::function<bpConverterTypes::tColorInfoVector()> mColorInfoLoader;
+    std::function<bpConverterTypes::tCompressionAlgorithmType()> mCompressionAlgorithmLoader;
+  };
+
+  // empty metadata, e.g. of a file that could not be opened
+  bpImageMetadata();
+
+  bpImageMetadata(std::vector<bpConverterTypes::tSize5D> aImageSizePerResolution, cLoaders aLoaders);
+
+  const std::vector<bpConverterTypes::tSize5D>& GetImageSizePerResolution() const;
+
+  // the loaders run once, on the first call of any copy
+  const std::vector<bpConverterTypes::tSize5D>& GetFileBlockSizePerResolution() const;
+  const bpConverterTypes::cImageExtent& GetImageExtent() const;
+  const bpConverterTypes::tTimeInfoVector& GetTimeInfoPerTimePoint() const;
+  const bpConverterTypes::tColorInfoVector& GetColorInfoPerChannel() const;
+  bpConverterTypes::tCompressionAlgorithmType GetCompressionAlgorithmType() const;
+
+private:
+  template<typename TValue>
+  class cLazy
+  {
+  public:
+    cLazy()
+      : mValue()
+    {
+    }
+
+    void SetLoader(std::function<TValue()> aLoader)
+    {
+      mLoader = std::move(aLoader);
+    }
+
+    const TValue& Get()
+    {
+      std::call_once(mOnce, [this] {
+        if (mLoader) {
+          mValue = mLoader();
+          mLoader = nullptr;
+        }
+      });
+      return mValue;
+    }
+
+  private:
+    std::function<TValue()> mLoader;
+    std::once_flag mOnce;
+    TValue mValue;
+  };
+
+  struct cState
+  {
+    std::vector<bpConverterTypes::tSize5D> mImageSizePerResolution;
+    cLazy<std::vector<bpConverterTypes::tSize5D>> mFileBlockSizePerResolution;
+    cLazy<bpConverterTypes::cImageExtent> mImageExtent;
+    cLazy<bpConverterTypes::tTimeInfoVector> mTimeInfoPerTimePoint;
+    cLazy<bpConverterTypes::tColorInfoVector> mColorInfoPerChannel;
+    cLazy<bpConverterTypes::tCompressionAlgorithmType> mCompressionAlgorithmType;
+  };
+
+  bpfSharedPtr<cState> mState;
+};
+
+
+#endif // __BP_IMAGE_METADATA__
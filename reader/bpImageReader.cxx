@@ -17,13 +17,12 @@
 
 #include "ImarisReader/interface/bpImageReader.h"
 #include "ImarisReader/reader/bpImageReaderImpl.h"
+#include "ImarisReader/reader/bpFileRegistry.h"
 
 #include "ImarisReader/utils/bpfH5LZ4.h"
-#include "ImarisReader/utils/bpfFileTools.h"
 
 #include "hdf5.h"
 
-#include <iostream>
 #include <mutex>
 
 const bpfString mDataSetDirectoryName = "DataSet";
@@ -32,204 +31,23 @@ const bpfString mThumbnailDirectoryName = "Thumbnail";
 
 using namespace bpConverterTypes;
 
-void CloseFile(hid_t& aFileId)
-{
-  if (aFileId > 0) {
-    H5Fclose(aFileId);
-  }
-
-  aFileId = 0;
-}
-
-
-bool ReadAttributeString(const bpfString aAttributeName, bpfString& aAttributeValue, const hid_t& aAttributeLocation)
+std::vector<tDataType> GetFileImagesInformation(const bpString& aInputFile, bool aSWMR)
 {
-  auto vExists = H5Aexists(aAttributeLocation, aAttributeName.c_str());
-
-  if (vExists <= 0) {
-    BP_DEBUG_MSG("ReadAttribute() - Could not find attribute with name: " + aAttributeName);
-    return false;
-  }
-
-  hid_t vAttributeId = H5Aopen_by_name(aAttributeLocation, ".", aAttributeName.c_str(), H5P_DEFAULT, H5P_DEFAULT);
-
-  if (vAttributeId < 0) {
-    BP_DEBUG_MSG("ReadAttribute() - Could not find attribute with name: " + aAttributeName);
-    return false;
-  }
-
-  hid_t vAttributeTypeId = H5Aget_type(vAttributeId);
-
-  if (vAttributeTypeId < 0) {
-    H5Aclose(vAttributeId);
-    BP_DEBUG_MSG("ReadAttribute() - Could not get datatype from attribute" + aAttributeName);
-    return false;
-  }
-
-  hid_t vAttributeSpaceId = H5Aget_space(vAttributeId);
-
-  if (vAttributeSpaceId < 0) {
-    H5Tclose(vAttributeTypeId);
-    H5Aclose(vAttributeId);
-    BP_DEBUG_MSG("ReadAttribute() - Could not get dataspace from attribute" + aAttributeName);
-    return false;
-  }
-
-  bpfInt32 vAttributeRank = H5Sget_simple_extent_ndims(vAttributeSpaceId);
-
-  if (vAttributeRank != 1) {
-    H5Sclose(vAttributeSpaceId);
-    H5Tclose(vAttributeTypeId);
-    H5Aclose(vAttributeId);
-    BP_DEBUG_MSG("ReadAttribute() - Dataspace rank of attribute " + aAttributeName + " is not 1!");
-    return false;
-  }
-
-  hsize_t vAttributeSize = 0;
-
-  if (H5Sget_simple_extent_dims(vAttributeSpaceId, &vAttributeSize, nullptr) < 0) {
-    H5Sclose(vAttributeSpaceId);
-    H5Tclose(vAttributeTypeId);
-    H5Aclose(vAttributeId);
-    BP_DEBUG_MSG("ReadAttribute() - Could not get size of attribute " + aAttributeName);
-    return false;
-  }
-
-  bpfChar* vBuffer = new bpfChar[(bpfSize)vAttributeSize+1];
-  vBuffer[vAttributeSize] = '\0';
-
-  if (H5Aread(vAttributeId, vAttributeTypeId, vBuffer) < 0) {
-    delete[] vBuffer;
-    H5Sclose(vAttributeSpaceId);
-    H5Tclose(vAttributeTypeId);
-    H5Aclose(vAttributeId);
-    BP_DEBUG_MSG("ReadAttribute() - Could not read attribute " + aAttributeName + "!");
-    return false;
-  }
-
-  aAttributeValue = vBuffer;
-
-  delete[] vBuffer;
-  H5Sclose(vAttributeSpaceId);
-  H5Tclose(vAttributeTypeId);
-  H5Aclose(vAttributeId);
-
-  return true;
+  bpReaderTypes::cReadOptions vOptions;
+  vOptions.mSWMR = aSWMR;
+  return GetFileImagesInformation(aInputFile, vOptions);
 }
 
-bool IsFormat(const bpString& aInputFile, hid_t& aFileId, bool aSWMR)
-{
-  if (!bpfFileTools::FileExists(aInputFile)) {
-    std::cout << "File does not exist: " << aInputFile << std::endl;
-    return false;
-  }
-
-  std::cout << "File exists: " << aInputFile << std::endl;
-  // test if file is a hdf5 format file
-  if (H5Fis_hdf5(bpfFileTools::AddExtendedPathPrefix(aInputFile).c_str()) == 0) {
-    BP_DEBUG_MSG("IsFormat() - Not a HDF5 file format!");
-    return false;
-  }
-
-  // open the file
-  const auto& vFileName = bpfFileTools::AddExtendedPathPrefix(aInputFile);
-  if (aSWMR) {
-    aFileId = H5Fopen(vFileName.c_str(), H5F_ACC_RDONLY | H5F_ACC_SWMR_READ, H5P_DEFAULT);
-  }
-  else {
-    aFileId = H5Fopen(vFileName.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
-  }
-
-  if (aFileId < 0) {
-    // could not open the file
-    BP_DEBUG_MSG("IsFormat() - Could not open the file!");
-    return false;
-  }
-
-  // open the root group
-  hid_t vRootId = H5Gopen(aFileId, "/", H5P_DEFAULT);
-
-  if (vRootId < 0) {
-    // could not open the group
-    CloseFile(aFileId);
-    BP_DEBUG_MSG("IsFormat() - Could not open root group in file!");
-    return false;
-  }
-
-  // look for some attributes
-  if (H5Aget_num_attrs(vRootId) <= 0) {
-    // operation failed
-    H5Gclose(vRootId);
-    CloseFile(aFileId);
-    BP_DEBUG_MSG("IsFormat() - Could not find any attributes in root group!");
-    return false;
-  }
-
-  // look for file format version
-  bpfString vAttributeValue = "";
-
-  if (!ReadAttributeString("ImarisVersion", vAttributeValue, vRootId)) {
-    // operation failed
-    H5Gclose(vRootId);
-    CloseFile(aFileId);
-    BP_DEBUG_MSG("IsFormat() - Could not read attributes in root group!");
-    return false;
-  }
-
-  if (vAttributeValue != "5.5.0") {
-    // wrong file format
-    H5Gclose(vRootId);
-    CloseFile(aFileId);
-    BP_DEBUG_MSG("IsFormat() - Could not read attributes in root group!");
-    return false;
-  }
-
-  if (H5Aexists(vRootId, "NumberOfDataSets")) {
-    hid_t vAttr = H5Aopen_name(vRootId, "NumberOfDataSets");
-    bpfUInt32 vNumberOfDataSets = 1;
-    H5Aread(vAttr, H5T_NATIVE_UINT32, &vNumberOfDataSets);
-    H5Aclose(vAttr);
-  }
-
-  if (!ReadAttributeString("ImarisDataSet", vAttributeValue, vRootId)) {
-    // operation failed
-    H5Gclose(vRootId);
-    CloseFile(aFileId);
-    BP_DEBUG_MSG("IsFormat() - Could not read attributes in root group!");
-    return false;
-  }
-
-  if (vAttributeValue != "ImarisDataSet") {
-    // it is an encoded file or there is some other problem
-    H5Gclose(vRootId);
-    CloseFile(aFileId);
-    BP_DEBUG_MSG("IsFormat() - Invalid attribute content!");
-    return false;
-  }
-
-  // close
-  H5Gclose(vRootId);
-
-  return true;
-}
-
-std::vector<tDataType> GetFileImagesInformation(const bpString& aInputFile, bool aSWMR)
+std::vector<tDataType> GetFileImagesInformation(const bpString& aInputFile, const bpReaderTypes::cReadOptions& aOptions)
 {
   std::vector<tDataType> vResult;
-  hid_t vFileId;
-  if (!IsFormat(aInputFile, vFileId, aSWMR)) {
+  bpFileRegistry::tFile vFile = bpFileRegistry::GetInstance().Open(aInputFile, aOptions);
+  if (!vFile) {
     return vResult;
   }
 
-  // read number of datasets
-  hid_t vRootId = H5Gopen(vFileId, "/", H5P_DEFAULT);
-  bpfUInt32 vNumberOfDataSets = 1;
-  if (H5Aexists(vRootId, "NumberOfDataSets")) {
-    hid_t vAttrId = H5Aopen_name(vRootId, "NumberOfDataSets");
-    H5Aread(vAttrId, H5T_NATIVE_UINT32, &vNumberOfDataSets);
-    H5Aclose(vAttrId);
-  }
-
+  hid_t vFileId = vFile->GetId();
+  bpSize vNumberOfDataSets = vFile->GetNumberOfDataSets();
   for (bpSize vD = 0; vD < vNumberOfDataSets; vD++) {
     bpfString vDirectoryName = mDataSetDirectoryName + (vD == 0 ? "" : bpfToString(vD));
     hid_t vDataSetId = H5Gopen(vFileId, vDirectoryName.c_str(), H5P_DEFAULT);
@@ -276,7 +94,7 @@ std::vector<tDataType> GetFileImagesInformation(const bpString& aInputFile, bool
       break;
     }
     default:
-      H5Dclose(vDataTypeId);
+      H5Tclose(vDataTypeId);
       H5Gclose(vDataSetId);
       return vResult;
     }
@@ -289,12 +107,34 @@ std::vector<tDataType> GetFileImagesInformation(const bpString& aInputFile, bool
   return vResult;
 }
 
+bpUniquePtr<bpImageReaderBaseInterface> CreateImageReader(const bpString& aInputFile, bpSize aImageIndex, const bpReaderTypes::cReadOptions& aOptions)
+{
+  std::vector<tDataType> vTypes = GetFileImagesInformation(aInputFile, aOptions);
+  if (aImageIndex >= vTypes.size()) {
+    return nullptr;
+  }
+  switch (vTypes[aImageIndex]) {
+  case bpUInt8Type:
+    return std::make_unique<bpImageReader<bpUInt8>>(aInputFile, aImageIndex, aOptions);
+  case bpUInt16Type:
+    return std::make_unique<bpImageReader<bpUInt16>>(aInputFile, aImageIndex, aOptions);
+  case bpUInt32Type:
+    return std::make_unique<bpImageReader<bpUInt32>>(aInputFile, aImageIndex, aOptions);
+  case bpFloatType:
+    return std::make_unique<bpImageReader<bpFloat>>(aInputFile, aImageIndex, aOptions);
+  default:
+    return nullptr;
+  }
+}
+
 template <typename TDataType>
 class bpImageReader<TDataType>::cThreadSafeDecorator : public bpImageReaderInterface<TDataType>
 {
 public:
-  explicit cThreadSafeDecorator(bpUniquePtr<bpImageReaderInterface<TDataType>> aImpl)
-    : mImpl(std::move(aImpl))
+  cThreadSafeDecorator(bpUniquePtr<bpImageReaderInterface<TDataType>> aImpl, bpSharedPtr<std::mutex> aMutex, bool aConcurrentReadData)
+    : mMutex(std::move(aMutex)),
+      mConcurrentReadData(aConcurrentReadData),
+      mImpl(std::move(aImpl))
   {
   }
 
@@ -306,39 +146,151 @@ public:
     bpConverterTypes::tColorInfoVector& aColorInfoPerChannel,
     bpConverterTypes::tCompressionAlgorithmType& aCompressionAlgorithmType)
   {
-    tLock vLock(mMutex);
+    tLock vLock(*mMutex);
     return mImpl->ReadMetadata(aImageSizePerResolution, aFileBlockSizePerResolution, aImageExtent, aTimeInfoPerTimePoint, aColorInfoPerChannel, aCompressionAlgorithmType);
   }
 
+  void ReadMetadata(
+    bpReaderTypes::tMetadataFields aFields,
+    std::vector<bpConverterTypes::tSize5D>& aImageSizePerResolution,
+    std::vector<bpConverterTypes::tSize5D>& aFileBlockSizePerResolution,
+    bpConverterTypes::cImageExtent& aImageExtent,
+    bpConverterTypes::tTimeInfoVector& aTimeInfoPerTimePoint,
+    bpConverterTypes::tColorInfoVector& aColorInfoPerChannel,
+    bpConverterTypes::tCompressionAlgorithmType& aCompressionAlgorithmType)
+  {
+    tLock vLock(*mMutex);
+    return mImpl->ReadMetadata(aFields, aImageSizePerResolution, aFileBlockSizePerResolution, aImageExtent, aTimeInfoPerTimePoint, aColorInfoPerChannel, aCompressionAlgorithmType);
+  }
+
   void ReadParameters(bpConverterTypes::tParameters& aParameters)
   {
-    tLock vLock(mMutex);
+    tLock vLock(*mMutex);
     return mImpl->ReadParameters(aParameters);
   }
 
   void ReadData(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData)
   {
-    tLock vLock(mMutex);
+    if (mConcurrentReadData) {
+      // the implementation locks mMutex around its hdf5 calls only
+      return mImpl->ReadData(aBegin, aEnd, aResolutionIndex, aData);
+    }
+    tLock vLock(*mMutex);
     return mImpl->ReadData(aBegin, aEnd, aResolutionIndex, aData);
   }
 
+  void ReadData(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData, const bpConverterTypes::tSize5D& aByteStrides, TDataType aFillValue)
+  {
+    if (mConcurrentReadData) {
+      return mImpl->ReadData(aBegin, aEnd, aResolutionIndex, aData, aByteStrides, aFillValue);
+    }
+    tLock vLock(*mMutex);
+    return mImpl->ReadData(aBegin, aEnd, aResolutionIndex, aData, aByteStrides, aFillValue);
+  }
+
+  void ReadDataBatch(const std::vector<typename bpImageReaderInterface<TDataType>::cReadRequest>& aRequests)
+  {
+    if (mConcurrentReadData) {
+      return mImpl->ReadDataBatch(aRequests);
+    }
+    tLock vLock(*mMutex);
+    return mImpl->ReadDataBatch(aRequests);
+  }
+
+  void ReadDataConverted(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpFloat* aData, bpFloat aScale, bpFloat aOffset)
+  {
+    if (mConcurrentReadData) {
+      return mImpl->ReadDataConverted(aBegin, aEnd, aResolutionIndex, aData, aScale, aOffset);
+    }
+    tLock vLock(*mMutex);
+    return mImpl->ReadDataConverted(aBegin, aEnd, aResolutionIndex, aData, aScale, aOffset);
+  }
+
+  void ReadDataConverted(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpReaderTypes::cFloat16* aData, bpFloat aScale, bpFloat aOffset)
+  {
+    if (mConcurrentReadData) {
+      return mImpl->ReadDataConverted(aBegin, aEnd, aResolutionIndex, aData, aScale, aOffset);
+    }
+    tLock vLock(*mMutex);
+    return mImpl->ReadDataConverted(aBegin, aEnd, aResolutionIndex, aData, aScale, aOffset);
+  }
+
+  void ReadDataConverted(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, bpFloat aScale, bpFloat aOffset)
+  {
+    if (mConcurrentReadData) {
+      return mImpl->ReadDataConverted(aBegin, aEnd, aResolutionIndex, aData, aScale, aOffset);
+    }
+    tLock vLock(*mMutex);
+    return mImpl->ReadDataConverted(aBegin, aEnd, aResolutionIndex, aData, aScale, aOffset);
+  }
+
+  void ReadDataDisplay(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, const bpConverterTypes::tColorInfoVector& aColorInfoPerChannel)
+  {
+    if (mConcurrentReadData) {
+      return mImpl->ReadDataDisplay(aBegin, aEnd, aResolutionIndex, aData, aColorInfoPerChannel);
+    }
+    tLock vLock(*mMutex);
+    return mImpl->ReadDataDisplay(aBegin, aEnd, aResolutionIndex, aData, aColorInfoPerChannel);
+  }
+
+  void ReadDataRGBA(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, const bpConverterTypes::tColorInfoVector& aColorInfoPerChannel)
+  {
+    if (mConcurrentReadData) {
+      return mImpl->ReadDataRGBA(aBegin, aEnd, aResolutionIndex, aData, aColorInfoPerChannel);
+    }
+    tLock vLock(*mMutex);
+    return mImpl->ReadDataRGBA(aBegin, aEnd, aResolutionIndex, aData, aColorInfoPerChannel);
+  }
+
+  const TDataType* ReadDataView(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex)
+  {
+    tLock vLock(*mMutex);
+    return mImpl->ReadDataView(aBegin, aEnd, aResolutionIndex);
+  }
+
+  // only queues the read, the executor takes the lock itself
+  std::future<bpReaderTypes::tReadStatus> ReadDataAsync(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData,
+    bpReaderTypes::tReadPriority aPriority, const bpReaderTypes::cCancellationToken& aToken)
+  {
+    return mImpl->ReadDataAsync(aBegin, aEnd, aResolutionIndex, aData, aPriority, aToken);
+  }
+
+  void ReadDataAsync(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData,
+    typename bpImageReaderInterface<TDataType>::tReadCallback aCallback, bpReaderTypes::tReadPriority aPriority, const bpReaderTypes::cCancellationToken& aToken)
+  {
+    mImpl->ReadDataAsync(aBegin, aEnd, aResolutionIndex, aData, std::move(aCallback), aPriority, aToken);
+  }
+
   bpImageReaderBaseInterface::cHistogram ReadHistogram(const bpVec3& aIndexTCR)
   {
-    tLock vLock(mMutex);
+    tLock vLock(*mMutex);
     return mImpl->ReadHistogram(aIndexTCR);
   }
 
   bpImageReaderBaseInterface::cThumbnail ReadThumbnail()
   {
-    tLock vLock(mMutex);
+    tLock vLock(*mMutex);
     return mImpl->ReadThumbnail();
   }
 
+  bpReaderTypes::cChunkCacheStatistics GetChunkCacheStatistics()
+  {
+    tLock vLock(*mMutex);
+    return mImpl->GetChunkCacheStatistics();
+  }
+
+  std::vector<bpReaderTypes::cReadPlanItem> PlanRead(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex)
+  {
+    tLock vLock(*mMutex);
+    return mImpl->PlanRead(aBegin, aEnd, aResolutionIndex);
+  }
+
 private:
   using tMutex = std::mutex;
   using tLock = std::lock_guard<tMutex>;
 
-  mutable tMutex mMutex;
+  bpSharedPtr<tMutex> mMutex;
+  bool mConcurrentReadData;
 
   bpUniquePtr<bpImageReaderInterface<TDataType>> mImpl;
 };
@@ -346,8 +298,9 @@ private:
 template <typename TDataType>
 bpImageReader<TDataType>::bpImageReader(const bpString& aInputFile, bpSize aImageIndex, const bpReaderTypes::cReadOptions& aOptions)
 {
-  auto vImpl = std::make_unique<bpImageReaderImpl<TDataType>>(aInputFile, aImageIndex, aOptions);
-  mImpl = std::make_unique<cThreadSafeDecorator>(std::move(vImpl));
+  auto vMutex = std::make_shared<std::mutex>();
+  auto vImpl = std::make_unique<bpImageReaderImpl<TDataType>>(aInputFile, aImageIndex, aOptions, vMutex);
+  mImpl = std::make_unique<cThreadSafeDecorator>(std::move(vImpl), vMutex, aOptions.mConcurrentReadData);
 }
 
 template <typename TDataType>
@@ -366,6 +319,19 @@ void bpImageReader<TDataType>::ReadMetadata(
   mImpl->ReadMetadata(aImageSizePerResolution, aFileBlockSizePerResolution, aImageExtent, aTimeInfoPerTimePoint, aColorInfoPerChannel, aCompressionAlgorithmType);
 }
 
+template <typename TDataType>
+void bpImageReader<TDataType>::ReadMetadata(
+  bpReaderTypes::tMetadataFields aFields,
+  std::vector<tSize5D>& aImageSizePerResolution,
+  std::vector<tSize5D>& aFileBlockSizePerResolution,
+  cImageExtent& aImageExtent,
+  tTimeInfoVector& aTimeInfoPerTimePoint,
+  tColorInfoVector& aColorInfoPerChannel,
+  tCompressionAlgorithmType& aCompressionAlgorithmType)
+{
+  mImpl->ReadMetadata(aFields, aImageSizePerResolution, aFileBlockSizePerResolution, aImageExtent, aTimeInfoPerTimePoint, aColorInfoPerChannel, aCompressionAlgorithmType);
+}
+
 template <typename TDataType>
 void bpImageReader<TDataType>::ReadParameters(tParameters& aParameters)
 {
@@ -378,6 +344,68 @@ void bpImageReader<TDataType>::ReadData(const tIndex5D& aBegin, const tIndex5D&
   mImpl->ReadData(aBegin, aEnd, aResolutionIndex, aData);
 }
 
+template <typename TDataType>
+void bpImageReader<TDataType>::ReadData(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData, const tSize5D& aByteStrides, TDataType aFillValue)
+{
+  mImpl->ReadData(aBegin, aEnd, aResolutionIndex, aData, aByteStrides, aFillValue);
+}
+
+template <typename TDataType>
+void bpImageReader<TDataType>::ReadDataBatch(const std::vector<cReadRequest>& aRequests)
+{
+  mImpl->ReadDataBatch(aRequests);
+}
+
+template <typename TDataType>
+void bpImageReader<TDataType>::ReadDataConverted(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, bpFloat* aData, bpFloat aScale, bpFloat aOffset)
+{
+  mImpl->ReadDataConverted(aBegin, aEnd, aResolutionIndex, aData, aScale, aOffset);
+}
+
+template <typename TDataType>
+void bpImageReader<TDataType>::ReadDataConverted(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, bpReaderTypes::cFloat16* aData, bpFloat aScale, bpFloat aOffset)
+{
+  mImpl->ReadDataConverted(aBegin, aEnd, aResolutionIndex, aData, aScale, aOffset);
+}
+
+template <typename TDataType>
+void bpImageReader<TDataType>::ReadDataConverted(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, bpFloat aScale, bpFloat aOffset)
+{
+  mImpl->ReadDataConverted(aBegin, aEnd, aResolutionIndex, aData, aScale, aOffset);
+}
+
+template <typename TDataType>
+void bpImageReader<TDataType>::ReadDataDisplay(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, const tColorInfoVector& aColorInfoPerChannel)
+{
+  mImpl->ReadDataDisplay(aBegin, aEnd, aResolutionIndex, aData, aColorInfoPerChannel);
+}
+
+template <typename TDataType>
+void bpImageReader<TDataType>::ReadDataRGBA(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, const tColorInfoVector& aColorInfoPerChannel)
+{
+  mImpl->ReadDataRGBA(aBegin, aEnd, aResolutionIndex, aData, aColorInfoPerChannel);
+}
+
+template <typename TDataType>
+const TDataType* bpImageReader<TDataType>::ReadDataView(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex)
+{
+  return mImpl->ReadDataView(aBegin, aEnd, aResolutionIndex);
+}
+
+template <typename TDataType>
+std::future<bpReaderTypes::tReadStatus> bpImageReader<TDataType>::ReadDataAsync(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData,
+  bpReaderTypes::tReadPriority aPriority, const bpReaderTypes::cCancellationToken& aToken)
+{
+  return mImpl->ReadDataAsync(aBegin, aEnd, aResolutionIndex, aData, aPriority, aToken);
+}
+
+template <typename TDataType>
+void bpImageReader<TDataType>::ReadDataAsync(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData, tReadCallback aCallback,
+  bpReaderTypes::tReadPriority aPriority, const bpReaderTypes::cCancellationToken& aToken)
+{
+  mImpl->ReadDataAsync(aBegin, aEnd, aResolutionIndex, aData, std::move(aCallback), aPriority, aToken);
+}
+
 
 template <typename TDataType>
 bpImageReaderBaseInterface::cHistogram bpImageReader<TDataType>::ReadHistogram(const bpVec3& aIndexTCR)
@@ -392,6 +420,19 @@ bpImageReaderBaseInterface::cThumbnail bpImageReader<TDataType>::ReadThumbnail()
   return mImpl->ReadThumbnail();
 }
 
+
+template <typename TDataType>
+bpReaderTypes::cChunkCacheStatistics bpImageReader<TDataType>::GetChunkCacheStatistics()
+{
+  return mImpl->GetChunkCacheStatistics();
+}
+
+template <typename TDataType>
+std::vector<bpReaderTypes::cReadPlanItem> bpImageReader<TDataType>::PlanRead(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex)
+{
+  return mImpl->PlanRead(aBegin, aEnd, aResolutionIndex);
+}
+
 template class bpImageReader<bpUInt8>;
 template class bpImageReader<bpUInt16>;
 template class bpImageReader<bpUInt32>;
@@ -19,11 +19,19 @@
 #endif
 
 #include "ImarisReader/reader/bpImageReaderImpl.h"
+#include "ImarisReader/reader/bpReadPlanner.h"
+#include "ImarisReader/interface/bpStorage.h"
 
-#include "ImarisReader/utils/bpfFileTools.h"
 #include "ImarisReader/utils/bpfUtils.h"
+#include "ImarisReader/utils/bpfH5Attribute.h"
 #include "ImarisReader/utils/bpfH5LZ4.h"
+#include "ImarisReader/utils/bpfH5ChunkDecoder.h"
+#include "ImarisReader/utils/bpfStringTokenizer.h"
+#include "ImarisReader/utils/bpfReadCoalescer.h"
 
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 
 using namespace bpConverterTypes;
@@ -32,8 +40,164 @@ const bpfString mDataSetDirectoryName = "DataSet";
 const bpfString mDataSetInfoDirectoryName = "DataSetInfo";
 const bpfString mThumbnailDirectoryName = "Thumbnail";
 
+// upper bounds for the raw chunk buffers kept between reads
+static const bpfSize mMaxPooledRawChunks = 64;
+static const bpfSize mMaxPooledRawChunkBytes = 64 << 20;
+
+// raw chunks a ReadDataBatch keeps for later requests that share them before they are decoded
+static const bpfSize mMaxPendingRawChunkBytes = 64 << 20;
+
+
+// as bpfFromString(aString, aValue), without a stream for plain numbers
+template<typename TValue>
+static void ParseValue(const bpfString& aString, TValue& aValue)
+{
+  bpfFromString(aString.data(), aString.data() + aString.size(), aValue);
+}
+
+
+// as bpfSplit(aString, " ", false, false) followed by bpfFromString of each part, values without a part are left unchanged
+static void ParseValues(const bpfString& aString, std::initializer_list<bpfFloat*> aValues)
+{
+  bpfStringTokenizer vTokenizer(aString, ' ', false, false);
+  const bpfChar* vBegin = nullptr;
+  const bpfChar* vEnd = nullptr;
+  for (bpfFloat* vValue : aValues) {
+    if (!vTokenizer.Next(vBegin, vEnd)) {
+      return;
+    }
+    bpfFromString(vBegin, vEnd, *vValue);
+  }
+}
+
+
+// one strided destination of ReadData or ReadDataBatch
 template<typename TDataType>
-bpImageReaderImpl<TDataType>::bpImageReaderImpl(const bpString& aInputFile, bpSize aImageIndex, const bpReaderTypes::cReadOptions& aOptions)
+struct bpImageReaderImpl<TDataType>::cRequest
+{
+  tIndex5D mBegin;
+  tIndex5D mEnd;
+  bpSize mResolutionIndex;
+  bpfUInt8* mData;
+  tSize5D mByteStrides;
+  TDataType mFillValue;
+  // converts the voxels to the type of mData, one per channel from mBegin[C]; empty if it holds TDataType
+  std::vector<const bpfDataConverter*> mConverters;
+};
+
+
+// the part of a chunk that is copied to one destination block
+template<typename TDataType>
+struct bpImageReaderImpl<TDataType>::cChunkTarget
+{
+  // hdf5 order, [z, y, x], in file coordinates
+  hsize_t mBegin[3];
+  hsize_t mEnd[3];
+
+  // destination block that starts at mDestStart in file coordinates, strides in bytes
+  bpfUInt8* mDest;
+  hsize_t mDestStart[3];
+  bpfSize mDestStride[3];
+  TDataType mFillValue;
+  const bpfDataConverter* mConverter;
+};
+
+
+// a raw chunk read from the file and the destinations it is copied to
+template<typename TDataType>
+struct bpImageReaderImpl<TDataType>::cChunkRead
+{
+  bpfSharedPtr<const bpfH5ChunkDecoder> mDecoder;
+  std::vector<bpfUInt8> mRaw;
+  bpfUInt32 mFilterMask = 0;
+  bool mIsValid = false;
+  // the chunk has no storage and holds the fill value of the dataset
+  bool mIsUnwritten = false;
+
+  // decoded chunk that is or will be cached, mRaw is empty if it was found in the cache
+  bpChunkCache::tChunk mDecoded;
+  // unfiltered chunk inside the file mapping, mRaw is empty
+  const bpfUInt8* mMapped = nullptr;
+  bpChunkCache::cKey mCacheKey;
+  // mRaw is read from mFileOffset by ReadDeferredChunks, after the hdf5 calls of the read
+  bool mIsDeferred = false;
+  bpfUInt64 mFileOffset = 0;
+
+  // hdf5 order, [z, y, x], in file coordinates
+  hsize_t mChunkStart[3];
+  hsize_t mChunkDim[3];
+
+  std::vector<cChunkTarget> mTargets;
+};
+
+
+// a block of the destination of which only the part inside the file was written
+template<typename TDataType>
+struct bpImageReaderImpl<TDataType>::cBlockRead
+{
+  bpfUInt8* mDest;
+  // hdf5 order, [z, y, x], strides in bytes
+  bpfSize mDestStride[3];
+  hsize_t mDestDim[3];
+  hsize_t mValidDim[3];
+  bool mIsValid;
+  TDataType mFillValue;
+  const bpfDataConverter* mConverter;
+};
+
+
+/**
+ * Sets the elements [aBegin, aEnd) of the strided block aDest to aFillValue, hdf5 order [z, y, x].
+ * With aConverter the block holds its destination type and aFillValue is converted first.
+ */
+template<typename TDataType>
+static void FillRegion(bpfUInt8* aDest, const bpfSize (&aStride)[3], const hsize_t (&aBegin)[3], const hsize_t (&aEnd)[3], TDataType aFillValue, const bpfDataConverter* aConverter)
+{
+  if (aBegin[0] >= aEnd[0] || aBegin[1] >= aEnd[1] || aBegin[2] >= aEnd[2]) {
+    return;
+  }
+
+  bpfUInt8 vFillValue[sizeof(TDataType) > sizeof(bpfFloat) ? sizeof(TDataType) : sizeof(bpfFloat)] = {};
+  bpfSize vTypeSize = sizeof(TDataType);
+  if (aConverter) {
+    aConverter->Convert(reinterpret_cast<const bpfUInt8*>(&aFillValue), 1, vFillValue);
+    vTypeSize = aConverter->GetDestSize();
+  }
+  else {
+    std::memcpy(vFillValue, &aFillValue, sizeof(TDataType));
+  }
+
+  const bpfUInt8 vZero[sizeof(vFillValue)] = {};
+  bool vIsZero = std::memcmp(vFillValue, vZero, vTypeSize) == 0;
+  bpfSize vRowSize = (bpfSize)(aEnd[2] - aBegin[2]);
+  for (hsize_t vZ = aBegin[0]; vZ < aEnd[0]; ++vZ) {
+    for (hsize_t vY = aBegin[1]; vY < aEnd[1]; ++vY) {
+      bpfUInt8* vRow = aDest + vZ * aStride[0] + vY * aStride[1] + aBegin[2] * aStride[2];
+      if (vIsZero && aStride[2] == vTypeSize) {
+        std::memset(vRow, 0, vRowSize * vTypeSize);
+        continue;
+      }
+      for (bpfSize vX = 0; vX < vRowSize; ++vX) {
+        std::memcpy(vRow + vX * aStride[2], vFillValue, vTypeSize);
+      }
+    }
+  }
+}
+
+
+static bpDataSetHandleCache::cH5ChunkCacheOptions GetH5ChunkCacheOptions(const bpReaderTypes::cReadOptions& aOptions)
+{
+  bpDataSetHandleCache::cH5ChunkCacheOptions vH5ChunkCacheOptions;
+  vH5ChunkCacheOptions.mMode = aOptions.mH5ChunkCacheMode;
+  vH5ChunkCacheOptions.mSizeBytes = aOptions.mH5ChunkCacheSizeBytes;
+  vH5ChunkCacheOptions.mSlots = aOptions.mH5ChunkCacheSlots;
+  vH5ChunkCacheOptions.mPreemption = std::min(std::max(aOptions.mH5ChunkCachePreemption, 0.0f), 1.0f);
+  return vH5ChunkCacheOptions;
+}
+
+
+template<typename TDataType>
+bpImageReaderImpl<TDataType>::bpImageReaderImpl(const bpString& aInputFile, bpSize aImageIndex, const bpReaderTypes::cReadOptions& aOptions, bpfSharedPtr<std::mutex> aIOMutex)
   : mFileName(aInputFile),
   mFileID(0),
   mSWMR(aOptions.mSWMR),
@@ -42,18 +206,62 @@ bpImageReaderImpl<TDataType>::bpImageReaderImpl(const bpString& aInputFile, bpSi
   mType(bpfNoType),
   mHDFType(0),
   mNumberOfDataSets(1),
-  mActiveDataSetIndex(aImageIndex)
+  mActiveDataSetIndex(aImageIndex),
+  mDataSetHandleCache(aOptions.mDataSetHandleCacheSize, GetH5ChunkCacheOptions(aOptions)),
+  mChunkCache(aOptions.mSWMR ? 0 : aOptions.mChunkCacheSizeBytes, aOptions.mChunkCacheEvictionPolicy),
+  mRawChunkPool(mMaxPooledRawChunks, mMaxPooledRawChunkBytes),
+  mConcurrentReadData(aOptions.mConcurrentReadData),
+  mIOMutex(aIOMutex ? aIOMutex : bpfMakeSharedPtr<std::mutex>()),
+  mUserBlockSize(0),
+  mCoalesceGapBytes(aOptions.mCoalesceGapBytes),
+  mCoalesceMaxReadBytes(aOptions.mCoalesceMaxReadBytes),
+  mUnshuffleIntoDestination(aOptions.mUnshuffleIntoDestination),
+  mNumberOfAsyncThreads(std::max<bpfSize>(aOptions.mNumberOfAsyncThreads, 1)),
+  mIsClosing(false)
 {
+  if (aOptions.mParallelDecode) {
+    mDecodePool = bpfMakeUniquePtr<bpfThreadPool>(aOptions.mNumberOfDecodeThreads);
+  }
   H5Zregister_lz4();
-  if (!IsFormat()) {
+  if (!IsFormat(aOptions)) {
     std::cerr << "Imaris Reader: false file format!" << std::endl;
   }
-  ReadProperties();
+  else if (!mSWMR) {
+    bool vIsLocal = aOptions.mFileDriver == bpReaderTypes::eFileDriverDefault || aOptions.mFileDriver == bpReaderTypes::eFileDriverCore;
+    if (aOptions.mMemoryMapUncompressed && vIsLocal) {
+      mMappedFile = bpfMakeUniquePtr<bpfMemoryMappedFile>(mFileName);
+    }
+    if (aOptions.mCoalesceChunkReads && aOptions.mFileDriver == bpReaderTypes::eFileDriverStorage) {
+      mChunkStorage = aOptions.mStorage;
+    }
+    else if (aOptions.mCoalesceChunkReads && aOptions.mFileDriver == bpReaderTypes::eFileDriverDefault) {
+      auto vStorage = bpfMakeSharedPtr<bpLocalStorage>(mFileName);
+      if (vStorage->IsOpen()) {
+        mChunkStorage = vStorage;
+      }
+    }
+    if (mMappedFile || mChunkStorage) {
+      hid_t vPlist = H5Fget_create_plist(mFileID);
+      if (vPlist >= 0) {
+        H5Pget_userblock(vPlist, &mUserBlockSize);
+        H5Pclose(vPlist);
+      }
+    }
+  }
+  if (ReadProperties()) {
+    mMetadata = BuildMetadata();
+  }
 }
 
 template<typename TDataType>
 bpImageReaderImpl<TDataType>::~bpImageReaderImpl()
-{}
+{
+  // waits for the running requests, the file must stay open for them
+  mIsClosing = true;
+  mAsyncPool.reset();
+  mDataSetHandleCache.Invalidate();
+  CloseFile();
+}
 
   
 template<typename TDataType>
@@ -65,39 +273,83 @@ void bpImageReaderImpl<TDataType>::ReadMetadata(
     tColorInfoVector& aColorInfoPerChannel,
     tCompressionAlgorithmType& aCompressionAlgorithmType)
 {
+  ReadMetadata(bpReaderTypes::eMetadataAll, aImageSizePerResolution, aFileBlockSizePerResolution, aImageExtent,
+               aTimeInfoPerTimePoint, aColorInfoPerChannel, aCompressionAlgorithmType);
+}
+
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadMetadata(
+    bpReaderTypes::tMetadataFields aFields,
+    std::vector<tSize5D>& aImageSizePerResolution,
+    std::vector<tSize5D>& aFileBlockSizePerResolution,
+    cImageExtent& aImageExtent,
+    tTimeInfoVector& aTimeInfoPerTimePoint,
+    tColorInfoVector& aColorInfoPerChannel,
+    tCompressionAlgorithmType& aCompressionAlgorithmType)
+{
+  // a file written with SWMR may have grown since the last call
+  if (mSWMR && ReadProperties()) {
+    mMetadata = BuildMetadata();
+  }
+
+  const bpImageMetadata vMetadata = mMetadata;
+  if (aFields & bpReaderTypes::eMetadataImageSize) {
+    aImageSizePerResolution.insert(aImageSizePerResolution.end(), vMetadata.GetImageSizePerResolution().begin(), vMetadata.GetImageSizePerResolution().end());
+  }
+  if (aFields & bpReaderTypes::eMetadataFileBlockSize) {
+    aFileBlockSizePerResolution.insert(aFileBlockSizePerResolution.end(), vMetadata.GetFileBlockSizePerResolution().begin(), vMetadata.GetFileBlockSizePerResolution().end());
+  }
+  if (aFields & bpReaderTypes::eMetadataImageExtent) {
+    aImageExtent = vMetadata.GetImageExtent();
+  }
+  if (aFields & bpReaderTypes::eMetadataTimeInfo) {
+    aTimeInfoPerTimePoint = vMetadata.GetTimeInfoPerTimePoint();
+  }
+  if (aFields & bpReaderTypes::eMetadataColorInfo) {
+    aColorInfoPerChannel = vMetadata.GetColorInfoPerChannel();
+  }
+  if (aFields & bpReaderTypes::eMetadataCompressionAlgorithm) {
+    aCompressionAlgorithmType = vMetadata.GetCompressionAlgorithmType();
+  }
+}
+
+
+template<typename TDataType>
+bpImageMetadata bpImageReaderImpl<TDataType>::BuildMetadata()
+{
+  // image sizes were read by ReadProperties
+  std::vector<tSize5D> vImageSizePerResolution;
+  for (bpSize vResolutionLevel = 0; vResolutionLevel < mNumberOfResolutions; vResolutionLevel++) {
+    vImageSizePerResolution.push_back(tSize5D{ { X, GetSizeX(vResolutionLevel) }, { Y, GetSizeY(vResolutionLevel) }, { Z, GetSizeZ(vResolutionLevel) },
+                                               { T, mNumberOfTimePoints }, { C, mNumberOfChannels } });
+  }
+
+  // the other fields are read on first use, the loaders run under the lock of the calling method
+  bpImageMetadata::cLoaders vLoaders;
+  vLoaders.mFileBlockSizeLoader = [this] { return ReadFileBlockSizes(); };
+  vLoaders.mImageExtentLoader = [this] { return ReadImageExtent(); };
+  vLoaders.mTimeInfoLoader = [this] { return ReadTimeInfo(); };
+  vLoaders.mColorInfoLoader = [this] { return ReadColorInfo(); };
+  vLoaders.mCompressionAlgorithmLoader = [this] { return ReadCompressionAlgorithmType(); };
+  return bpImageMetadata(std::move(vImageSizePerResolution), std::move(vLoaders));
+}
+
+
+template<typename TDataType>
+std::vector<tSize5D> bpImageReaderImpl<TDataType>::ReadFileBlockSizes()
+{
+  std::vector<tSize5D> vFileBlockSizePerResolution;
   bpfString vDirectoryName = GetDirectoryName(mDataSetDirectoryName);
   hid_t vDatasetId = H5Gopen(mFileID, vDirectoryName.c_str(), H5P_DEFAULT);
 
-  // get the number of resolution levels, timepoints and channels
-  hsize_t vNumResolutionLevels;
-  H5Gget_num_objs(vDatasetId, &vNumResolutionLevels);
-  hid_t vResolutionZeroId = H5Gopen(vDatasetId, "ResolutionLevel 0", H5P_DEFAULT);
-  hsize_t vNumTimepoints;
-  H5Gget_num_objs(vResolutionZeroId, &vNumTimepoints);
-  hid_t vTimePointZeroResZeroId = H5Gopen(vResolutionZeroId, "TimePoint 0", H5P_DEFAULT);
-  hsize_t vNumChannels;
-  H5Gget_num_objs(vTimePointZeroResZeroId, &vNumChannels);
-
-  // read image and block sizes
-  for (bpSize vResolutionLevel = 0; vResolutionLevel < vNumResolutionLevels; vResolutionLevel++) {
+  for (bpSize vResolutionLevel = 0; vResolutionLevel < mNumberOfResolutions; vResolutionLevel++) {
     // open resolution level group
     hid_t vResolutionLevelId = H5Gopen(vDatasetId, (bpfString("ResolutionLevel ") + bpfToString(vResolutionLevel)).c_str(), H5P_DEFAULT);
     // open Timepoint 0 and Channel 0
     hid_t vTimePointId = H5Gopen(vResolutionLevelId, "TimePoint 0", H5P_DEFAULT);
     hid_t vChannelId = H5Gopen(vTimePointId, "Channel 0", H5P_DEFAULT);
 
-    // read image size from Channel attributes
-    std::vector<bpfString> vImageSizeStrings{"", "", ""};
-    std::vector<bpSize> vImageSizes(3);
-    ReadAttributeString("ImageSizeX", vImageSizeStrings[0], vChannelId);
-    ReadAttributeString("ImageSizeY", vImageSizeStrings[1], vChannelId);
-    ReadAttributeString("ImageSizeZ", vImageSizeStrings[2], vChannelId);
-    for (bpSize vI = 0; vI < vImageSizes.size(); vI++) {
-      bpfFromString(vImageSizeStrings[vI], vImageSizes[vI]);
-    }
-    aImageSizePerResolution.push_back(tSize5D{ { X, vImageSizes[0] }, { Y, vImageSizes[1] }, { Z, vImageSizes[2] },
-                                                                 { T, (bpSize)vNumTimepoints }, { C, (bpSize)vNumChannels } });
-
     // read image block size from dataset Chunk Shape
     hid_t vDataId = H5Dopen2(vChannelId, "Data", H5P_DEFAULT);
     hid_t vDataspace = H5Dget_space(vDataId);
@@ -106,8 +358,8 @@ void bpImageReaderImpl<TDataType>::ReadMetadata(
     H5Sget_simple_extent_dims(vDataspace, vBlockSizes.data(), NULL);
     hid_t vPlist = H5Dget_create_plist(vDataId);
     H5Pget_chunk(vPlist, vRank, vBlockSizes.data());
-    aFileBlockSizePerResolution.push_back(tSize5D{ { X, (bpSize)vBlockSizes[2] }, { Y, (bpSize)vBlockSizes[1] }, { Z, (bpSize)vBlockSizes[0] },
-                                                                     { T, 1 }, { C, 1 } });
+    vFileBlockSizePerResolution.push_back(tSize5D{ { X, (bpSize)vBlockSizes[2] }, { Y, (bpSize)vBlockSizes[1] }, { Z, (bpSize)vBlockSizes[0] },
+                                                            { T, 1 }, { C, 1 } });
 
     H5Pclose(vPlist);
     H5Sclose(vDataspace);
@@ -118,55 +370,191 @@ void bpImageReaderImpl<TDataType>::ReadMetadata(
     H5Gclose(vResolutionLevelId);
   }
 
-  // read image extents
+  H5Gclose(vDatasetId);
+  return vFileBlockSizePerResolution;
+}
+
+
+template<typename TDataType>
+cImageExtent bpImageReaderImpl<TDataType>::ReadImageExtent()
+{
+  cImageExtent vImageExtent{};
   bpfString vInfoDirectoryName = GetDirectoryName(mDataSetInfoDirectoryName);
   hid_t vDatasetInfoId = H5Gopen(mFileID, vInfoDirectoryName.c_str(), H5P_DEFAULT);
   hid_t vImageId = H5Gopen(vDatasetInfoId, "Image", H5P_DEFAULT);
   std::vector<bpfString> vExtentsMinStrings{"", "", ""};
   std::vector<bpfString> vExtentsMaxStrings{"", "", ""};
-  std::vector<bpSize> vExtentMins(3);
-  std::vector<bpSize> vExtentMaxs(3);
-  ReadAttributeString("ExtMin0", vExtentsMinStrings[0], vImageId);
-  ReadAttributeString("ExtMin1", vExtentsMinStrings[1], vImageId);
-  ReadAttributeString("ExtMin2", vExtentsMinStrings[2], vImageId);
-  ReadAttributeString("ExtMax0", vExtentsMaxStrings[0], vImageId);
-  ReadAttributeString("ExtMax1", vExtentsMaxStrings[1], vImageId);
-  ReadAttributeString("ExtMax2", vExtentsMaxStrings[2], vImageId);
-  bpfFromString(vExtentsMinStrings[0], aImageExtent.mExtentMinX);
-  bpfFromString(vExtentsMinStrings[1], aImageExtent.mExtentMinY);
-  bpfFromString(vExtentsMinStrings[2], aImageExtent.mExtentMinZ);
-  bpfFromString(vExtentsMaxStrings[0], aImageExtent.mExtentMaxX);
-  bpfFromString(vExtentsMaxStrings[1], aImageExtent.mExtentMaxY);
-  bpfFromString(vExtentsMaxStrings[2], aImageExtent.mExtentMaxZ);
-
-  // read time info
-  aTimeInfoPerTimePoint.resize(vNumTimepoints);
+  bpfH5ReadAttributeString("ExtMin0", vExtentsMinStrings[0], vImageId);
+  bpfH5ReadAttributeString("ExtMin1", vExtentsMinStrings[1], vImageId);
+  bpfH5ReadAttributeString("ExtMin2", vExtentsMinStrings[2], vImageId);
+  bpfH5ReadAttributeString("ExtMax0", vExtentsMaxStrings[0], vImageId);
+  bpfH5ReadAttributeString("ExtMax1", vExtentsMaxStrings[1], vImageId);
+  bpfH5ReadAttributeString("ExtMax2", vExtentsMaxStrings[2], vImageId);
+  ParseValue(vExtentsMinStrings[0], vImageExtent.mExtentMinX);
+  ParseValue(vExtentsMinStrings[1], vImageExtent.mExtentMinY);
+  ParseValue(vExtentsMinStrings[2], vImageExtent.mExtentMinZ);
+  ParseValue(vExtentsMaxStrings[0], vImageExtent.mExtentMaxX);
+  ParseValue(vExtentsMaxStrings[1], vImageExtent.mExtentMaxY);
+  ParseValue(vExtentsMaxStrings[2], vImageExtent.mExtentMaxZ);
+
+  H5Gclose(vImageId);
+  H5Gclose(vDatasetInfoId);
+  return vImageExtent;
+}
+
+
+template<typename TDataType>
+tCompressionAlgorithmType bpImageReaderImpl<TDataType>::ReadCompressionAlgorithmType()
+{
+  tCompressionAlgorithmType vCompressionAlgorithmType = eCompressionAlgorithmNone;
+  bpfString vDirectoryName = GetDirectoryName(mDataSetDirectoryName);
+  hid_t vDatasetId = H5Gopen(mFileID, vDirectoryName.c_str(), H5P_DEFAULT);
+  hid_t vChannelId = H5Gopen(vDatasetId, "ResolutionLevel 0/TimePoint 0/Channel 0", H5P_DEFAULT);
+
+  std::vector<tCompressionAlgorithmType> vAlgorithmTypes = {eCompressionAlgorithmNone,
+                                                            eCompressionAlgorithmGzipLevel1, eCompressionAlgorithmGzipLevel2, eCompressionAlgorithmGzipLevel3,
+                                                            eCompressionAlgorithmGzipLevel4, eCompressionAlgorithmGzipLevel5, eCompressionAlgorithmGzipLevel6,
+                                                            eCompressionAlgorithmGzipLevel7, eCompressionAlgorithmGzipLevel8, eCompressionAlgorithmGzipLevel9,
+                                                            eCompressionAlgorithmShuffleGzipLevel1, eCompressionAlgorithmShuffleGzipLevel2, eCompressionAlgorithmShuffleGzipLevel3,
+                                                            eCompressionAlgorithmShuffleGzipLevel4, eCompressionAlgorithmShuffleGzipLevel5, eCompressionAlgorithmShuffleGzipLevel6,
+                                                            eCompressionAlgorithmShuffleGzipLevel7, eCompressionAlgorithmShuffleGzipLevel8, eCompressionAlgorithmShuffleGzipLevel9,
+                                                            eCompressionAlgorithmLZ4, eCompressionAlgorithmShuffleLZ4};
+  hid_t vDataId = H5Dopen2(vChannelId, "Data", H5P_DEFAULT);
+  hid_t vPlist = H5Dget_create_plist(vDataId);
+  std::vector<bpInt32> vFilters;
+  bpInt32 vNumFilters = H5Pget_nfilters(vPlist);
+  if (0 == vNumFilters) {
+    vCompressionAlgorithmType = vAlgorithmTypes[0];
+  }
+  else {
+    for (bpInt32 vF = 0; vF < vNumFilters; vF++) {
+      vFilters.push_back(H5Pget_filter2(vPlist, vF, nullptr, nullptr, nullptr, 0, nullptr, nullptr));
+    }
+    bool vIsShuffle = false;
+    if (vFilters.front() == H5Z_FILTER_SHUFFLE) {
+      vIsShuffle = true;
+    }
+    bpSize vNumElements = 1;
+    bpUInt32 vCompressionLevel[1];
+    bpSize vAlgoIndex = 0;
+    if (vFilters.back() == H5Z_FILTER_DEFLATE) {
+      H5Pget_filter_by_id(vPlist, H5Z_FILTER_DEFLATE, nullptr, &vNumElements, vCompressionLevel, 0, nullptr, nullptr);
+      vAlgoIndex += (bpSize)vCompressionLevel[0];
+      if (vIsShuffle) {
+        vAlgoIndex += 9;
+      }
+      vCompressionAlgorithmType = vAlgorithmTypes[vAlgoIndex];
+    }
+    else if (vFilters.back() == H5Z_FILTER_LZ4) {
+      vAlgoIndex = (vIsShuffle) ? 20 : 19;
+      vCompressionAlgorithmType = vAlgorithmTypes[vAlgoIndex];
+    }
+  }
+  H5Pclose(vPlist);
+  H5Dclose(vDataId);
+  H5Gclose(vChannelId);
+  H5Gclose(vDatasetId);
+  return vCompressionAlgorithmType;
+}
+
+
+template<typename TDataType>
+tTimeInfoVector bpImageReaderImpl<TDataType>::ReadTimeInfo()
+{
+  // time points without a TimePointN attribute keep the time of an empty string
+  tTimeInfoVector vTimeInfoPerTimePoint(mNumberOfTimePoints);
+  bpfString vInfoDirectoryName = GetDirectoryName(mDataSetInfoDirectoryName);
+  hid_t vDatasetInfoId = H5Gopen(mFileID, vInfoDirectoryName.c_str(), H5P_DEFAULT);
+
+  // read time info in time point order, which is the order the attributes were written in; H5Aiterate
+  // would first collect all attributes sorted by name, jumping through the attribute storage of long series
   hid_t vTimeInfoId = H5Gopen(vDatasetInfoId, "TimeInfo", H5P_DEFAULT);
-  for (bpSize vT = 0; vT < vNumTimepoints; vT++) {
-    bpfString vTimeString = "";
-    ReadAttributeString((bpfString("TimePoint") + bpfToString(vT+1)).c_str(), vTimeString, vTimeInfoId);
-    bpfTimeInfo vTime(vTimeString);
-    aTimeInfoPerTimePoint[vT].mJulianDay = vTime.GetJulianDay();
-    aTimeInfoPerTimePoint[vT].mNanosecondsOfDay = vTime.GetNanoseconds();
+  if (vTimeInfoId >= 0) {
+    for (bpfSize vIndexT = 0; vIndexT < vTimeInfoPerTimePoint.size(); ++vIndexT) {
+      bpfChar vAttributeName[32];
+      std::snprintf(vAttributeName, sizeof(vAttributeName), "TimePoint%llu", static_cast<unsigned long long>(vIndexT + 1));
+      ReadTimePoint(vTimeInfoId, vAttributeName, vTimeInfoPerTimePoint[vIndexT]);
+    }
+    H5Gclose(vTimeInfoId);
+  }
+
+  H5Gclose(vDatasetInfoId);
+  return vTimeInfoPerTimePoint;
+}
+
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadTimePoint(hid_t aTimeInfoId, const char* aAttributeName, cTimeInfo& aTimeInfo)
+{
+  hid_t vAttributeId = H5I_INVALID_HID;
+  H5E_BEGIN_TRY {
+    vAttributeId = H5Aopen(aTimeInfoId, aAttributeName, H5P_DEFAULT);
+  } H5E_END_TRY;
+  if (vAttributeId < 0) {
+    return;
+  }
+
+  // timestamps are short enough for the stack, longer values take the general path
+  bpfChar vBuffer[64];
+  bpfSize vLength = 0;
+  bool vIsRead = false;
+  hsize_t vSize = H5Aget_storage_size(vAttributeId);
+  if (vSize < sizeof(vBuffer)) {
+    hid_t vAttributeTypeId = H5Aget_type(vAttributeId);
+    hid_t vAttributeSpaceId = H5Aget_space(vAttributeId);
+    if (vAttributeTypeId >= 0 && vAttributeSpaceId >= 0 && H5Sget_simple_extent_ndims(vAttributeSpaceId) == 1 &&
+        H5Aread(vAttributeId, vAttributeTypeId, vBuffer) >= 0) {
+      vLength = strnlen(vBuffer, static_cast<bpfSize>(vSize));
+      vIsRead = true;
+    }
+    if (vAttributeSpaceId >= 0) {
+      H5Sclose(vAttributeSpaceId);
+    }
+    if (vAttributeTypeId >= 0) {
+      H5Tclose(vAttributeTypeId);
+    }
+  }
+  H5Aclose(vAttributeId);
+  if (vIsRead && bpfTimeInfo::Parse(vBuffer, vBuffer + vLength, aTimeInfo.mJulianDay, aTimeInfo.mNanosecondsOfDay)) {
+    return;
+  }
+
+  bpfString vTimeString = "";
+  if (vIsRead) {
+    vTimeString.assign(vBuffer, vLength);
   }
+  else {
+    bpfH5ReadAttributeString(aAttributeName, vTimeString, aTimeInfoId);
+  }
+  bpfTimeInfo vTime(vTimeString);
+  aTimeInfo.mJulianDay = vTime.GetJulianDay();
+  aTimeInfo.mNanosecondsOfDay = vTime.GetNanoseconds();
+}
+
+
+template<typename TDataType>
+tColorInfoVector bpImageReaderImpl<TDataType>::ReadColorInfo()
+{
+  tColorInfoVector vColorInfoPerChannel;
+  bpSize vNumChannels = mNumberOfChannels;
+  bpfString vInfoDirectoryName = GetDirectoryName(mDataSetInfoDirectoryName);
+  hid_t vDatasetInfoId = H5Gopen(mFileID, vInfoDirectoryName.c_str(), H5P_DEFAULT);
 
   // read color info
-  aColorInfoPerChannel.resize(vNumChannels);
+  vColorInfoPerChannel.resize(vNumChannels);
   for (bpSize vC = 0; vC < vNumChannels; vC++) {
     hid_t vChannelId = H5Gopen(vDatasetInfoId, (bpfString("Channel ") + bpfToString(vC)).c_str(), H5P_DEFAULT);
 
     bpfString vColorMode = "";
-    ReadAttributeString("ColorMode", vColorMode, vChannelId);
+    bpfH5ReadAttributeString("ColorMode", vColorMode, vChannelId);
     if (vColorMode == "BaseColor") {
       bpfString vColorString = "";
-      ReadAttributeString("Color", vColorString, vChannelId);
-      std::vector<bpfString> vColors = bpfSplit(vColorString, " ", false, false);
-      bpfFromString(vColors[0], aColorInfoPerChannel[vC].mBaseColor.mRed);
-      bpfFromString(vColors[1], aColorInfoPerChannel[vC].mBaseColor.mGreen);
-      bpfFromString(vColors[2], aColorInfoPerChannel[vC].mBaseColor.mBlue);
+      bpfH5ReadAttributeString("Color", vColorString, vChannelId);
+      cColor& vBaseColor = vColorInfoPerChannel[vC].mBaseColor;
+      ParseValues(vColorString, { &vBaseColor.mRed, &vBaseColor.mGreen, &vBaseColor.mBlue });
     }
     else {
-      aColorInfoPerChannel[vC].mIsBaseColorMode = false;
+      vColorInfoPerChannel[vC].mIsBaseColorMode = false;
       hid_t vColorTableId = H5Dopen2(vChannelId, "ColorTable", H5P_DEFAULT);
       hid_t vDataspace = H5Dget_space(vColorTableId);
       hsize_t vDim;
@@ -174,219 +562,892 @@ void bpImageReaderImpl<TDataType>::ReadMetadata(
       bpfString vColorTable;
       vColorTable.resize(vDim);
       H5Dread(vColorTableId, H5T_C_S1, H5S_ALL, H5S_ALL, H5P_DEFAULT, &vColorTable[0]);
-      std::vector<bpfString> vColors = bpfSplit(vColorTable, " ", false, true);
-      for (bpSize vI = 0; vI < vColors.size()/3; vI++) {
-        cColor vColor;
-        bpfFromString(vColors[3*vI], vColor.mRed);
-        bpfFromString(vColors[3*vI+1], vColor.mGreen);
-        bpfFromString(vColors[3*vI+2], vColor.mBlue);
-        aColorInfoPerChannel[vC].mColorTable.push_back(vColor);
+      // red, green and blue of each entry, an incomplete last entry is dropped
+      bpfStringTokenizer vTokenizer(vColorTable, ' ', false, true);
+      const bpfChar* vBegin[3];
+      const bpfChar* vEnd[3];
+      while (vTokenizer.Next(vBegin[0], vEnd[0]) && vTokenizer.Next(vBegin[1], vEnd[1]) && vTokenizer.Next(vBegin[2], vEnd[2])) {
+        cColor vColor{ 0, 0, 0, 1 };
+        bpfFromString(vBegin[0], vEnd[0], vColor.mRed);
+        bpfFromString(vBegin[1], vEnd[1], vColor.mGreen);
+        bpfFromString(vBegin[2], vEnd[2], vColor.mBlue);
+        vColorInfoPerChannel[vC].mColorTable.push_back(vColor);
       }
       H5Sclose(vDataspace);
       H5Dclose(vColorTableId);
     }
 
-    // read opacity
-    bpfString vOpacity = "";
-    ReadAttributeString("ColorOpacity", vOpacity, vChannelId);
-    bpfFromString(vOpacity, aColorInfoPerChannel[vC].mOpacity);
+    // read opacity
+    bpfString vOpacity = "";
+    bpfH5ReadAttributeString("ColorOpacity", vOpacity, vChannelId);
+    ParseValue(vOpacity, vColorInfoPerChannel[vC].mOpacity);
+
+    // read range
+    bpfString vRange = "";
+    bpfH5ReadAttributeString("ColorRange", vRange, vChannelId);
+    ParseValues(vRange, { &vColorInfoPerChannel[vC].mRangeMin, &vColorInfoPerChannel[vC].mRangeMax });
+
+    // read gamma correction
+    bpfString vGamma = "";
+    bpfH5ReadAttributeString("GammaCorrection", vGamma, vChannelId);
+    ParseValue(vGamma, vColorInfoPerChannel[vC].mGammaCorrection);
+
+    H5Gclose(vChannelId);
+  }
+  H5Gclose(vDatasetInfoId);
+  return vColorInfoPerChannel;
+}
+
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadParameters(tParameters& aParameters)
+{
+  bpfString vDirectoryName = GetDirectoryName(mDataSetInfoDirectoryName);
+  hid_t vDataSetInfoId = H5Gopen(mFileID, vDirectoryName.c_str(), H5P_DEFAULT);
+
+  hsize_t vNumberOfSections = 0;
+  H5Gget_num_objs(vDataSetInfoId, &vNumberOfSections);
+  ssize_t vSectionNameSize = 0;
+  bpfChar* vSectionName = nullptr;
+  hid_t vSectionId;
+
+  // loop over sections
+  for (hsize_t vSectionIndex = 0; vSectionIndex < vNumberOfSections; ++vSectionIndex) {
+    if (H5Gget_objtype_by_idx(vDataSetInfoId, vSectionIndex) == H5G_GROUP) {
+      // get new section name
+      vSectionNameSize = H5Gget_objname_by_idx(vDataSetInfoId, vSectionIndex, nullptr, 0) + 1;
+      vSectionName = new bpfChar[vSectionNameSize];
+      bpfParameterSection* vParameterSection = new bpfParameterSection;
+      H5Gget_objname_by_idx(vDataSetInfoId, vSectionIndex, vSectionName, static_cast<bpfSize>(vSectionNameSize));
+
+      // open the group and read attributes
+      vSectionId = H5Gopen(vDataSetInfoId, vSectionName, H5P_DEFAULT);
+      ReadSection(vSectionId, vParameterSection, true);
+      H5Gclose(vSectionId);
+
+      auto vSectionIter = vParameterSection->Begin();
+      while (vSectionIter != vParameterSection->End()) {
+        aParameters[vSectionName].emplace(vSectionIter->first, vSectionIter->second);
+        vSectionIter++;
+      }
+
+      delete vParameterSection;
+      delete[] vSectionName;
+    }
+  }
+
+  H5Gclose(vDataSetInfoId);
+}
+
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadData(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData)
+{
+  ReadData(aBegin, aEnd, aResolutionIndex, aData, GetDenseByteStrides(aBegin, aEnd, aResolutionIndex), 0);
+}
+
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadData(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData, const tSize5D& aByteStrides, TDataType aFillValue)
+{
+  ReadRequests({ { aBegin, aEnd, aResolutionIndex, reinterpret_cast<bpfUInt8*>(aData), aByteStrides, aFillValue, {} } });
+}
+
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadDataBatch(const std::vector<typename bpImageReaderInterface<TDataType>::cReadRequest>& aRequests)
+{
+  std::vector<cRequest> vRequests;
+  vRequests.reserve(aRequests.size());
+  for (const auto& vRequest : aRequests) {
+    tSize5D vByteStrides = GetDenseByteStrides(vRequest.mBegin, vRequest.mEnd, vRequest.mResolutionIndex);
+    vRequests.push_back({ vRequest.mBegin, vRequest.mEnd, vRequest.mResolutionIndex, reinterpret_cast<bpfUInt8*>(vRequest.mData), vByteStrides, 0, {} });
+  }
+  ReadRequests(vRequests);
+}
+
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadDataConverted(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, bpFloat* aData, bpFloat aScale, bpFloat aOffset)
+{
+  ReadConverted(aBegin, aEnd, aResolutionIndex, reinterpret_cast<bpfUInt8*>(aData), bpfDataConverter::eFloat32, aScale, aOffset);
+}
+
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadDataConverted(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, bpReaderTypes::cFloat16* aData, bpFloat aScale, bpFloat aOffset)
+{
+  ReadConverted(aBegin, aEnd, aResolutionIndex, reinterpret_cast<bpfUInt8*>(aData), bpfDataConverter::eFloat16, aScale, aOffset);
+}
+
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadDataConverted(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, bpFloat aScale, bpFloat aOffset)
+{
+  ReadConverted(aBegin, aEnd, aResolutionIndex, aData, bpfDataConverter::eUInt8, aScale, aOffset);
+}
+
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadConverted(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, bpfUInt8* aData, bpfDataConverter::tType aType, bpfFloat aScale, bpfFloat aOffset)
+{
+  // the conversion is fused with the copy of each row into aData, there is no intermediate TDataType block
+  bpfDataConverter vConverter(bpfDataConverter::GetType<TDataType>(), aType, aScale, aOffset);
+  tSize5D vByteStrides = GetDenseByteStrides(aBegin, aEnd, aResolutionIndex, vConverter.GetDestSize());
+  bpSize vEndC = std::min(aEnd[C], GetSizeC(aResolutionIndex));
+  std::vector<const bpfDataConverter*> vConverters(vEndC > aBegin[C] ? vEndC - aBegin[C] : 0, &vConverter);
+  ReadRequests({ { aBegin, aEnd, aResolutionIndex, aData, vByteStrides, 0, vConverters } });
+}
+
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadDataDisplay(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, const tColorInfoVector& aColorInfoPerChannel)
+{
+  // the window of each channel is applied through its lookup table while the rows are copied into aData
+  bpSize vEndC = std::min(aEnd[C], GetSizeC(aResolutionIndex));
+  std::vector<bpfSharedPtr<const bpfDataConverter>> vTables;
+  std::vector<const bpfDataConverter*> vConverters;
+  for (bpSize vIndexC = aBegin[C]; vIndexC < vEndC; ++vIndexC) {
+    vTables.push_back(GetDisplayConverter(vIndexC < aColorInfoPerChannel.size() ? aColorInfoPerChannel[vIndexC] : cColorInfo()));
+    vConverters.push_back(vTables.back().get());
+  }
+  tSize5D vByteStrides = GetDenseByteStrides(aBegin, aEnd, aResolutionIndex, sizeof(bpUInt8));
+  ReadRequests({ { aBegin, aEnd, aResolutionIndex, aData, vByteStrides, 0, vConverters } });
+}
+
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadDataRGBA(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, const tColorInfoVector& aColorInfoPerChannel)
+{
+  // tables only for the read channels, those without an entry in aColorInfoPerChannel use the defaults
+  bpSize vEndC = std::min(aEnd[C], GetSizeC(aResolutionIndex));
+  bpSize vEndT = std::min(aEnd[T], GetSizeT(aResolutionIndex));
+  bpfRGBACompositor<TDataType> vCompositor;
+  for (bpSize vIndexC = aBegin[C]; vIndexC < vEndC; ++vIndexC) {
+    vCompositor.SetChannelTable(vIndexC, GetRGBAChannelTable(vIndexC < aColorInfoPerChannel.size() ? aColorInfoPerChannel[vIndexC] : cColorInfo()));
+  }
+
+  // the channels of one time point are read and then blended into its image
+  bpSize vNumberOfVoxels = (aEnd[X] - aBegin[X]) * (aEnd[Y] - aBegin[Y]) * (aEnd[Z] - aBegin[Z]);
+  bpSize vNumberOfChannels = vEndC > aBegin[C] ? vEndC - aBegin[C] : 0;
+  thread_local std::vector<TDataType> vChannels;
+  vChannels.resize(vNumberOfVoxels * vNumberOfChannels);
+  bpfPackedRGBA* vRGBA = reinterpret_cast<bpfPackedRGBA*>(aData);
+  for (bpSize vIndexT = aBegin[T]; vIndexT < aEnd[T]; ++vIndexT) {
+    bpfPackedRGBA* vImage = vRGBA + vNumberOfVoxels * (vIndexT - aBegin[T]);
+    if (vIndexT >= vEndT) {
+      // time points beyond the image are black
+      std::fill(vImage, vImage + vNumberOfVoxels, bpfPackedRGBA(0, 0, 0, 0));
+      continue;
+    }
+    tIndex5D vBegin = aBegin;
+    tIndex5D vEnd = aEnd;
+    vBegin[T] = vIndexT;
+    vEnd[T] = vIndexT + 1;
+    tSize5D vByteStrides = GetDenseByteStrides(vBegin, vEnd, aResolutionIndex, sizeof(TDataType));
+    ReadRequests({ { vBegin, vEnd, aResolutionIndex, reinterpret_cast<bpfUInt8*>(vChannels.data()), vByteStrides, 0, {} } });
+    vCompositor.Composite(vChannels.data(), vNumberOfVoxels, aBegin[C], vNumberOfChannels, vImage);
+  }
+}
+
+
+template<typename TDataType>
+bpfSharedPtr<const bpfDataConverter> bpImageReaderImpl<TDataType>::GetDisplayConverter(const cColorInfo& aColorInfo)
+{
+  auto vKey = std::make_tuple(aColorInfo.mRangeMin, aColorInfo.mRangeMax, aColorInfo.mGammaCorrection);
+  std::lock_guard<std::mutex> vLock(mDisplayConvertersMutex);
+  auto vConverterIt = mDisplayConverters.find(vKey);
+  if (vConverterIt != mDisplayConverters.end()) {
+    return vConverterIt->second;
+  }
+
+  // a viewer usually moves the window of few channels at a time, old windows are simply dropped
+  if (mDisplayConverters.size() >= 64) {
+    mDisplayConverters.clear();
+  }
+  auto vConverter = bpfMakeSharedPtr<const bpfDataConverter>(bpfDataConverter::GetType<TDataType>(), aColorInfo.mRangeMin, aColorInfo.mRangeMax, aColorInfo.mGammaCorrection);
+  mDisplayConverters[vKey] = vConverter;
+  return vConverter;
+}
+
+
+template<typename TDataType>
+bpfSharedPtr<const bpfRGBAChannelTable> bpImageReaderImpl<TDataType>::GetRGBAChannelTable(const cColorInfo& aColorInfo)
+{
+  // all fields that the table depends on
+  std::vector<bpfFloat> vKey = { aColorInfo.mIsBaseColorMode ? 1.0f : 0.0f, aColorInfo.mOpacity, aColorInfo.mRangeMin, aColorInfo.mRangeMax, aColorInfo.mGammaCorrection };
+  const cColor& vBaseColor = aColorInfo.mBaseColor;
+  if (aColorInfo.mIsBaseColorMode) {
+    vKey.insert(vKey.end(), { vBaseColor.mRed, vBaseColor.mGreen, vBaseColor.mBlue, vBaseColor.mAlpha });
+  }
+  else {
+    for (const cColor& vColor : aColorInfo.mColorTable) {
+      vKey.insert(vKey.end(), { vColor.mRed, vColor.mGreen, vColor.mBlue, vColor.mAlpha });
+    }
+  }
+
+  std::lock_guard<std::mutex> vLock(mRGBAChannelTablesMutex);
+  auto vTableIt = mRGBAChannelTables.find(vKey);
+  if (vTableIt != mRGBAChannelTables.end()) {
+    return vTableIt->second;
+  }
+
+  // as the display converters, tables of old windows are simply dropped
+  if (mRGBAChannelTables.size() >= 64) {
+    mRGBAChannelTables.clear();
+  }
+  auto vTable = bpfRGBACompositor<TDataType>::MakeChannelTable(aColorInfo);
+  mRGBAChannelTables[vKey] = vTable;
+  return vTable;
+}
+
+
+template<typename TDataType>
+const TDataType* bpImageReaderImpl<TDataType>::ReadDataView(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex)
+{
+  if (!mMappedFile || aEnd[T] != aBegin[T] + 1 || aEnd[C] != aBegin[C] + 1) {
+    return nullptr;
+  }
+
+  bpDataSetHandleCache::cHandle* vHandle = mDataSetHandleCache.Get(mFileID, GetDirectoryName(mDataSetDirectoryName), { aResolutionIndex, aBegin[T], aBegin[C] });
+  if (!vHandle) {
+    return nullptr;
+  }
+
+  // only a whole chunk is contiguous in the file
+  hsize_t vBegin[] = { aBegin[Z], aBegin[Y], aBegin[X] };
+  hsize_t vEnd[] = { aEnd[Z], aEnd[Y], aEnd[X] };
+  hsize_t vChunkIndex[3];
+  for (bpfSize vIndex = 0; vIndex < 3; vIndex++) {
+    hsize_t vChunkDim = vHandle->mChunkDim[vIndex];
+    if (vChunkDim == 0 || vBegin[vIndex] % vChunkDim != 0 || vEnd[vIndex] != vBegin[vIndex] + vChunkDim || vEnd[vIndex] > vHandle->mFileDim[vIndex]) {
+      return nullptr;
+    }
+    vChunkIndex[vIndex] = vBegin[vIndex] / vChunkDim;
+  }
+
+  const bpfUInt8* vChunk = GetMappedChunk(*vHandle, vChunkIndex);
+  if (reinterpret_cast<std::uintptr_t>(vChunk) % alignof(TDataType) != 0) {
+    return nullptr;
+  }
+  return reinterpret_cast<const TDataType*>(vChunk);
+}
+
+
+template<typename TDataType>
+std::future<bpReaderTypes::tReadStatus> bpImageReaderImpl<TDataType>::ReadDataAsync(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData,
+  bpReaderTypes::tReadPriority aPriority, const bpReaderTypes::cCancellationToken& aToken)
+{
+  auto vPromise = bpfMakeSharedPtr<std::promise<bpReaderTypes::tReadStatus>>();
+  std::future<bpReaderTypes::tReadStatus> vFuture = vPromise->get_future();
+  ReadDataAsync(aBegin, aEnd, aResolutionIndex, aData, [vPromise](bpReaderTypes::tReadStatus aStatus) {
+    vPromise->set_value(aStatus);
+  }, aPriority, aToken);
+  return vFuture;
+}
+
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadDataAsync(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData,
+  typename bpImageReaderInterface<TDataType>::tReadCallback aCallback, bpReaderTypes::tReadPriority aPriority, const bpReaderTypes::cCancellationToken& aToken)
+{
+  cRequest vRequest{ aBegin, aEnd, aResolutionIndex, reinterpret_cast<bpfUInt8*>(aData), GetDenseByteStrides(aBegin, aEnd, aResolutionIndex), 0, {} };
+  GetAsyncPool().Enqueue([this, vRequest, aToken, aCallback] {
+    aCallback(ReadQueued(vRequest, aToken));
+  }, aPriority);
+}
+
+
+template<typename TDataType>
+bpReaderTypes::tReadStatus bpImageReaderImpl<TDataType>::ReadQueued(const cRequest& aRequest, const bpReaderTypes::cCancellationToken& aToken)
+{
+  if (mIsClosing || aToken.IsCancelled()) {
+    return bpReaderTypes::eReadStatusCancelled;
+  }
+
+  // the executor is not behind the reader lock of the caller, in concurrent mode ReadRequests locks itself
+  std::unique_lock<std::mutex> vLock(*mIOMutex, std::defer_lock);
+  if (!mConcurrentReadData) {
+    vLock.lock();
+  }
+  try {
+    return ReadRequests({ aRequest }, &aToken) ? bpReaderTypes::eReadStatusCompleted : bpReaderTypes::eReadStatusCancelled;
+  }
+  catch (...) {
+    return bpReaderTypes::eReadStatusFailed;
+  }
+}
+
+
+template<typename TDataType>
+bpfThreadPool& bpImageReaderImpl<TDataType>::GetAsyncPool()
+{
+  std::call_once(mAsyncPoolOnce, [this] {
+    mAsyncPool = bpfMakeUniquePtr<bpfThreadPool>(mNumberOfAsyncThreads);
+  });
+  return *mAsyncPool;
+}
+
+
+template<typename TDataType>
+tSize5D bpImageReaderImpl<TDataType>::GetDenseByteStrides(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, bpfSize aTypeSize) const
+{
+  // dense, x fastest, one block per channel and time point
+  bpSize vEndC = std::min(aEnd[C], GetSizeC(aResolutionIndex));
+  bpSize vStrideX = aTypeSize;
+  bpSize vStrideY = vStrideX * (aEnd[X] - aBegin[X]);
+  bpSize vStrideZ = vStrideY * (aEnd[Y] - aBegin[Y]);
+  bpSize vStrideC = vStrideZ * (aEnd[Z] - aBegin[Z]);
+  bpSize vStrideT = vStrideC * (vEndC - aBegin[C]);
+  return tSize5D(X, vStrideX, Y, vStrideY, Z, vStrideZ, C, vStrideC, T, vStrideT);
+}
+
+
+template<typename TDataType>
+bool bpImageReaderImpl<TDataType>::ReadRequests(const std::vector<cRequest>& aRequests, const bpReaderTypes::cCancellationToken* aToken)
+{
+  bpfString vDirectoryName = GetDirectoryName(mDataSetDirectoryName);
+  std::vector<cBlockRead> vBlocks;
+  std::vector<cChunkRead> vChunks;
+  tChunkIndices vChunkIndices;
+
+  // in concurrent mode only the hdf5 calls below are serialized, otherwise the caller holds the lock
+  std::unique_lock<std::mutex> vIOLock(*mIOMutex, std::defer_lock);
+  if (mConcurrentReadData) {
+    vIOLock.lock();
+  }
+
+  // reads and decodes the pending chunks outside of the lock, the lock is not taken again
+  bpfSize vPendingRawBytes = 0;
+  auto vDecodePending = [&]() {
+    if (vIOLock.owns_lock()) {
+      vIOLock.unlock();
+    }
+    ReadDeferredChunks(vChunks);
+    FillBlocks(vBlocks);
+    DecodeChunks(vChunks, aToken);
+    vBlocks.clear();
+    vChunks.clear();
+    vChunkIndices.clear();
+    vPendingRawBytes = 0;
+  };
+
+  for (const cRequest& vRequest : aRequests) {
+    const tIndex5D& vBegin = vRequest.mBegin;
+    const tIndex5D& vEnd = vRequest.mEnd;
+    bpSize vResolutionIndex = vRequest.mResolutionIndex;
+    const tSize5D& vByteStrides = vRequest.mByteStrides;
+
+    bpSize vEndT = std::min(vEnd[T], GetSizeT(vResolutionIndex));
+    bpSize vEndC = std::min(vEnd[C], GetSizeC(vResolutionIndex));
+    hsize_t vStart[] = { vBegin[Z], vBegin[Y], vBegin[X]};
+    hsize_t vReadSizeDim[] = { vEnd[Z] - vBegin[Z], vEnd[Y] - vBegin[Y], vEnd[X] - vBegin[X] };
+    bpfSize vStride[] = { vByteStrides[Z], vByteStrides[Y], vByteStrides[X] };
+    // voxels beyond the image size are padding of the last chunks, with SWMR the image may have grown since opening
+    hsize_t vImageDim[] = { std::numeric_limits<hsize_t>::max(), std::numeric_limits<hsize_t>::max(), std::numeric_limits<hsize_t>::max() };
+    if (!mSWMR && vResolutionIndex < mSizeX.size()) {
+      vImageDim[0] = GetSizeZ(vResolutionIndex);
+      vImageDim[1] = GetSizeY(vResolutionIndex);
+      vImageDim[2] = GetSizeX(vResolutionIndex);
+    }
+
+    for (bpSize vIndexT = vBegin[T]; vIndexT < vEndT; ++vIndexT) {
+      bpfUInt8* vBlockT = vRequest.mData + vByteStrides[T] * (vIndexT - vBegin[T]);
+
+      for (bpSize vIndexC = vBegin[C]; vIndexC < vEndC; ++vIndexC) {
+        if (aToken && aToken->IsCancelled()) {
+          return false;
+        }
+
+        const bpfDataConverter* vConverter = vRequest.mConverters.empty() ? nullptr : vRequest.mConverters[vIndexC - vBegin[C]];
+
+        bpfUInt8* vBlock = vBlockT + vByteStrides[C] * (vIndexC - vBegin[C]);
+
+        bpDataSetHandleCache::cHandle* vHandle = mDataSetHandleCache.Get(mFileID, vDirectoryName, { vResolutionIndex, vIndexT, vIndexC });
+        if (vHandle && mSWMR && !mDataSetHandleCache.Refresh(*vHandle)) {
+          vHandle = nullptr;
+        }
+        if (!vHandle) {
+          vBlocks.push_back({ vBlock, { vStride[0], vStride[1], vStride[2] }, { vReadSizeDim[0], vReadSizeDim[1], vReadSizeDim[2] }, { 0, 0, 0 }, false, vRequest.mFillValue, vConverter });
+          continue;
+        }
+
+        bpChunkCache::cKey vCacheKey{ mActiveDataSetIndex, vResolutionIndex, vIndexT, vIndexC, { 0, 0, 0 } };
+        hsize_t vExtent[3];
+        for (bpfSize vIndex = 0; vIndex < 3; vIndex++) {
+          vExtent[vIndex] = std::min(vImageDim[vIndex], vHandle->mFileDim[vIndex]);
+        }
+        // shuffled datasets are unshuffled by the chunk decoder directly into the destination only on request,
+        // a plain ReadData stays on H5Dread and hdf5's chunk cache
+        bool vUnshuffle = mUnshuffleIntoDestination && GetDecoder(*vHandle).HasShuffle();
+        bool vReadChunks = mDecodePool || mChunkCache.IsEnabled() || mConcurrentReadData || mMappedFile || mChunkStorage || aRequests.size() > 1 || vUnshuffle;
+        bpfSize vNumberOfChunks = vChunks.size();
+        if (!vReadChunks || !ReadBlockChunks(*vHandle, vCacheKey, vExtent, vStart, vReadSizeDim, vBlock, vStride, vRequest.mFillValue, vConverter, vChunkIndices, vChunks, vBlocks)) {
+          ReadBlock(*vHandle, vExtent, vStart, vReadSizeDim, vBlock, vStride, vRequest.mFillValue, vConverter, vBlocks);
+        }
+        for (bpfSize vIndex = vNumberOfChunks; vIndex < vChunks.size(); ++vIndex) {
+          vPendingRawBytes += vChunks[vIndex].mRaw.size();
+        }
+
+        // blocks are decoded one by one, a batch keeps chunks that later requests may share up to a budget
+        if (aRequests.size() == 1 || vPendingRawBytes >= mMaxPendingRawChunkBytes) {
+          vDecodePending();
+          if (aToken && aToken->IsCancelled()) {
+            return false;
+          }
+          if (mConcurrentReadData) {
+            vIOLock.lock();
+          }
+        }
+      }
+    }
+  }
+
+  if (vIOLock.owns_lock()) {
+    vIOLock.unlock();
+  }
+
+  if (aToken && aToken->IsCancelled()) {
+    return false;
+  }
+
+  vDecodePending();
+  return !aToken || !aToken->IsCancelled();
+}
 
-    // read range
-    bpfString vRange = "";
-    ReadAttributeString("ColorRange", vRange, vChannelId);
-    std::vector<bpfString> vMinAndMaxRange = bpfSplit(vRange, " ", false, false);
-    bpfFromString(vMinAndMaxRange[0], aColorInfoPerChannel[vC].mRangeMin);
-    bpfFromString(vMinAndMaxRange[1], aColorInfoPerChannel[vC].mRangeMax);
 
-    // read gamma correction
-    bpfString vGamma = "";
-    ReadAttributeString("GammaCorrection", vGamma, vChannelId);
-    bpfFromString(vGamma, aColorInfoPerChannel[vC].mGammaCorrection);
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadBlock(bpDataSetHandleCache::cHandle& aHandle, const hsize_t (&aExtent)[3], const hsize_t (&aStart)[3], const hsize_t (&aSize)[3], bpfUInt8* aDest, const bpfSize (&aStride)[3], TDataType aFillValue, const bpfDataConverter* aConverter, std::vector<cBlockRead>& aBlocks)
+{
+  cBlockRead vBlock{ aDest, { aStride[0], aStride[1], aStride[2] }, { aSize[0], aSize[1], aSize[2] }, { aSize[0], aSize[1], aSize[2] }, false, aFillValue, aConverter };
+  hsize_t* vMemDim = vBlock.mValidDim;
 
-    H5Gclose(vChannelId);
+  for (bpfSize vIndex = 0; vIndex < 3; vIndex++) {
+    if (aStart[vIndex] + vMemDim[vIndex] > aExtent[vIndex]) {
+      vMemDim[vIndex] = aStart[vIndex] < aExtent[vIndex] ? aExtent[vIndex] - aStart[vIndex] : 0;
+    }
+  }
+  if (vMemDim[0] == 0 || vMemDim[1] == 0 || vMemDim[2] == 0) {
+    vBlock.mIsValid = true;
+    aBlocks.push_back(vBlock);
+    return;
   }
 
-  // read compression algorithm
-  std::vector<tCompressionAlgorithmType> vAlgorithmTypes = {eCompressionAlgorithmNone,
-                                                            eCompressionAlgorithmGzipLevel1, eCompressionAlgorithmGzipLevel2, eCompressionAlgorithmGzipLevel3,
-                                                            eCompressionAlgorithmGzipLevel4, eCompressionAlgorithmGzipLevel5, eCompressionAlgorithmGzipLevel6,
-                                                            eCompressionAlgorithmGzipLevel7, eCompressionAlgorithmGzipLevel8, eCompressionAlgorithmGzipLevel9,
-                                                            eCompressionAlgorithmShuffleGzipLevel1, eCompressionAlgorithmShuffleGzipLevel2, eCompressionAlgorithmShuffleGzipLevel3,
-                                                            eCompressionAlgorithmShuffleGzipLevel4, eCompressionAlgorithmShuffleGzipLevel5, eCompressionAlgorithmShuffleGzipLevel6,
-                                                            eCompressionAlgorithmShuffleGzipLevel7, eCompressionAlgorithmShuffleGzipLevel8, eCompressionAlgorithmShuffleGzipLevel9,
-                                                            eCompressionAlgorithmLZ4, eCompressionAlgorithmShuffleLZ4};
-  hid_t vChannelId = H5Gopen(vTimePointZeroResZeroId, "Channel 0", H5P_DEFAULT);
-  hid_t vDataId = H5Dopen2(vChannelId, "Data", H5P_DEFAULT);
-  hid_t vPlist = H5Dget_create_plist(vDataId);
-  std::vector<bpInt32> vFilters;
-  bpInt32 vNumFilters = H5Pget_nfilters(vPlist);
-  if (0 == vNumFilters) {
-    aCompressionAlgorithmType = vAlgorithmTypes[0];
+  H5Sselect_hyperslab(aHandle.mDataSpaceId, H5S_SELECT_SET, aStart, nullptr, vMemDim, nullptr);
+
+  // lz4 chunks that hdf5 decodes in this read use the decode threads of this reader
+  bpfH5LZ4ThreadPoolScope vLZ4Scope(mDecodePool.get());
+
+  const bpfSize vTypeSize = sizeof(TDataType);
+  bool vIsPitched = !aConverter && aStride[2] == vTypeSize &&
+    aStride[1] % vTypeSize == 0 && aStride[1] >= aSize[2] * vTypeSize &&
+    aStride[0] % aStride[1] == 0 && aStride[0] >= aStride[1] * aSize[1];
+
+  if (vIsPitched) {
+    // the memory space spans the pitched destination, so rows land at their final position
+    hsize_t vMemSpaceDim[3] = { aSize[0], aStride[0] / aStride[1], aStride[1] / vTypeSize };
+    hid_t vMemSpaceID = H5Screate_simple(3, vMemSpaceDim, nullptr);
+    if (H5I_INVALID_HID < vMemSpaceID) {
+      const hsize_t vMemStart[3] = { 0, 0, 0 };
+      if (H5Sselect_hyperslab(vMemSpaceID, H5S_SELECT_SET, vMemStart, nullptr, vMemDim, nullptr) >= 0) {
+        vBlock.mIsValid = H5Dread(aHandle.mDataId, mHDFType, vMemSpaceID, aHandle.mDataSpaceId, H5P_DEFAULT, aDest) >= 0;
+      }
+      H5Sclose(vMemSpaceID);
+    }
   }
   else {
-    for (bpInt32 vF = 0; vF < vNumFilters; vF++) {
-      vFilters.push_back(H5Pget_filter2(vPlist, vF, nullptr, nullptr, nullptr, 0, nullptr, nullptr));
-    }
-    bool vIsShuffle = false;
-    if (vFilters.front() == H5Z_FILTER_SHUFFLE) {
-      vIsShuffle = true;
+    // strides that a memory space cannot describe, read compact and scatter
+    thread_local std::vector<TDataType> vBuffer;
+    vBuffer.resize(vMemDim[0] * vMemDim[1] * vMemDim[2]);
+    hid_t vMemSpaceID = H5Screate_simple(3, vMemDim, nullptr);
+    if (H5I_INVALID_HID < vMemSpaceID) {
+      vBlock.mIsValid = H5Dread(aHandle.mDataId, mHDFType, vMemSpaceID, aHandle.mDataSpaceId, H5P_DEFAULT, vBuffer.data()) >= 0;
+      H5Sclose(vMemSpaceID);
     }
-    bpSize vNumElements = 1;
-    bpUInt32 vCompressionLevel[1];
-    bpSize vAlgoIndex = 0;
-    if (vFilters.back() == H5Z_FILTER_DEFLATE) {
-      H5Pget_filter_by_id(vPlist, H5Z_FILTER_DEFLATE, nullptr, &vNumElements, vCompressionLevel, 0, nullptr, nullptr);
-      vAlgoIndex += (bpSize)vCompressionLevel[0];
-      if (vIsShuffle) {
-        vAlgoIndex += 9;
+    if (vBlock.mIsValid) {
+      const bpfUInt8* vSrc = reinterpret_cast<const bpfUInt8*>(vBuffer.data());
+      bpfSize vRowSize = (bpfSize)vMemDim[2];
+      bpfSize vDestTypeSize = aConverter ? aConverter->GetDestSize() : vTypeSize;
+      thread_local std::vector<bpfUInt8> vConvertedRow;
+      if (aConverter) {
+        vConvertedRow.resize(vRowSize * vDestTypeSize);
+      }
+      for (hsize_t vZ = 0; vZ < vMemDim[0]; ++vZ) {
+        for (hsize_t vY = 0; vY < vMemDim[1]; ++vY, vSrc += vRowSize * vTypeSize) {
+          bpfUInt8* vRow = aDest + vZ * aStride[0] + vY * aStride[1];
+          const bpfUInt8* vRowSrc = vSrc;
+          if (aConverter) {
+            bool vIsDenseRow = aStride[2] == vDestTypeSize;
+            aConverter->Convert(vSrc, vRowSize, vIsDenseRow ? vRow : vConvertedRow.data());
+            if (vIsDenseRow) {
+              continue;
+            }
+            vRowSrc = vConvertedRow.data();
+          }
+          for (bpfSize vX = 0; vX < vRowSize; ++vX) {
+            std::memcpy(vRow + vX * aStride[2], vRowSrc + vX * vDestTypeSize, vDestTypeSize);
+          }
+        }
       }
-      aCompressionAlgorithmType = vAlgorithmTypes[vAlgoIndex];
-    }
-    else if (vFilters.back() == H5Z_FILTER_LZ4) {
-      vAlgoIndex = (vIsShuffle) ? 20 : 19;
-      aCompressionAlgorithmType = vAlgorithmTypes[vAlgoIndex];
     }
   }
-  H5Pclose(vPlist);
-  H5Dclose(vDataId);
-  H5Gclose(vChannelId);
 
+  if (!vBlock.mIsValid) {
+    std::cout << "Fail!" << std::endl;
+  }
+  aBlocks.push_back(vBlock);
+}
 
-  H5Gclose(vTimeInfoId);
-  H5Gclose(vImageId);
-  H5Gclose(vDatasetInfoId);
-  H5Gclose(vTimePointZeroResZeroId);
-  H5Gclose(vResolutionZeroId);
-  H5Gclose(vDatasetId);
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::FillBlocks(const std::vector<cBlockRead>& aBlocks)
+{
+  for (const cBlockRead& vBlock : aBlocks) {
+    const hsize_t* vDim = vBlock.mDestDim;
+    hsize_t vValid[3] = { 0, 0, 0 };
+    if (vBlock.mIsValid) {
+      std::copy(vBlock.mValidDim, vBlock.mValidDim + 3, vValid);
+    }
+
+    // row tails, then the rows below the valid ones, then the slices behind them
+    FillRegion(vBlock.mDest, vBlock.mDestStride, { 0, 0, vValid[2] }, { vValid[0], vValid[1], vDim[2] }, vBlock.mFillValue, vBlock.mConverter);
+    FillRegion(vBlock.mDest, vBlock.mDestStride, { 0, vValid[1], 0 }, { vValid[0], vDim[1], vDim[2] }, vBlock.mFillValue, vBlock.mConverter);
+    FillRegion(vBlock.mDest, vBlock.mDestStride, { vValid[0], 0, 0 }, { vDim[0], vDim[1], vDim[2] }, vBlock.mFillValue, vBlock.mConverter);
+  }
 }
 
 
 template<typename TDataType>
-void bpImageReaderImpl<TDataType>::ReadParameters(tParameters& aParameters)
+bool bpImageReaderImpl<TDataType>::ReadBlockChunks(bpDataSetHandleCache::cHandle& aHandle, const bpChunkCache::cKey& aCacheKey, const hsize_t (&aExtent)[3], const hsize_t (&aStart)[3], const hsize_t (&aSize)[3], bpfUInt8* aDest, const bpfSize (&aStride)[3], TDataType aFillValue, const bpfDataConverter* aConverter, tChunkIndices& aChunkIndices, std::vector<cChunkRead>& aChunks, std::vector<cBlockRead>& aBlocks)
 {
-  bpfString vDirectoryName = GetDirectoryName(mDataSetInfoDirectoryName);
-  hid_t vDataSetInfoId = H5Gopen(mFileID, vDirectoryName.c_str(), H5P_DEFAULT);
+  if (!GetDecoder(aHandle).IsSupported()) {
+    return false;
+  }
 
-  hsize_t vNumberOfSections = 0;
-  H5Gget_num_objs(vDataSetInfoId, &vNumberOfSections);
-  ssize_t vSectionNameSize = 0;
-  bpfChar* vSectionName = nullptr;
-  hid_t vSectionId;
+  hsize_t vEnd[3];
+  for (bpfSize vIndex = 0; vIndex < 3; vIndex++) {
+    vEnd[vIndex] = std::max(aStart[vIndex], std::min(aStart[vIndex] + aSize[vIndex], aExtent[vIndex]));
+  }
 
-  // loop over sections
-  for (hsize_t vSectionIndex = 0; vSectionIndex < vNumberOfSections; ++vSectionIndex) {
-    if (H5Gget_objtype_by_idx(vDataSetInfoId, vSectionIndex) == H5G_GROUP) {
-      // get new section name
-      vSectionNameSize = H5Gget_objname_by_idx(vDataSetInfoId, vSectionIndex, nullptr, 0) + 1;
-      vSectionName = new bpfChar[vSectionNameSize];
-      bpfParameterSection* vParameterSection = new bpfParameterSection;
-      H5Gget_objname_by_idx(vDataSetInfoId, vSectionIndex, vSectionName, static_cast<bpfSize>(vSectionNameSize));
+  // everything outside of aExtent is filled by FillBlocks, the rest by DecodeChunks
+  aBlocks.push_back({ aDest, { aStride[0], aStride[1], aStride[2] }, { aSize[0], aSize[1], aSize[2] }, { vEnd[0] - aStart[0], vEnd[1] - aStart[1], vEnd[2] - aStart[2] }, true, aFillValue, aConverter });
+
+  thread_local std::vector<bpReadPlanner::cChunkBox> vBoxes;
+  vBoxes.clear();
+  bpReadPlanner::Plan(aHandle.mChunkDim, aExtent, aStart, aSize, vBoxes);
+
+  for (const bpReadPlanner::cChunkBox& vBox : vBoxes) {
+    cChunkTarget vTarget;
+    vTarget.mDest = aDest;
+    vTarget.mFillValue = aFillValue;
+    vTarget.mConverter = aConverter;
+    bpChunkCache::cKey vCacheKey = aCacheKey;
+    for (bpfSize vIndex = 0; vIndex < 3; vIndex++) {
+      vTarget.mBegin[vIndex] = vBox.mBegin[vIndex];
+      vTarget.mEnd[vIndex] = vBox.mEnd[vIndex];
+      vTarget.mDestStart[vIndex] = aStart[vIndex];
+      vTarget.mDestStride[vIndex] = aStride[vIndex];
+      vCacheKey.mChunkIndex[vIndex] = vBox.mChunkIndex[vIndex];
+    }
 
-      // open the group and read attributes
-      vSectionId = H5Gopen(vDataSetInfoId, vSectionName, H5P_DEFAULT);
-      ReadSection(vSectionId, vParameterSection, true);
-      H5Gclose(vSectionId);
+    // a chunk that an earlier block of this read already touched is decoded once for all
+    auto vIndexIt = aChunkIndices.find(vCacheKey);
+    if (vIndexIt != aChunkIndices.end()) {
+      aChunks[vIndexIt->second].mTargets.push_back(vTarget);
+      continue;
+    }
+    aChunkIndices[vCacheKey] = aChunks.size();
+
+    cChunkRead vRead;
+    vRead.mCacheKey = vCacheKey;
+    vRead.mDecoder = aHandle.mDecoder;
+    vRead.mTargets.push_back(vTarget);
+    for (bpfSize vIndex = 0; vIndex < 3; vIndex++) {
+      vRead.mChunkStart[vIndex] = vBox.mChunkStart[vIndex];
+      vRead.mChunkDim[vIndex] = aHandle.mChunkDim[vIndex];
+    }
 
-      auto vSectionIter = vParameterSection->Begin();
-      while (vSectionIter != vParameterSection->End()) {
-        aParameters[vSectionName].emplace(vSectionIter->first, vSectionIter->second);
-        vSectionIter++;
+    // unfiltered chunks are copied straight from the file mapping, caching them would only add a copy
+    vRead.mMapped = GetMappedChunk(aHandle, vBox.mChunkIndex);
+    if (vRead.mMapped) {
+      vRead.mIsValid = true;
+      aChunks.push_back(std::move(vRead));
+      continue;
+    }
+
+    if (mChunkCache.IsEnabled()) {
+      vRead.mDecoded = mChunkCache.Get(vRead.mCacheKey);
+      if (vRead.mDecoded) {
+        aChunks.push_back(std::move(vRead));
+        continue;
       }
+    }
 
-      delete vParameterSection;
-      delete[] vSectionName;
+    // chunks that were never written have no storage and read as the fill value of the dataset, as with H5Dread
+    haddr_t vAddress = HADDR_UNDEF;
+    hsize_t vStorageSize = 0;
+    unsigned int vFilterMask = 0;
+    herr_t vError = -1;
+    H5E_BEGIN_TRY {
+      vError = H5Dget_chunk_info_by_coord(aHandle.mDataId, vRead.mChunkStart, &vFilterMask, &vAddress, &vStorageSize);
+    } H5E_END_TRY;
+    vRead.mIsUnwritten = vError >= 0 && (vAddress == HADDR_UNDEF || vStorageSize == 0);
+    if (vError < 0 || vRead.mIsUnwritten) {
+      aChunks.push_back(std::move(vRead));
+      continue;
+    }
+    vRead.mRaw = mRawChunkPool.Get((bpfSize)vStorageSize);
+    if (mChunkStorage) {
+      vRead.mFilterMask = vFilterMask;
+      vRead.mIsDeferred = true;
+      vRead.mFileOffset = mUserBlockSize + vAddress;
+    }
+    else {
+      vRead.mIsValid = H5Dread_chunk(aHandle.mDataId, H5P_DEFAULT, vRead.mChunkStart, &vRead.mFilterMask, vRead.mRaw.data()) >= 0;
+    }
+    aChunks.push_back(std::move(vRead));
+  }
+  return true;
+}
+
+
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::ReadDeferredChunks(std::vector<cChunkRead>& aChunks)
+{
+  bpfReadCoalescer vCoalescer(mCoalesceGapBytes, mCoalesceMaxReadBytes);
+  std::vector<cChunkRead*> vDeferred;
+  for (cChunkRead& vRead : aChunks) {
+    if (vRead.mIsDeferred) {
+      vCoalescer.Add(vRead.mFileOffset, vRead.mRaw.size(), vRead.mRaw.data());
+      vDeferred.push_back(&vRead);
     }
   }
+  if (vDeferred.empty()) {
+    return;
+  }
 
-  H5Gclose(vDataSetInfoId);
+  std::vector<bool> vIsRead;
+  vCoalescer.Read(*mChunkStorage, vIsRead);
+  for (bpfSize vIndex = 0; vIndex < vDeferred.size(); ++vIndex) {
+    vDeferred[vIndex]->mIsValid = vIsRead[vIndex];
+    vDeferred[vIndex]->mIsDeferred = false;
+  }
 }
 
 
 template<typename TDataType>
-void bpImageReaderImpl<TDataType>::ReadData(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData)
+const bpfH5ChunkDecoder& bpImageReaderImpl<TDataType>::GetDecoder(bpDataSetHandleCache::cHandle& aHandle)
 {
-  bpSize vEndT = std::min(aEnd[T], GetSizeT(aResolutionIndex));
-  bpSize vEndC = std::min(aEnd[C], GetSizeC(aResolutionIndex));
-  hsize_t vStart[] = { aBegin[Z], aBegin[Y], aBegin[X]};
-  hsize_t vReadSizeDim[] = { aEnd[Z] - aBegin[Z], aEnd[Y] - aBegin[Y], aEnd[X] - aBegin[X] };
+  if (!aHandle.mDecoder) {
+    aHandle.mDecoder = bpfMakeSharedPtr<bpfH5ChunkDecoder>(aHandle.mDataId, mHDFType);
+  }
+  return *aHandle.mDecoder;
+}
 
-  bpfString vDirectoryName = GetDirectoryName(mDataSetDirectoryName);
-//  std::cerr << "Trying to open " << mFileID << " directory name: " << vDirectoryName << std::endl;
-  hid_t vDataSetID = H5Gopen(mFileID, vDirectoryName.c_str(), H5P_DEFAULT);
 
-  bpfString vResolutionLevel = "ResolutionLevel " + bpfToString(aResolutionIndex);
-  hid_t vLevelId = H5Gopen(vDataSetID, vResolutionLevel.c_str(), H5P_DEFAULT);
-  bpSize vSizeXYZ = vReadSizeDim[0] * vReadSizeDim[1] * vReadSizeDim[2];
-  bpSize vSizeXYZC = vSizeXYZ * (vEndC - aBegin[C]);
+template<typename TDataType>
+const bpfUInt8* bpImageReaderImpl<TDataType>::GetMappedChunk(bpDataSetHandleCache::cHandle& aHandle, const hsize_t (&aChunkIndex)[3])
+{
+  if (!mMappedFile || !mMappedFile->IsMapped()) {
+    return nullptr;
+  }
+  const bpfH5ChunkDecoder& vDecoder = GetDecoder(aHandle);
+  if (!vDecoder.IsSupported() || vDecoder.HasFilters()) {
+    return nullptr;
+  }
 
-  for (bpSize vIndexT = aBegin[T]; vIndexT < vEndT; ++vIndexT) {
-    bpSize vOffsetT = vSizeXYZC * (vIndexT - aBegin[T]);
+  auto vKey = std::make_tuple(aChunkIndex[0], aChunkIndex[1], aChunkIndex[2]);
+  auto vChunkIt = aHandle.mMappedChunks.find(vKey);
+  if (vChunkIt != aHandle.mMappedChunks.end()) {
+    return vChunkIt->second;
+  }
 
-    bpfString vTimePointStr = "TimePoint " + bpfToString(vIndexT);
-    hid_t vTimePointId = H5Gopen(vLevelId, vTimePointStr.c_str(), H5P_DEFAULT);
+  hsize_t vOffset[3];
+  bpfSize vChunkSize = sizeof(TDataType);
+  for (bpfSize vIndex = 0; vIndex < 3; vIndex++) {
+    vOffset[vIndex] = aChunkIndex[vIndex] * aHandle.mChunkDim[vIndex];
+    vChunkSize *= (bpfSize)aHandle.mChunkDim[vIndex];
+  }
 
-    for (bpSize vIndexC = aBegin[C]; vIndexC < vEndC; ++vIndexC) {
-      bpSize vOffsetC = vOffsetT + vSizeXYZ * (vIndexC - aBegin[C]);
+  // chunks that were never written have no address and are read through hdf5
+  unsigned int vFilterMask = 0;
+  haddr_t vAddress = HADDR_UNDEF;
+  hsize_t vStorageSize = 0;
+  herr_t vError = -1;
+  H5E_BEGIN_TRY {
+    vError = H5Dget_chunk_info_by_coord(aHandle.mDataId, vOffset, &vFilterMask, &vAddress, &vStorageSize);
+  } H5E_END_TRY;
+
+  const bpfUInt8* vChunk = nullptr;
+  if (vError >= 0 && vAddress != HADDR_UNDEF && vStorageSize == vChunkSize) {
+    vChunk = mMappedFile->GetData(mUserBlockSize + vAddress, vChunkSize);
+  }
+  aHandle.mMappedChunks[vKey] = vChunk;
+  return vChunk;
+}
 
-      bpfString vChannelStr = "Channel " + bpfToString(vIndexC);
-      hid_t vChannelId = H5Gopen(vTimePointId, vChannelStr.c_str(), H5P_DEFAULT);
 
-//      std::cerr << "Try open " << vTimePointStr << " " << vChannelStr << std::endl;
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::DecodeChunks(std::vector<cChunkRead>& aChunks, const bpReaderTypes::cCancellationToken* aToken)
+{
+  if (aChunks.empty()) {
+    return;
+  }
 
-      hid_t vDataId = H5Dopen(vChannelId, "Data", H5P_DEFAULT);
-      if (mSWMR) {
-        H5Drefresh(vDataId);
+  // chunks not started when the read is cancelled are skipped
+  if (mDecodePool) {
+    // with fewer chunks than threads (the caller helps), the idle threads decode the lz4 blocks of the chunks
+    bpfThreadPool* vBlockPool = aChunks.size() <= mDecodePool->GetNumberOfThreads() ? mDecodePool.get() : nullptr;
+    mDecodePool->ParallelFor(aChunks.size(), [this, &aChunks, aToken, vBlockPool](bpfSize aIndex) {
+      if (!aToken || !aToken->IsCancelled()) {
+        DecodeChunk(aChunks[aIndex], vBlockPool);
       }
-      H5Gclose(vChannelId);
+    });
+  }
+  else {
+    for (cChunkRead& vRead : aChunks) {
+      if (aToken && aToken->IsCancelled()) {
+        return;
+      }
+      DecodeChunk(vRead, nullptr);
+    }
+  }
+}
 
-      hid_t vDataSetSpaceID = H5Dget_space(vDataId);
-      hsize_t vMemDim[3] = { vReadSizeDim[0], vReadSizeDim[1], vReadSizeDim[2] };
 
-      hsize_t vFileDim[] = { GetSizeZ(aResolutionIndex), GetSizeY(aResolutionIndex), GetSizeX(aResolutionIndex) };
-      H5Sget_simple_extent_dims(vDataSetSpaceID, vFileDim, nullptr);
+template<typename TDataType>
+void bpImageReaderImpl<TDataType>::DecodeChunk(cChunkRead& aRead, bpfThreadPool* aThreadPool)
+{
+  bpfSize vChunkSize = (bpfSize)(aRead.mChunkDim[0] * aRead.mChunkDim[1] * aRead.mChunkDim[2]) * sizeof(TDataType);
+
+  std::vector<bpfH5ChunkDecoder::cRegion> vRegions(aRead.mTargets.size());
+  for (bpfSize vTarget = 0; vTarget < vRegions.size(); ++vTarget) {
+    const cChunkTarget& vChunkTarget = aRead.mTargets[vTarget];
+    bpfH5ChunkDecoder::cRegion& vRegion = vRegions[vTarget];
+    vRegion.mDest = vChunkTarget.mDest;
+    vRegion.mConverter = vChunkTarget.mConverter;
+    for (bpfSize vIndex = 0; vIndex < 3; vIndex++) {
+      vRegion.mChunkDim[vIndex] = (bpfSize)aRead.mChunkDim[vIndex];
+      vRegion.mBegin[vIndex] = (bpfSize)(vChunkTarget.mBegin[vIndex] - aRead.mChunkStart[vIndex]);
+      vRegion.mEnd[vIndex] = (bpfSize)(vChunkTarget.mEnd[vIndex] - aRead.mChunkStart[vIndex]);
+      vRegion.mDestStride[vIndex] = vChunkTarget.mDestStride[vIndex];
+      vRegion.mDest += (vChunkTarget.mBegin[vIndex] - vChunkTarget.mDestStart[vIndex]) * vChunkTarget.mDestStride[vIndex];
+    }
+  }
 
-      for (bpfSize vIndex = 0; vIndex < 3; vIndex++) {
-        if (vStart[vIndex] + vMemDim[vIndex] > vFileDim[vIndex]) {
-          vMemDim[vIndex] = vFileDim[vIndex] - vStart[vIndex];
+  bool vIsDecoded = false;
+  if (!aRead.mDecoded && !aRead.mMapped && aRead.mIsValid) {
+    if (mChunkCache.IsEnabled() || vRegions.size() > 1) {
+      // decoded once and copied to every target
+      auto vChunk = bpfMakeSharedPtr<std::vector<bpfUInt8>>(vChunkSize);
+      if (aRead.mDecoder->Decode(aRead.mRaw.data(), aRead.mRaw.size(), aRead.mFilterMask, vChunk->data(), vChunkSize, aThreadPool)) {
+        // keeps the chunk alive below even if the cache drops it right away
+        aRead.mDecoded = vChunk;
+        if (mChunkCache.IsEnabled()) {
+          mChunkCache.Insert(aRead.mCacheKey, std::move(vChunk));
         }
       }
+    }
+    else {
+      vIsDecoded = aRead.mDecoder->DecodeRegion(aRead.mRaw.data(), aRead.mRaw.size(), aRead.mFilterMask, vRegions[0], aThreadPool);
+    }
+  }
+  mRawChunkPool.Put(std::move(aRead.mRaw));
 
-      H5Sselect_hyperslab(vDataSetSpaceID, H5S_SELECT_SET, vStart, nullptr, vMemDim, nullptr);
-      hid_t vMemSpaceID = H5Screate_simple(3, vMemDim, nullptr);
+  // a full decoded or mapped chunk is stored without filters
+  const bpfUInt8* vChunk = aRead.mMapped ? aRead.mMapped : aRead.mDecoded ? aRead.mDecoded->data() : nullptr;
+  for (bpfSize vTarget = 0; vTarget < vRegions.size(); ++vTarget) {
+    if (vChunk) {
+      vIsDecoded = aRead.mDecoder->DecodeRegion(vChunk, vChunkSize, ~0u, vRegions[vTarget]);
+    }
 
-      herr_t vError = -1;
-      if (H5I_INVALID_HID < vMemSpaceID) {
-        vError = H5Dread(vDataId, mHDFType, vMemSpaceID, vDataSetSpaceID, H5P_DEFAULT, aData + vOffsetC);
-        H5Sclose(vMemSpaceID);
-//        std::cout << "Success! " << vError << std::endl;
+    if (!vIsDecoded) {
+      const cChunkTarget& vChunkTarget = aRead.mTargets[vTarget];
+      hsize_t vBegin[3];
+      hsize_t vEnd[3];
+      for (bpfSize vIndex = 0; vIndex < 3; vIndex++) {
+        vBegin[vIndex] = vChunkTarget.mBegin[vIndex] - vChunkTarget.mDestStart[vIndex];
+        vEnd[vIndex] = vChunkTarget.mEnd[vIndex] - vChunkTarget.mDestStart[vIndex];
       }
-      bpSize vCountMem = vMemDim[0] * vMemDim[1] * vMemDim[2];
-      if (vError < 0) {
-        hid_t vTypeID = H5Dget_type(vDataId);
-        if (H5I_INVALID_HID < vTypeID) {
-          bpSize vTypeSize = H5Tget_size(vTypeID);
-          std::memset(aData + vOffsetC, 0, vCountMem * vTypeSize);
-          H5Tclose(vTypeID);
-          std::cout << "Fail!" << std::endl;
-        }
+      // the caller's fill value is only for voxels outside of the image, and for chunks that failed to read
+      TDataType vFillValue = vChunkTarget.mFillValue;
+      if (aRead.mIsUnwritten) {
+        std::memcpy(&vFillValue, aRead.mDecoder->GetFillValue(), sizeof(TDataType));
       }
+      FillRegion(vChunkTarget.mDest, vChunkTarget.mDestStride, vBegin, vEnd, vFillValue, vChunkTarget.mConverter);
+    }
+  }
+  aRead.mDecoded.reset();
+}
 
-      H5Sclose(vDataSetSpaceID);
-      H5Dclose(vDataId);
 
-      // revert notation for dimension sequence from hdf to bitplane
-      hsize_t vMemDim_[3] = { vMemDim[2], vMemDim[1], vMemDim[0] };
-      hsize_t vReadSizeDim_[3] = { vReadSizeDim[2], vReadSizeDim[1], vReadSizeDim[0] };
-      FixPadding((bpfChar*)(aData + vOffsetC), vMemDim_, vReadSizeDim_, bpfGetSizeOfType(mType));
-    }
+template<typename TDataType>
+bpReaderTypes::cChunkCacheStatistics bpImageReaderImpl<TDataType>::GetChunkCacheStatistics()
+{
+  return mChunkCache.GetStatistics();
+}
 
-    H5Gclose(vTimePointId);
-  }
 
-  H5Gclose(vLevelId);
-  H5Gclose(vDataSetID);
+template<typename TDataType>
+std::vector<bpReaderTypes::cReadPlanItem> bpImageReaderImpl<TDataType>::PlanRead(const tIndex5D& aBegin, const tIndex5D& aEnd, bpSize aResolutionIndex)
+{
+  bpSize vEndT = std::min(aEnd[T], GetSizeT(aResolutionIndex));
+  bpSize vEndC = std::min(aEnd[C], GetSizeC(aResolutionIndex));
+  hsize_t vStart[] = { aBegin[Z], aBegin[Y], aBegin[X] };
+  hsize_t vSize[] = { aEnd[Z] - aBegin[Z], aEnd[Y] - aBegin[Y], aEnd[X] - aBegin[X] };
+  tSize5D vStrides = GetDenseByteStrides(aBegin, aEnd, aResolutionIndex);
+  bpSize vStride[] = { vStrides[Z] / sizeof(TDataType), vStrides[Y] / sizeof(TDataType), vStrides[X] / sizeof(TDataType) };
+
+  bpfString vDirectoryName = GetDirectoryName(mDataSetDirectoryName);
+  std::vector<bpReaderTypes::cReadPlanItem> vItems;
+  std::vector<bpReadPlanner::cChunkBox> vBoxes;
+  for (bpSize vIndexT = aBegin[T]; vIndexT < vEndT; ++vIndexT) {
+    for (bpSize vIndexC = aBegin[C]; vIndexC < vEndC; ++vIndexC) {
+      bpDataSetHandleCache::cHandle* vHandle = mDataSetHandleCache.Get(mFileID, vDirectoryName, { aResolutionIndex, vIndexT, vIndexC });
+      if (vHandle && mSWMR && !mDataSetHandleCache.Refresh(*vHandle)) {
+        vHandle = nullptr;
+      }
+      if (!vHandle) {
+        continue;
+      }
+
+      // a dataset that is not chunked is planned as a single chunk
+      hsize_t vExtent[3];
+      hsize_t vChunkDim[3];
+      for (bpfSize vIndex = 0; vIndex < 3; vIndex++) {
+        vExtent[vIndex] = vHandle->mFileDim[vIndex];
+        if (!mSWMR && aResolutionIndex < mSizeX.size()) {
+          bpfSize vImageSize = vIndex == 0 ? GetSizeZ(aResolutionIndex) : vIndex == 1 ? GetSizeY(aResolutionIndex) : GetSizeX(aResolutionIndex);
+          vExtent[vIndex] = std::min<hsize_t>(vExtent[vIndex], vImageSize);
+        }
+        vChunkDim[vIndex] = vHandle->mChunkDim[vIndex] > 0 ? vHandle->mChunkDim[vIndex] : std::max<hsize_t>(vHandle->mFileDim[vIndex], 1);
+      }
+
+      vBoxes.clear();
+      bpReadPlanner::Plan(vChunkDim, vExtent, vStart, vSize, vBoxes);
+
+      bpSize vBlockOffset = (vStrides[T] * (vIndexT - aBegin[T]) + vStrides[C] * (vIndexC - aBegin[C])) / sizeof(TDataType);
+      for (const bpReadPlanner::cChunkBox& vBox : vBoxes) {
+        bpReaderTypes::cReadPlanItem vItem;
+        vItem.mTimePointIndex = vIndexT;
+        vItem.mChannelIndex = vIndexC;
+        vItem.mDestinationOffset = vBlockOffset;
+        for (bpfSize vIndex = 0; vIndex < 3; vIndex++) {
+          // hdf5 order to [x, y, z]
+          vItem.mChunkIndex[2 - vIndex] = (bpSize)vBox.mChunkIndex[vIndex];
+          vItem.mChunkSize[2 - vIndex] = (bpSize)vChunkDim[vIndex];
+          vItem.mBegin[2 - vIndex] = (bpSize)vBox.mBegin[vIndex];
+          vItem.mEnd[2 - vIndex] = (bpSize)vBox.mEnd[vIndex];
+          vItem.mDestinationOffset += (bpSize)(vBox.mBegin[vIndex] - vStart[vIndex]) * vStride[vIndex];
+        }
+        vItems.push_back(vItem);
+      }
+    }
+  }
+  return vItems;
 }
 
+
 template<typename TDataType>
 bpImageReaderBaseInterface::cHistogram bpImageReaderImpl<TDataType>::ReadHistogram(const bpVec3& aIndexTCR)
 {
@@ -412,10 +1473,10 @@ bpImageReaderBaseInterface::cHistogram bpImageReaderImpl<TDataType>::ReadHistogr
   if (H5Lexists(vChannelId, "Histogram1024", H5P_DEFAULT) > 0) {
     vSuffix = "1024";
   }
-  ReadAttributeString((bpfString("HistogramMin") + vSuffix).c_str(), vHistMin, vChannelId);
-  ReadAttributeString((bpfString("HistogramMax") + vSuffix).c_str(), vHistMax, vChannelId);
-  bpfFromString(vHistMin, vHistogram.mMin);
-  bpfFromString(vHistMax, vHistogram.mMax);
+  bpfH5ReadAttributeString((bpfString("HistogramMin") + vSuffix).c_str(), vHistMin, vChannelId);
+  bpfH5ReadAttributeString((bpfString("HistogramMax") + vSuffix).c_str(), vHistMax, vChannelId);
+  ParseValue(vHistMin, vHistogram.mMin);
+  ParseValue(vHistMax, vHistogram.mMax);
   hid_t vHistogramId = H5Dopen(vChannelId, (bpfString("Histogram") + vSuffix).c_str(), H5P_DEFAULT);
   // get the dataspace and number of elements in dataset
   hid_t vHistogramDataspace = H5Dget_space(vHistogramId);
@@ -506,7 +1567,7 @@ herr_t bpImageReaderImpl<TDataType>::ReadSectionParameter(hid_t aSectionId, cons
 {
   bpfString vAttributeValue = "";
 
-  if (!ReadAttributeString(aAttributeName, vAttributeValue, aSectionId)) {
+  if (!bpfH5ReadAttributeString(aAttributeName, vAttributeValue, aSectionId)) {
     // failed to read attribute
     return 1;
   }
@@ -559,83 +1620,6 @@ herr_t bpImageReaderImpl<TDataType>::ReadSectionLongParameter(hid_t aSectionId,
 }
 
 
-template<typename TDataType>
-bool bpImageReaderImpl<TDataType>::ReadAttributeString(const bpfString aAttributeName, bpfString& aAttributeValue, const hid_t& aAttributeLocation)
-{
-  auto vExists = H5Aexists(aAttributeLocation, aAttributeName.c_str());
-
-  if (vExists <= 0) {
-    BP_DEBUG_MSG("ReadAttribute() - Could not find attribute with name: " + aAttributeName);
-    return false;
-  }
-
-  hid_t vAttributeId = H5Aopen_by_name(aAttributeLocation, ".", aAttributeName.c_str(), H5P_DEFAULT, H5P_DEFAULT);
-
-  if (vAttributeId < 0) {
-    BP_DEBUG_MSG("ReadAttribute() - Could not find attribute with name: " + aAttributeName);
-    return false;
-  }
-
-  hid_t vAttributeTypeId = H5Aget_type(vAttributeId);
-
-  if (vAttributeTypeId < 0) {
-    H5Aclose(vAttributeId);
-    BP_DEBUG_MSG("ReadAttribute() - Could not get datatype from attribute" + aAttributeName);
-    return false;
-  }
-
-  hid_t vAttributeSpaceId = H5Aget_space(vAttributeId);
-
-  if (vAttributeSpaceId < 0) {
-    H5Tclose(vAttributeTypeId);
-    H5Aclose(vAttributeId);
-    BP_DEBUG_MSG("ReadAttribute() - Could not get dataspace from attribute" + aAttributeName);
-    return false;
-  }
-
-  bpfInt32 vAttributeRank = H5Sget_simple_extent_ndims(vAttributeSpaceId);
-
-  if (vAttributeRank != 1) {
-    H5Sclose(vAttributeSpaceId);
-    H5Tclose(vAttributeTypeId);
-    H5Aclose(vAttributeId);
-    BP_DEBUG_MSG("ReadAttribute() - Dataspace rank of attribute " + aAttributeName + " is not 1!");
-    return false;
-  }
-
-  hsize_t vAttributeSize = 0;
-
-  if (H5Sget_simple_extent_dims(vAttributeSpaceId, &vAttributeSize, nullptr) < 0) {
-    H5Sclose(vAttributeSpaceId);
-    H5Tclose(vAttributeTypeId);
-    H5Aclose(vAttributeId);
-    BP_DEBUG_MSG("ReadAttribute() - Could not get size of attribute " + aAttributeName);
-    return false;
-  }
-
-  bpfChar* vBuffer = new bpfChar[(bpfSize)vAttributeSize + 1];
-  vBuffer[vAttributeSize] = '\0';
-
-  if (H5Aread(vAttributeId, vAttributeTypeId, vBuffer) < 0) {
-    delete[] vBuffer;
-    H5Sclose(vAttributeSpaceId);
-    H5Tclose(vAttributeTypeId);
-    H5Aclose(vAttributeId);
-    BP_DEBUG_MSG("ReadAttribute() - Could not read attribute " + aAttributeName + "!");
-    return false;
-  }
-
-  aAttributeValue = vBuffer;
-
-  delete[] vBuffer;
-  H5Sclose(vAttributeSpaceId);
-  H5Tclose(vAttributeTypeId);
-  H5Aclose(vAttributeId);
-
-  return true;
-}
-
-
 template<typename TDataType>
 bpfString bpImageReaderImpl<TDataType>::DecodeName(bpfString aName)
 {
@@ -742,17 +1726,17 @@ bool bpImageReaderImpl<TDataType>::ReadProperties()
 
     // set size information
     std::vector<bpfString> vImageSizeStrings{"", "", ""};
-    ReadAttributeString("ImageSizeX", vImageSizeStrings[0], vChannelId);
-    ReadAttributeString("ImageSizeY", vImageSizeStrings[1], vChannelId);
-    ReadAttributeString("ImageSizeZ", vImageSizeStrings[2], vChannelId);
+    bpfH5ReadAttributeString("ImageSizeX", vImageSizeStrings[0], vChannelId);
+    bpfH5ReadAttributeString("ImageSizeY", vImageSizeStrings[1], vChannelId);
+    bpfH5ReadAttributeString("ImageSizeZ", vImageSizeStrings[2], vChannelId);
     if (vResolutionIndex >= mSizeX.size()) {
       mSizeX.resize(vResolutionIndex + 1);
       mSizeY.resize(vResolutionIndex + 1);
       mSizeZ.resize(vResolutionIndex + 1);
     }
-    bpfFromString(vImageSizeStrings[0], mSizeX[vResolutionIndex]);
-    bpfFromString(vImageSizeStrings[1], mSizeY[vResolutionIndex]);
-    bpfFromString(vImageSizeStrings[2], mSizeZ[vResolutionIndex]);
+    ParseValue(vImageSizeStrings[0], mSizeX[vResolutionIndex]);
+    ParseValue(vImageSizeStrings[1], mSizeY[vResolutionIndex]);
+    ParseValue(vImageSizeStrings[2], mSizeZ[vResolutionIndex]);
 
     H5Gclose(vChannelId);
   }
@@ -763,102 +1747,21 @@ bool bpImageReaderImpl<TDataType>::ReadProperties()
 
 
 template<typename TDataType>
-bool bpImageReaderImpl<TDataType>::IsFormat()
+bool bpImageReaderImpl<TDataType>::IsFormat(const bpReaderTypes::cReadOptions& aOptions)
 {
-  // std::cout << "Fileid1: " << mFileID << std::endl;
-  if (mFileID != 0) {
+  if (mFile) {
     // file is already open...
     return true;
   }
 
-  if (!bpfFileTools::FileExists(GetFileName())) {
-    return false;
-  }
-
-  // test if file is a hdf5 format file
-  if (H5Fis_hdf5(bpfFileTools::AddExtendedPathPrefix(GetFileName()).c_str()) == 0) {
-    BP_DEBUG_MSG("IsFormat() - Not a HDF5 file format!");
-    return false;
-  }
-
-  // open the file
-  if (mSWMR) {
-    mFileID = H5Fopen(bpfFileTools::AddExtendedPathPrefix(GetFileName()).c_str(), H5F_ACC_RDONLY | H5F_ACC_SWMR_READ, H5P_DEFAULT);
-  }
-  else {
-    mFileID = H5Fopen(bpfFileTools::AddExtendedPathPrefix(GetFileName()).c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
-  }
-
-  if (mFileID < 0) {
-    // could not open the file
-    BP_DEBUG_MSG("IsFormat() - Could not open the file!");
-    return false;
-  }
-
-  // open the root group
-  hid_t vRootId = H5Gopen(mFileID, "/", H5P_DEFAULT);
-
-  if (vRootId < 0) {
-    // could not open the group
-    CloseFile();
-    BP_DEBUG_MSG("IsFormat() - Could not open root group in file!");
-    return false;
-  }
-
-  // look for some attributes
-  if (H5Aget_num_attrs(vRootId) <= 0) {
-    // operation failed
-    H5Gclose(vRootId);
-    CloseFile();
-    BP_DEBUG_MSG("IsFormat() - Could not find any attributes in root group!");
-    return false;
-  }
-
-  // look for file format version
-  bpfString vAttributeValue = "";
-
-  if (!ReadAttributeString("ImarisVersion", vAttributeValue, vRootId)) {
-    // operation failed
-    H5Gclose(vRootId);
-    CloseFile();
-    BP_DEBUG_MSG("IsFormat() - Could not read attributes in root group!");
-    return false;
-  }
-
-  if (vAttributeValue != "5.5.0") {
-    // wrong file format
-    H5Gclose(vRootId);
-    CloseFile();
-    BP_DEBUG_MSG("IsFormat() - Could not read attributes in root group!");
-    return false;
-  }
-
-  if (H5Aexists(vRootId, "NumberOfDataSets")) {
-    hid_t vAttr = H5Aopen_name(vRootId, "NumberOfDataSets");
-    bpfUInt32 vNumberOfDataSets = 1;
-    H5Aread(vAttr, H5T_NATIVE_UINT32, &vNumberOfDataSets);
-    mNumberOfDataSets = vNumberOfDataSets;
-    H5Aclose(vAttr);
-  }
-
-  if (!ReadAttributeString("ImarisDataSet", vAttributeValue, vRootId)) {
-    // operation failed
-    H5Gclose(vRootId);
-    CloseFile();
-    BP_DEBUG_MSG("IsFormat() - Could not read attributes in root group!");
-    return false;
-  }
-
-  if (vAttributeValue != "ImarisDataSet") {
-    // it is an encoded file or there is some other problem
-    H5Gclose(vRootId);
-    CloseFile();
-    BP_DEBUG_MSG("IsFormat() - Invalid attribute content!");
+  // shared with GetFileImagesInformation and the other readers of the file
+  mFile = bpFileRegistry::GetInstance().Open(GetFileName(), aOptions);
+  if (!mFile) {
     return false;
   }
 
-  H5Gclose(vRootId);
-
+  mFileID = mFile->GetId();
+  mNumberOfDataSets = mFile->GetNumberOfDataSets();
   return true;
 }
 
@@ -866,10 +1769,8 @@ bool bpImageReaderImpl<TDataType>::IsFormat()
 template<typename TDataType>
 void bpImageReaderImpl<TDataType>::CloseFile()
 {
-  if (mFileID > 0) {
-    H5Fclose(mFileID);
-  }
-
+  // the file is closed with its last handle
+  mFile.reset();
   mFileID = 0;
 }
 
@@ -20,16 +20,31 @@
 
 
 #include "ImarisReader/interface/bpImageReaderInterface.h"
+#include "ImarisReader/interface/bpStorageInterface.h"
 #include "ImarisReader/types/bpfParameterSection.h"
+#include "ImarisReader/reader/bpDataSetHandleCache.h"
+#include "ImarisReader/reader/bpChunkCache.h"
+#include "ImarisReader/reader/bpBufferPool.h"
+#include "ImarisReader/reader/bpImageMetadata.h"
+#include "ImarisReader/reader/bpFileRegistry.h"
+#include "ImarisReader/utils/bpfThreadPool.h"
+#include "ImarisReader/utils/bpfMemoryMappedFile.h"
+#include "ImarisReader/utils/bpfDataConverter.h"
+#include "ImarisReader/utils/bpfRGBACompositor.h"
 
 #include "hdf5.h"
 
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <tuple>
+
 
 template<typename TDataType>
 class bpImageReaderImpl : public bpImageReaderInterface<TDataType>
 {
 public:
-  bpImageReaderImpl(const bpString& aInputFile, bpSize aImageIndex, const bpReaderTypes::cReadOptions& aOptions);
+  bpImageReaderImpl(const bpString& aInputFile, bpSize aImageIndex, const bpReaderTypes::cReadOptions& aOptions, bpfSharedPtr<std::mutex> aIOMutex = nullptr);
 
   ~bpImageReaderImpl();
 
@@ -43,30 +58,107 @@ public:
     bpConverterTypes::tCompressionAlgorithmType& aCompressionAlgorithmType) override;
 
   
+  void ReadMetadata(
+    bpReaderTypes::tMetadataFields aFields,
+    std::vector<bpConverterTypes::tSize5D>& aImageSizePerResolution,
+    std::vector<bpConverterTypes::tSize5D>& aFileBlockSizePerResolution,
+    bpConverterTypes::cImageExtent& aImageExtent,
+    bpConverterTypes::tTimeInfoVector& aTimeInfoPerTimePoint,
+    bpConverterTypes::tColorInfoVector& aColorInfoPerChannel,
+    bpConverterTypes::tCompressionAlgorithmType& aCompressionAlgorithmType) override;
+
+  
   void ReadParameters(bpConverterTypes::tParameters& aParameters) override;
 
   
   void ReadData(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData) override;
 
   
+  void ReadData(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData, const bpConverterTypes::tSize5D& aByteStrides, TDataType aFillValue) override;
+
+  
+  void ReadDataBatch(const std::vector<typename bpImageReaderInterface<TDataType>::cReadRequest>& aRequests) override;
+
+  
+  const TDataType* ReadDataView(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex) override;
+
+  
+  void ReadDataConverted(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpFloat* aData, bpFloat aScale, bpFloat aOffset) override;
+
+  
+  void ReadDataConverted(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpReaderTypes::cFloat16* aData, bpFloat aScale, bpFloat aOffset) override;
+
+  
+  void ReadDataConverted(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, bpFloat aScale, bpFloat aOffset) override;
+
+  
+  void ReadDataDisplay(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, const bpConverterTypes::tColorInfoVector& aColorInfoPerChannel) override;
+  void ReadDataRGBA(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpUInt8* aData, const bpConverterTypes::tColorInfoVector& aColorInfoPerChannel) override;
+
+  
+  std::future<bpReaderTypes::tReadStatus> ReadDataAsync(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData,
+    bpReaderTypes::tReadPriority aPriority, const bpReaderTypes::cCancellationToken& aToken) override;
+
+  
+  void ReadDataAsync(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, TDataType* aData,
+    typename bpImageReaderInterface<TDataType>::tReadCallback aCallback, bpReaderTypes::tReadPriority aPriority, const bpReaderTypes::cCancellationToken& aToken) override;
+
+  
   bpImageReaderBaseInterface::cHistogram ReadHistogram(const bpVec3& aIndexTCR) override;
 
   
   bpImageReaderBaseInterface::cThumbnail ReadThumbnail() override;
 
-private:
+  
+  bpReaderTypes::cChunkCacheStatistics GetChunkCacheStatistics() override;
+
+  
+  std::vector<bpReaderTypes::cReadPlanItem> PlanRead(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex) override;
 
-  bool IsFormat();
+private:
+  struct cRequest;
+  struct cBlockRead;
+  struct cChunkTarget;
+  struct cChunkRead;
+
+  // index into the chunks of one read by cache key, to decode each chunk once
+  using tChunkIndices = std::map<bpChunkCache::cKey, bpfSize>;
+
+  bpConverterTypes::tSize5D GetDenseByteStrides(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpfSize aTypeSize = sizeof(TDataType)) const;
+  bpfSharedPtr<const bpfDataConverter> GetDisplayConverter(const bpConverterTypes::cColorInfo& aColorInfo);
+  // the ReadDataRGBA table of aColorInfo, shared by the calls with the same color info
+  bpfSharedPtr<const bpfRGBAChannelTable> GetRGBAChannelTable(const bpConverterTypes::cColorInfo& aColorInfo);
+  void ReadConverted(const bpConverterTypes::tIndex5D& aBegin, const bpConverterTypes::tIndex5D& aEnd, bpSize aResolutionIndex, bpfUInt8* aData, bpfDataConverter::tType aType, bpfFloat aScale, bpfFloat aOffset);
+  bool ReadRequests(const std::vector<cRequest>& aRequests, const bpReaderTypes::cCancellationToken* aToken = nullptr);
+  bpReaderTypes::tReadStatus ReadQueued(const cRequest& aRequest, const bpReaderTypes::cCancellationToken& aToken);
+  bpfThreadPool& GetAsyncPool();
+  void ReadBlock(bpDataSetHandleCache::cHandle& aHandle, const hsize_t (&aExtent)[3], const hsize_t (&aStart)[3], const hsize_t (&aSize)[3], bpfUInt8* aDest, const bpfSize (&aStride)[3], TDataType aFillValue, const bpfDataConverter* aConverter, std::vector<cBlockRead>& aBlocks);
+  bool ReadBlockChunks(bpDataSetHandleCache::cHandle& aHandle, const bpChunkCache::cKey& aCacheKey, const hsize_t (&aExtent)[3], const hsize_t (&aStart)[3], const hsize_t (&aSize)[3], bpfUInt8* aDest, const bpfSize (&aStride)[3], TDataType aFillValue, const bpfDataConverter* aConverter, tChunkIndices& aChunkIndices, std::vector<cChunkRead>& aChunks, std::vector<cBlockRead>& aBlocks);
+  void FillBlocks(const std::vector<cBlockRead>& aBlocks);
+  const bpfH5ChunkDecoder& GetDecoder(bpDataSetHandleCache::cHandle& aHandle);
+  const bpfUInt8* GetMappedChunk(bpDataSetHandleCache::cHandle& aHandle, const hsize_t (&aChunkIndex)[3]);
+  void ReadDeferredChunks(std::vector<cChunkRead>& aChunks);
+  void DecodeChunks(std::vector<cChunkRead>& aChunks, const bpReaderTypes::cCancellationToken* aToken);
+  // aThreadPool decodes the lz4 blocks of the chunk, if set
+  void DecodeChunk(cChunkRead& aRead, bpfThreadPool* aThreadPool);
+
+  bool IsFormat(const bpReaderTypes::cReadOptions& aOptions);
   void CloseFile();
   const bpfString& GetFileName() const;
 
   static bool ReadSection(const hid_t& aSectionId, bpfParameterSection* aParameterSection, bool aReadLongParameters);
   static herr_t ReadSectionParameter(hid_t aSectionId, const char* aAttributeName, void* aParameterSection);
   static herr_t ReadSectionLongParameter(hid_t aSectionId, const char* aAttributeName, const H5L_info_t* aLinkInfo, void* aParameterSection);
-  static bool ReadAttributeString(const bpfString aAttributeName, bpfString& aAttributeValue, const hid_t& aAttributeLocation);
+  static void ReadTimePoint(hid_t aTimeInfoId, const char* aAttributeName, bpConverterTypes::cTimeInfo& aTimeInfo);
   static bpfString DecodeName(bpfString aName);
 
   bool ReadProperties();
+  bpImageMetadata BuildMetadata();
+  std::vector<bpConverterTypes::tSize5D> ReadFileBlockSizes();
+  bpConverterTypes::cImageExtent ReadImageExtent();
+  bpConverterTypes::tCompressionAlgorithmType ReadCompressionAlgorithmType();
+  bpConverterTypes::tTimeInfoVector ReadTimeInfo();
+  bpConverterTypes::tColorInfoVector ReadColorInfo();
 
   bpfSize GetActiveDatasetIndex();
   bpfString GetDirectoryName(const bpfString& aDirectoryName);
@@ -78,6 +170,7 @@ private:
   bpfSize GetSizeC(bpfSize aResolutionLevel) const;
 
   bpfString mFileName;
+  bpFileRegistry::tFile mFile;
   hid_t mFileID;
   bool mSWMR;
 
@@ -91,8 +184,47 @@ private:
   bpfNumberType mType;
   hid_t mHDFType;
 
+  // built by the constructor, rebuilt by ReadMetadata with SWMR
+  bpImageMetadata mMetadata;
+
   bpfSize mNumberOfDataSets;
   bpfSize mActiveDataSetIndex;
+
+  bpDataSetHandleCache mDataSetHandleCache;
+  bpChunkCache mChunkCache;
+  bpfUniquePtr<bpfThreadPool> mDecodePool;
+  // raw chunk buffers of H5Dread_chunk and the coalesced reads, reused between reads
+  bpBufferPool mRawChunkPool;
+
+  // serializes the hdf5 calls of ReadData with the other methods if mConcurrentReadData is set
+  bool mConcurrentReadData;
+  bpfSharedPtr<std::mutex> mIOMutex;
+
+  // read-only mapping of the file for unfiltered chunks, hdf5 addresses start after the user block
+  bpfUniquePtr<bpfMemoryMappedFile> mMappedFile;
+  hsize_t mUserBlockSize;
+
+  // with mCoalesceChunkReads, raw chunks are read from here by offset instead of with H5Dread_chunk
+  bpfSharedPtr<bpStorageInterface> mChunkStorage;
+  bpfSize mCoalesceGapBytes;
+  bpfSize mCoalesceMaxReadBytes;
+
+  // reads of shuffled datasets use the raw chunk path instead of H5Dread
+  bool mUnshuffleIntoDestination;
+
+  // runs ReadDataAsync requests, started on first use
+  bpfUniquePtr<bpfThreadPool> mAsyncPool;
+  std::once_flag mAsyncPoolOnce;
+  bpfSize mNumberOfAsyncThreads;
+  // queued requests are dropped once the reader is being destroyed
+  std::atomic<bool> mIsClosing;
+
+  // display window lookup tables by (range min, range max, gamma)
+  std::map<std::tuple<bpfFloat, bpfFloat, bpfFloat>, bpfSharedPtr<const bpfDataConverter>> mDisplayConverters;
+  std::mutex mDisplayConvertersMutex;
+  // ReadDataRGBA lookup tables by the fields of the color info
+  std::map<std::vector<bpfFloat>, bpfSharedPtr<const bpfRGBAChannelTable>> mRGBAChannelTables;
+  std::mutex mRGBAChannelTablesMutex;
 };
 
 #endif // __BP_FILE_READER_IMPL__
@@ -0,0 +1,213 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#include "ImarisReader/interface/bpImageReaderPool.h"
+
+#include "ImarisReader/types/bpfTypes.h"
+
+#include <chrono>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+
+class bpImageReaderPool::cCache : public std::enable_shared_from_this<bpImageReaderPool::cCache>
+{
+public:
+  using tReader = bpSharedPtr<bpImageReaderBaseInterface>;
+  using tOpen = std::function<tReader()>;
+
+  cCache(bpSize aMaxOpenReaders, const bpReaderTypes::cReadOptions& aOptions)
+    : mMaxOpenReaders(aMaxOpenReaders),
+      mOptions(aOptions)
+  {
+  }
+
+  const bpReaderTypes::cReadOptions& GetOptions() const
+  {
+    return mOptions;
+  }
+
+  tReader Get(const bpString& aInputFile, bpSize aImageIndex, bpfNumberType aType, const tOpen& aOpen)
+  {
+    const tKey vKey(aInputFile, aImageIndex, aType);
+    {
+      tLock vLock(mMutex);
+      auto vIndexIt = mIndex.find(vKey);
+      if (vIndexIt != mIndex.end()) {
+        mEntries.splice(mEntries.begin(), mEntries, vIndexIt->second);
+        ++mStatistics.mHits;
+        return MakeHandle(vIndexIt->second->second);
+      }
+    }
+
+    // opened without the lock, a slow file does not block the other files
+    auto vStart = tClock::now();
+    tReader vReader = aOpen();
+    bpUInt64 vMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(tClock::now() - vStart).count();
+    if (!vReader) {
+      // not cached, the next GetReader tries again
+      return nullptr;
+    }
+
+    // destroyed after the lock is released, closing a reader waits for its requests
+    std::vector<tReader> vEvicted;
+    tLock vLock(mMutex);
+    ++mStatistics.mOpens;
+    mStatistics.mTotalOpenMicroseconds += vMicroseconds;
+    mStatistics.mMaxOpenMicroseconds = std::max(mStatistics.mMaxOpenMicroseconds, vMicroseconds);
+
+    auto vIndexIt = mIndex.find(vKey);
+    if (vIndexIt != mIndex.end()) {
+      // opened concurrently by another thread, keep the first one
+      vEvicted.push_back(std::move(vReader));
+      mEntries.splice(mEntries.begin(), mEntries, vIndexIt->second);
+      vReader = vIndexIt->second->second;
+    }
+    else {
+      mEntries.emplace_front(vKey, vReader);
+      mIndex[vKey] = mEntries.begin();
+      Evict(mMaxOpenReaders, vEvicted);
+    }
+    return MakeHandle(vReader);
+  }
+
+  void Clear()
+  {
+    std::vector<tReader> vEvicted;
+    tLock vLock(mMutex);
+    Evict(0, vEvicted);
+  }
+
+  // called when a handle is released, the readers nobody holds anymore are closed down to the bound
+  void Release()
+  {
+    std::vector<tReader> vEvicted;
+    tLock vLock(mMutex);
+    Evict(mMaxOpenReaders, vEvicted);
+  }
+
+  bpReaderTypes::cReaderPoolStatistics GetStatistics()
+  {
+    tLock vLock(mMutex);
+    bpReaderTypes::cReaderPoolStatistics vStatistics = mStatistics;
+    vStatistics.mNumberOfOpenReaders = mEntries.size();
+    return vStatistics;
+  }
+
+private:
+  using tKey = std::tuple<bpString, bpSize, bpfNumberType>;
+  using tEntry = std::pair<tKey, tReader>;
+  using tEntries = std::list<tEntry>;
+  using tLock = std::unique_lock<std::mutex>;
+  using tClock = std::chrono::steady_clock;
+
+  // a reference to aReader for the caller, whose release lets the pool close readers that were kept over the bound
+  // while they were held; the pool may be destroyed before its handles
+  tReader MakeHandle(const tReader& aReader)
+  {
+    bpfWeakPtr<cCache> vCache = shared_from_this();
+    tReader vReader = aReader;
+    return tReader(aReader.get(), [vCache, vReader](bpImageReaderBaseInterface*) mutable {
+      vReader.reset();
+      if (bpfSharedPtr<cCache> vLockedCache = vCache.lock()) {
+        vLockedCache->Release();
+      }
+    });
+  }
+
+  // moves the least recently used readers nobody holds to aEvicted until at most aMaxOpenReaders are left
+  void Evict(bpSize aMaxOpenReaders, std::vector<tReader>& aEvicted)
+  {
+    auto vEntryIt = mEntries.end();
+    while (mEntries.size() > aMaxOpenReaders && vEntryIt != mEntries.begin()) {
+      --vEntryIt;
+      if (vEntryIt->second.use_count() > 1) {
+        continue;
+      }
+      aEvicted.push_back(std::move(vEntryIt->second));
+      mIndex.erase(vEntryIt->first);
+      vEntryIt = mEntries.erase(vEntryIt);
+      ++mStatistics.mEvictions;
+    }
+  }
+
+  bpSize mMaxOpenReaders;
+  bpReaderTypes::cReadOptions mOptions;
+
+  std::mutex mMutex;
+  // most recently used first
+  tEntries mEntries;
+  std::map<tKey, tEntries::iterator> mIndex;
+  bpReaderTypes::cReaderPoolStatistics mStatistics;
+};
+
+
+bpImageReaderPool::bpImageReaderPool(bpSize aMaxOpenReaders, const bpReaderTypes::cReadOptions& aOptions)
+  : mCache(bpfMakeSharedPtr<cCache>(aMaxOpenReaders, aOptions))
+{
+}
+
+
+bpImageReaderPool::~bpImageReaderPool()
+{
+}
+
+
+template<typename TDataType>
+bpSharedPtr<bpImageReader<TDataType>> bpImageReaderPool::GetReader(const bpString& aInputFile, bpSize aImageIndex)
+{
+  const bpReaderTypes::cReadOptions& vOptions = mCache->GetOptions();
+  auto vReader = mCache->Get(aInputFile, aImageIndex, bpfGetNumberType<TDataType>(), [&]() -> cCache::tReader {
+    auto vNewReader = bpfMakeSharedPtr<bpImageReader<TDataType>>(aInputFile, aImageIndex, vOptions);
+    // the reader of a file that could not be opened has no resolution levels
+    std::vector<bpConverterTypes::tSize5D> vImageSizes;
+    std::vector<bpConverterTypes::tSize5D> vBlockSizes;
+    bpConverterTypes::cImageExtent vImageExtent;
+    bpConverterTypes::tTimeInfoVector vTimeInfos;
+    bpConverterTypes::tColorInfoVector vColorInfos;
+    bpConverterTypes::tCompressionAlgorithmType vCompression;
+    vNewReader->ReadMetadata(bpReaderTypes::eMetadataImageSize, vImageSizes, vBlockSizes, vImageExtent, vTimeInfos, vColorInfos, vCompression);
+    if (vImageSizes.empty()) {
+      return nullptr;
+    }
+    return vNewReader;
+  });
+  return std::static_pointer_cast<bpImageReader<TDataType>>(vReader);
+}
+
+
+void bpImageReaderPool::Clear()
+{
+  mCache->Clear();
+}
+
+
+bpReaderTypes::cReaderPoolStatistics bpImageReaderPool::GetStatistics()
+{
+  return mCache->GetStatistics();
+}
+
+
+template bpSharedPtr<bpImageReader<bpUInt8>> bpImageReaderPool::GetReader<bpUInt8>(const bpString&, bpSize);
+template bpSharedPtr<bpImageReader<bpUInt16>> bpImageReaderPool::GetReader<bpUInt16>(const bpString&, bpSize);
+template bpSharedPtr<bpImageReader<bpUInt32>> bpImageReaderPool::GetReader<bpUInt32>(const bpString&, bpSize);
+template bpSharedPtr<bpImageReader<bpFloat>> bpImageReaderPool::GetReader<bpFloat>(const bpString&, bpSize);
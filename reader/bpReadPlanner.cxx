@@ -0,0 +1,51 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#include "ImarisReader/reader/bpReadPlanner.h"
+
+#include <algorithm>
+
+
+void bpReadPlanner::Plan(const hsize_t (&aChunkDim)[3], const hsize_t (&aExtent)[3], const hsize_t (&aStart)[3], const hsize_t (&aSize)[3], std::vector<cChunkBox>& aBoxes)
+{
+  hsize_t vEnd[3];
+  for (bpfSize vIndex = 0; vIndex < 3; vIndex++) {
+    if (aChunkDim[vIndex] == 0) {
+      return;
+    }
+    vEnd[vIndex] = std::max(aStart[vIndex], std::min(aStart[vIndex] + aSize[vIndex], aExtent[vIndex]));
+    if (vEnd[vIndex] == aStart[vIndex]) {
+      return;
+    }
+  }
+
+  cChunkBox vBox;
+  hsize_t* vChunk = vBox.mChunkIndex;
+  for (vChunk[0] = aStart[0] / aChunkDim[0]; vChunk[0] * aChunkDim[0] < vEnd[0]; ++vChunk[0]) {
+    for (vChunk[1] = aStart[1] / aChunkDim[1]; vChunk[1] * aChunkDim[1] < vEnd[1]; ++vChunk[1]) {
+      for (vChunk[2] = aStart[2] / aChunkDim[2]; vChunk[2] * aChunkDim[2] < vEnd[2]; ++vChunk[2]) {
+        for (bpfSize vIndex = 0; vIndex < 3; vIndex++) {
+          vBox.mChunkStart[vIndex] = vChunk[vIndex] * aChunkDim[vIndex];
+          vBox.mBegin[vIndex] = std::max(vBox.mChunkStart[vIndex], aStart[vIndex]);
+          vBox.mEnd[vIndex] = std::min(vBox.mChunkStart[vIndex] + aChunkDim[vIndex], vEnd[vIndex]);
+        }
+        aBoxes.push_back(vBox);
+      }
+    }
+  }
+}
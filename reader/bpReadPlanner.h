@@ -0,0 +1,56 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BP_READ_PLANNER__
+#define __BP_READ_PLANNER__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+
+#include "hdf5.h"
+
+#include <vector>
+
+
+/**
+ * Splits the block of one (resolution, time point, channel) dataset that a read
+ * covers into the parts of the chunks it touches, so that each chunk can be read
+ * and decoded as an independent work item.
+ */
+class bpReadPlanner
+{
+public:
+  // hdf5 order, [z, y, x], in file coordinates
+  struct cChunkBox
+  {
+    hsize_t mChunkIndex[3];
+    hsize_t mChunkStart[3];
+    // intersection of the chunk with the read
+    hsize_t mBegin[3];
+    hsize_t mEnd[3];
+  };
+
+  /**
+   * Appends the intersection of [aStart, aStart + aSize), clipped to aExtent, with every chunk
+   * of the grid aChunkDim to aBoxes, x fastest. Nothing is appended if the clipped block is empty.
+   */
+  static void Plan(const hsize_t (&aChunkDim)[3], const hsize_t (&aExtent)[3], const hsize_t (&aStart)[3], const hsize_t (&aSize)[3], std::vector<cChunkBox>& aBoxes);
+};
+
+
+#endif // __BP_READ_PLANNER__
@@ -0,0 +1,191 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#if defined(_WIN32)
+  #define NOMINMAX
+#endif
+
+#include "ImarisReader/interface/bpStorage.h"
+#include "ImarisReader/utils/bpfFileTools.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif // _WIN32
+
+
+// index after the run of ranges from aBegin on that each start where the previous one ends
+static bpSize GetRunEnd(const std::vector<bpStorageInterface::cRange>& aRanges, bpSize aBegin)
+{
+  bpSize vEnd = aBegin + 1;
+  while (vEnd < aRanges.size() && aRanges[vEnd].mOffset == aRanges[vEnd - 1].mOffset + aRanges[vEnd - 1].mSize) {
+    ++vEnd;
+  }
+  return vEnd;
+}
+
+
+#if defined(_WIN32)
+
+bpLocalStorage::bpLocalStorage(const bpString& aFileName)
+  : mFile(INVALID_HANDLE_VALUE),
+    mSize(0)
+{
+  mFile = CreateFileW(bpfFileTools::FromUtf8Path(aFileName).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  LARGE_INTEGER vSize;
+  if (mFile != INVALID_HANDLE_VALUE && GetFileSizeEx(mFile, &vSize)) {
+    mSize = static_cast<bpUInt64>(vSize.QuadPart);
+  }
+}
+
+
+bpLocalStorage::~bpLocalStorage()
+{
+  if (mFile != INVALID_HANDLE_VALUE) {
+    CloseHandle(mFile);
+  }
+}
+
+
+bool bpLocalStorage::IsOpen() const
+{
+  return mFile != INVALID_HANDLE_VALUE;
+}
+
+
+bool bpLocalStorage::Read(bpUInt64 aOffset, bpSize aSize, void* aData)
+{
+  bpUInt8* vData = static_cast<bpUInt8*>(aData);
+  while (aSize > 0) {
+    OVERLAPPED vOverlapped = {};
+    vOverlapped.Offset = static_cast<DWORD>(aOffset);
+    vOverlapped.OffsetHigh = static_cast<DWORD>(aOffset >> 32);
+    DWORD vRead = 0;
+    DWORD vSize = static_cast<DWORD>(std::min<bpSize>(aSize, 1 << 30));
+    if (!ReadFile(mFile, vData, vSize, &vRead, &vOverlapped) || vRead == 0) {
+      return false;
+    }
+    vData += vRead;
+    aOffset += vRead;
+    aSize -= vRead;
+  }
+  return true;
+}
+
+
+bool bpLocalStorage::ReadRanges(const std::vector<cRange>& aRanges)
+{
+  // overlapped ReadFile has no scatter read for buffered files
+  return bpStorageInterface::ReadRanges(aRanges);
+}
+
+#else
+
+bpLocalStorage::bpLocalStorage(const bpString& aFileName)
+  : mFile(-1),
+    mSize(0)
+{
+  mFile = open(aFileName.c_str(), O_RDONLY);
+  struct stat vStat;
+  if (mFile >= 0 && fstat(mFile, &vStat) == 0) {
+    mSize = static_cast<bpUInt64>(vStat.st_size);
+  }
+}
+
+
+bpLocalStorage::~bpLocalStorage()
+{
+  if (mFile >= 0) {
+    close(mFile);
+  }
+}
+
+
+bool bpLocalStorage::IsOpen() const
+{
+  return mFile >= 0;
+}
+
+
+bool bpLocalStorage::Read(bpUInt64 aOffset, bpSize aSize, void* aData)
+{
+  bpUInt8* vData = static_cast<bpUInt8*>(aData);
+  while (aSize > 0) {
+    ssize_t vRead = pread(mFile, vData, aSize, static_cast<off_t>(aOffset));
+    if (vRead <= 0) {
+      return false;
+    }
+    vData += vRead;
+    aOffset += vRead;
+    aSize -= vRead;
+  }
+  return true;
+}
+
+
+bool bpLocalStorage::ReadRanges(const std::vector<cRange>& aRanges)
+{
+  std::vector<iovec> vBuffers;
+  for (bpSize vBegin = 0; vBegin < aRanges.size();) {
+    bpSize vEnd = GetRunEnd(aRanges, vBegin);
+    vBuffers.clear();
+    for (bpSize vIndex = vBegin; vIndex < vEnd; ++vIndex) {
+      if (aRanges[vIndex].mSize > 0) {
+        vBuffers.push_back({ aRanges[vIndex].mData, aRanges[vIndex].mSize });
+      }
+    }
+
+    // one preadv per IOV_MAX buffers, short reads continue inside the buffer they stopped in
+    bpUInt64 vOffset = aRanges[vBegin].mOffset;
+    iovec* vBuffer = vBuffers.data();
+    iovec* vBuffersEnd = vBuffers.data() + vBuffers.size();
+    while (vBuffer != vBuffersEnd) {
+      int vCount = static_cast<int>(std::min<bpSize>(vBuffersEnd - vBuffer, IOV_MAX));
+      ssize_t vRead = preadv(mFile, vBuffer, vCount, static_cast<off_t>(vOffset));
+      if (vRead <= 0) {
+        return false;
+      }
+      vOffset += vRead;
+      while (vBuffer != vBuffersEnd && static_cast<bpSize>(vRead) >= vBuffer->iov_len) {
+        vRead -= vBuffer->iov_len;
+        ++vBuffer;
+      }
+      if (vBuffer != vBuffersEnd) {
+        vBuffer->iov_base = static_cast<bpUInt8*>(vBuffer->iov_base) + vRead;
+        vBuffer->iov_len -= vRead;
+      }
+    }
+    vBegin = vEnd;
+  }
+  return true;
+}
+
+#endif // _WIN32
+
+
+bpUInt64 bpLocalStorage::GetSize()
+{
+  return mSize;
+}
@@ -0,0 +1,122 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#include "ImarisReader/interface/bpImageReader.h"
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/test/bpTestFile.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+
+using namespace bpConverterTypes;
+
+
+/**
+ * Reads aNumberOfReads regions on each of aNumberOfThreads threads that share aReader.
+ * Returns the throughput in MB/s.
+ */
+static bpfDouble ReadConcurrently(bpImageReader<bpfUInt16>& aReader, const bpTestFileLayout& aLayout, bpfSize aNumberOfThreads, bpfSize aNumberOfReads)
+{
+  const bpfSize vRegionSizeXY = std::min<bpfSize>(128, aLayout.mSizeX);
+  const bpfSize vRegionSizeZ = std::min<bpfSize>(32, aLayout.mSizeZ);
+  std::atomic<bpfSize> vNumberOfErrors(0);
+
+  auto vStart = std::chrono::steady_clock::now();
+  std::vector<std::thread> vThreads;
+  for (bpfSize vThread = 0; vThread < aNumberOfThreads; ++vThread) {
+    vThreads.emplace_back([&, vThread]() {
+      std::vector<bpfUInt16> vData(vRegionSizeXY * vRegionSizeXY * vRegionSizeZ);
+      for (bpfSize vRead = 0; vRead < aNumberOfReads; ++vRead) {
+        // tiles spread over the image, different on every thread
+        bpfSize vTile = vThread * aNumberOfReads + vRead;
+        bpfSize vX = (vTile * 97) % (aLayout.mSizeX - vRegionSizeXY + 1);
+        bpfSize vY = (vTile * 61) % (aLayout.mSizeY - vRegionSizeXY + 1);
+        bpfSize vZ = (vTile * 13) % (aLayout.mSizeZ - vRegionSizeZ + 1);
+        tIndex5D vBegin(X, vX, Y, vY, Z, vZ, C, 0, T, 0);
+        tIndex5D vEnd(X, vX + vRegionSizeXY, Y, vY + vRegionSizeXY, Z, vZ + vRegionSizeZ, C, 1, T, 1);
+        aReader.ReadData(vBegin, vEnd, 0, vData.data());
+        for (bpfSize vIndex = vRead % 97; vIndex < vData.size(); vIndex += 97) {
+          bpfSize vOffsetX = vIndex % vRegionSizeXY;
+          bpfSize vOffsetY = vIndex / vRegionSizeXY % vRegionSizeXY;
+          bpfSize vOffsetZ = vIndex / (vRegionSizeXY * vRegionSizeXY);
+          if (vData[vIndex] != bpTestGetValue(vX + vOffsetX, vY + vOffsetY, vZ + vOffsetZ, 0, 0)) {
+            ++vNumberOfErrors;
+          }
+        }
+      }
+    });
+  }
+  for (std::thread& vThread : vThreads) {
+    vThread.join();
+  }
+  bpfDouble vSeconds = std::chrono::duration<bpfDouble>(std::chrono::steady_clock::now() - vStart).count();
+
+  bpTestCheck(vNumberOfErrors == 0, std::to_string(aNumberOfThreads) + " threads read the expected voxels");
+  bpfDouble vMegaBytes = aNumberOfThreads * aNumberOfReads * vRegionSizeXY * vRegionSizeXY * vRegionSizeZ * sizeof(bpfUInt16) / 1e6;
+  return vMegaBytes / vSeconds;
+}
+
+
+/**
+ * Several threads read tiles of one gzip compressed image through one shared reader, with
+ * and without mConcurrentReadData, and the throughput is printed for 1 to 8 threads.
+ * Without the option the reader lock serializes the reads; with it only the hdf5 calls
+ * are serialized and the decompression of the threads overlaps.
+ *
+ * usage: bpImageReaderConcurrencyBenchmark [reads per thread, default 32] [image size x and y, default 1024]
+ */
+int main(int aArgc, char** aArgv)
+{
+  bpfSize vNumberOfReads = aArgc > 1 ? std::strtoul(aArgv[1], nullptr, 10) : 32;
+  bpTestFileLayout vLayout;
+  vLayout.mSizeX = aArgc > 2 ? std::strtoul(aArgv[2], nullptr, 10) : 1024;
+  vLayout.mSizeY = vLayout.mSizeX;
+  vLayout.mSizeZ = 64;
+  vLayout.mBlockSizeX = 128;
+  vLayout.mBlockSizeY = 128;
+  vLayout.mBlockSizeZ = 16;
+  vLayout.mCompression = bpTestFileLayout::eCompressionGzip;
+  const bpfString vFileName = "bpImageReaderConcurrencyBenchmark.ims";
+  if (!bpTestCheck(bpTestWriteFile(vFileName, vLayout), "write " + vFileName)) {
+    return bpTestExitCode();
+  }
+
+  for (bool vConcurrentReadData : { false, true }) {
+    bpReaderTypes::cReadOptions vOptions;
+    vOptions.mConcurrentReadData = vConcurrentReadData;
+    bpImageReader<bpfUInt16> vReader(vFileName, 0, vOptions);
+
+    bpfDouble vSingleThread = 0;
+    for (bpfSize vNumberOfThreads : { 1, 2, 4, 8 }) {
+      bpfDouble vThroughput = ReadConcurrently(vReader, vLayout, vNumberOfThreads, vNumberOfReads);
+      if (vNumberOfThreads == 1) {
+        vSingleThread = vThroughput;
+      }
+      std::printf("mConcurrentReadData %d, %zu threads: %7.1f MB/s, %.2fx of one thread\n",
+        vConcurrentReadData ? 1 : 0, static_cast<size_t>(vNumberOfThreads), vThroughput, vThroughput / vSingleThread);
+    }
+  }
+
+  std::remove(vFileName.c_str());
+  return bpTestExitCode();
+}
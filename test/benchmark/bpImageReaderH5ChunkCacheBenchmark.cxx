@@ -0,0 +1,101 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/interface/bpImageReader.h"
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/test/bpTestFile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+
+using namespace bpConverterTypes;
+
+
+/**
+ * Reads the first aNumberOfSlices slices one after the other, checks every 97th voxel and returns the time in ms.
+ * aSliceDimension is Z for XY slices and Y for XZ slices.
+ */
+static bpfDouble ReadSlices(bpImageReader<bpfUInt16>&& aReader, const bpTestFileLayout& aLayout, Dimension aSliceDimension, bpfSize aNumberOfSlices)
+{
+  const bpfSize vSizeSliceY = aSliceDimension == Z ? aLayout.mSizeY : aLayout.mSizeZ;
+  std::vector<bpfUInt16> vData(aLayout.mSizeX * vSizeSliceY);
+  bpfSize vNumberOfErrors = 0;
+
+  auto vStart = std::chrono::steady_clock::now();
+  for (bpfSize vSlice = 0; vSlice < aNumberOfSlices; ++vSlice) {
+    tIndex5D vBegin(X, 0, Y, 0, Z, 0, C, 0, T, 0);
+    tIndex5D vEnd(X, aLayout.mSizeX, Y, aLayout.mSizeY, Z, aLayout.mSizeZ, C, 1, T, 1);
+    vBegin[aSliceDimension] = vSlice;
+    vEnd[aSliceDimension] = vSlice + 1;
+    aReader.ReadData(vBegin, vEnd, 0, vData.data());
+    for (bpfSize vIndex = vSlice % 97; vIndex < vData.size(); vIndex += 97) {
+      bpfSize vX = vIndex % aLayout.mSizeX;
+      bpfSize vY = aSliceDimension == Z ? vIndex / aLayout.mSizeX : vSlice;
+      bpfSize vZ = aSliceDimension == Z ? vSlice : vIndex / aLayout.mSizeX;
+      if (vData[vIndex] != bpTestGetValue(vX, vY, vZ, 0, 0)) {
+        ++vNumberOfErrors;
+      }
+    }
+  }
+  bpfDouble vMilliSeconds = std::chrono::duration<bpfDouble, std::milli>(std::chrono::steady_clock::now() - vStart).count();
+
+  bpTestCheck(vNumberOfErrors == 0, bpfString(aSliceDimension == Z ? "xy" : "xz") + " slices have the expected voxels");
+  return vMilliSeconds;
+}
+
+
+/**
+ * Reads all XY slices and then as many XZ slices of a gzip compressed image with large chunks,
+ * once for each mH5ChunkCacheMode, and prints the times. The reads go through H5Dread, so they
+ * are served by hdf5's chunk cache: with the default 1 MB cache every slice decompresses all the
+ * chunks it touches again, with a tuned cache each chunk is decompressed about once.
+ *
+ * usage: bpImageReaderH5ChunkCacheBenchmark [image size x and y, default 1024]
+ */
+int main(int aArgc, char** aArgv)
+{
+  bpTestFileLayout vLayout;
+  vLayout.mSizeX = aArgc > 1 ? std::strtoul(aArgv[1], nullptr, 10) : 1024;
+  vLayout.mSizeY = vLayout.mSizeX;
+  vLayout.mSizeZ = 64;
+  vLayout.mBlockSizeX = std::min<bpfSize>(256, vLayout.mSizeX);
+  vLayout.mBlockSizeY = vLayout.mBlockSizeX;
+  vLayout.mBlockSizeZ = 32;
+  vLayout.mCompression = bpTestFileLayout::eCompressionGzip;
+  const bpfString vFileName = "bpImageReaderH5ChunkCacheBenchmark.ims";
+  if (!bpTestCheck(bpTestWriteFile(vFileName, vLayout), "write " + vFileName)) {
+    return bpTestExitCode();
+  }
+
+  const bpfSize vNumberOfXZSlices = std::min<bpfSize>(vLayout.mSizeY, vLayout.mSizeZ);
+  for (bpReaderTypes::tH5ChunkCacheMode vMode : { bpReaderTypes::eH5ChunkCacheDefault, bpReaderTypes::eH5ChunkCacheFixed, bpReaderTypes::eH5ChunkCacheAuto }) {
+    bpReaderTypes::cReadOptions vOptions;
+    vOptions.mH5ChunkCacheMode = vMode;
+    // one reader for each direction, closed before the next is opened: hdf5 shares the chunk cache
+    // of a dataset that is still open, and the xz slices would find the chunks of the xy slices
+    bpfDouble vXY = ReadSlices(bpImageReader<bpfUInt16>(vFileName, 0, vOptions), vLayout, Z, vLayout.mSizeZ);
+    bpfDouble vXZ = ReadSlices(bpImageReader<bpfUInt16>(vFileName, 0, vOptions), vLayout, Y, vNumberOfXZSlices);
+    std::printf("mH5ChunkCacheMode %d: %zu xy slices %9.1f ms, %zu xz slices %9.1f ms\n", static_cast<int>(vMode),
+      static_cast<size_t>(vLayout.mSizeZ), vXY, static_cast<size_t>(vNumberOfXZSlices), vXZ);
+  }
+
+  std::remove(vFileName.c_str());
+  return bpTestExitCode();
+}
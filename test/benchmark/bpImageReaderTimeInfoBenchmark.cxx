@@ -0,0 +1,125 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#include "ImarisReader/interface/bpImageReader.h"
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/test/bpTestFile.h"
+#include "ImarisReader/types/bpfTimeInfo.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+
+using namespace bpConverterTypes;
+
+
+/**
+ * The time info as it was read before: one attribute open, one string and one
+ * bpfTimeInfo per time point.
+ */
+static tTimeInfoVector ReadTimeInfoPerAttribute(const bpfString& aFileName, bpfSize aNumberOfTimePoints)
+{
+  tTimeInfoVector vTimeInfos(aNumberOfTimePoints);
+  hid_t vFileId = H5Fopen(aFileName.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  hid_t vTimeInfoId = H5Gopen2(vFileId, "DataSetInfo/TimeInfo", H5P_DEFAULT);
+  for (bpfSize vIndexT = 0; vIndexT < aNumberOfTimePoints; ++vIndexT) {
+    bpfString vName = "TimePoint" + std::to_string(vIndexT + 1);
+    bpfString vValue;
+    if (H5Aexists(vTimeInfoId, vName.c_str()) > 0) {
+      hid_t vAttributeId = H5Aopen_by_name(vTimeInfoId, ".", vName.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+      hid_t vTypeId = H5Aget_type(vAttributeId);
+      hid_t vSpaceId = H5Aget_space(vAttributeId);
+      hsize_t vSize = 0;
+      H5Sget_simple_extent_dims(vSpaceId, &vSize, nullptr);
+      std::vector<bpfChar> vBuffer(vSize + 1, 0);
+      H5Aread(vAttributeId, vTypeId, vBuffer.data());
+      vValue = vBuffer.data();
+      H5Sclose(vSpaceId);
+      H5Tclose(vTypeId);
+      H5Aclose(vAttributeId);
+    }
+    bpfTimeInfo vTimeInfo(vValue);
+    vTimeInfos[vIndexT] = { vTimeInfo.GetJulianDay(), vTimeInfo.GetNanoseconds() };
+  }
+  H5Gclose(vTimeInfoId);
+  H5Fclose(vFileId);
+  return vTimeInfos;
+}
+
+
+/**
+ * Writes a file with 100k time points and times reading their time info, with the
+ * per attribute loop of before and with the reader (opening it, and ReadMetadata of
+ * the time info alone). Both must give the same times.
+ *
+ * usage: bpImageReaderTimeInfoBenchmark [number of time points, default 100000]
+ */
+int main(int aArgc, char** aArgv)
+{
+  bpTestFileLayout vLayout;
+  vLayout.mSizeX = 8;
+  vLayout.mSizeY = 8;
+  vLayout.mSizeZ = 4;
+  vLayout.mSizeT = 1;
+  bpfSize vNumberOfTimePoints = aArgc > 1 ? std::strtoul(aArgv[1], nullptr, 10) : 100000;
+  vLayout.mNumberOfEmptyTimePoints = vNumberOfTimePoints - 1;
+  const bpfString vFileName = "bpImageReaderTimeInfoBenchmark.ims";
+  if (!bpTestCheck(bpTestWriteFile(vFileName, vLayout), "write " + vFileName)) {
+    return bpTestExitCode();
+  }
+
+  auto vStart = std::chrono::steady_clock::now();
+  tTimeInfoVector vExpected = ReadTimeInfoPerAttribute(vFileName, vNumberOfTimePoints);
+  auto vLegacyEnd = std::chrono::steady_clock::now();
+  bpfDouble vFirstFrame = 0;
+  bpfDouble vReadMetadata = 0;
+  tTimeInfoVector vTimeInfos;
+  {
+    bpImageReader<bpfUInt16> vReader(vFileName, 0, bpReaderTypes::cReadOptions());
+    auto vOpenEnd = std::chrono::steady_clock::now();
+    bpfUInt16 vVoxel = 0;
+    vReader.ReadData(tIndex5D(X, 0, Y, 0, Z, 0, C, 0, T, 0), tIndex5D(X, 1, Y, 1, Z, 1, C, 1, T, 1), 0, &vVoxel);
+    auto vFirstFrameEnd = std::chrono::steady_clock::now();
+    bpTestCheck(vVoxel == bpTestGetValue(0, 0, 0, 0, 0), "first voxel");
+
+    std::vector<tSize5D> vImageSizes;
+    std::vector<tSize5D> vBlockSizes;
+    cImageExtent vExtent;
+    tColorInfoVector vColorInfos;
+    tCompressionAlgorithmType vCompression;
+    vReader.ReadMetadata(bpReaderTypes::eMetadataTimeInfo, vImageSizes, vBlockSizes, vExtent, vTimeInfos, vColorInfos, vCompression);
+    auto vReadMetadataEnd = std::chrono::steady_clock::now();
+    vFirstFrame = std::chrono::duration<bpfDouble, std::milli>(vFirstFrameEnd - vLegacyEnd).count();
+    vReadMetadata = std::chrono::duration<bpfDouble, std::milli>(vReadMetadataEnd - vFirstFrameEnd).count();
+    std::printf("%zu time points: open %.1f ms\n", static_cast<size_t>(vNumberOfTimePoints), std::chrono::duration<bpfDouble, std::milli>(vOpenEnd - vLegacyEnd).count());
+  }
+
+  bool vIsSame = vTimeInfos.size() == vExpected.size();
+  for (bpfSize vIndexT = 0; vIsSame && vIndexT < vTimeInfos.size(); ++vIndexT) {
+    vIsSame = vTimeInfos[vIndexT].mJulianDay == vExpected[vIndexT].mJulianDay && vTimeInfos[vIndexT].mNanosecondsOfDay == vExpected[vIndexT].mNanosecondsOfDay;
+  }
+  bpTestCheck(vIsSame, "ReadMetadata returns the times of the per attribute loop");
+
+  std::printf("%zu time points: per attribute loop %.1f ms, first voxel after opening %.1f ms, ReadMetadata time info %.1f ms\n",
+    static_cast<size_t>(vNumberOfTimePoints), std::chrono::duration<bpfDouble, std::milli>(vLegacyEnd - vStart).count(), vFirstFrame, vReadMetadata);
+
+  std::remove(vFileName.c_str());
+  return bpTestExitCode();
+}
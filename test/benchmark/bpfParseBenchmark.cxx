@@ -0,0 +1,111 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/types/bpfTimeInfo.h"
+#include "ImarisReader/utils/bpfStringTokenizer.h"
+#include "ImarisReader/utils/bpfUtils.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+
+/**
+ * Parses a 256 entry color table and a list of time points with the legacy path (bpfSplit,
+ * stream based bpfFromString and the bpfTimeInfo constructor) and with the tokenizer and the
+ * fast parsers, and prints the time per table or per time point.
+ *
+ * usage: bpfParseBenchmark [repetitions, default 2000]
+ */
+int main(int aArgc, char** aArgv)
+{
+  bpfSize vRepetitions = aArgc > 1 ? std::strtoul(aArgv[1], nullptr, 10) : 2000;
+
+  bpfString vColorTable;
+  for (bpfSize vIndex = 0; vIndex < 256; ++vIndex) {
+    bpfChar vEntry[64];
+    std::snprintf(vEntry, sizeof(vEntry), "%g %g %g ", vIndex / 255.0, 1 - vIndex / 255.0, 0.5);
+    vColorTable += vEntry;
+  }
+
+  bpfDouble vLegacySum = 0;
+  auto vStart = std::chrono::steady_clock::now();
+  for (bpfSize vRepetition = 0; vRepetition < vRepetitions; ++vRepetition) {
+    for (const bpfString& vPart : bpfSplit(vColorTable, " ", false, true)) {
+      bpfFloat vValue = 0;
+      bpfFromString(vPart, vValue);
+      vLegacySum += vValue;
+    }
+  }
+  auto vLegacyEnd = std::chrono::steady_clock::now();
+  bpfDouble vFastSum = 0;
+  for (bpfSize vRepetition = 0; vRepetition < vRepetitions; ++vRepetition) {
+    bpfStringTokenizer vTokenizer(vColorTable, ' ', false, true);
+    const bpfChar* vTokenBegin;
+    const bpfChar* vTokenEnd;
+    while (vTokenizer.Next(vTokenBegin, vTokenEnd)) {
+      bpfFloat vValue = 0;
+      bpfFromString(vTokenBegin, vTokenEnd, vValue);
+      vFastSum += vValue;
+    }
+  }
+  auto vFastEnd = std::chrono::steady_clock::now();
+  bpTestCheck(vLegacySum == vFastSum, "color tables parse to the same values");
+
+  std::printf("color table: split + stream %.1f us, tokenizer + fast parser %.1f us\n",
+    std::chrono::duration<bpfDouble, std::micro>(vLegacyEnd - vStart).count() / vRepetitions,
+    std::chrono::duration<bpfDouble, std::micro>(vFastEnd - vLegacyEnd).count() / vRepetitions);
+
+  std::vector<bpfString> vTimes;
+  for (bpfSize vIndex = 0; vIndex < 1000; ++vIndex) {
+    bpfChar vTime[64];
+    std::snprintf(vTime, sizeof(vTime), "2021-03-%02d %02d:%02d:%02d.%03d", static_cast<int>(1 + vIndex % 28),
+      static_cast<int>(vIndex / 3600 % 24), static_cast<int>(vIndex / 60 % 60), static_cast<int>(vIndex % 60), static_cast<int>(vIndex * 7 % 1000));
+    vTimes.push_back(vTime);
+  }
+
+  bpfInt64 vLegacyNanoseconds = 0;
+  vStart = std::chrono::steady_clock::now();
+  for (bpfSize vRepetition = 0; vRepetition < vRepetitions; ++vRepetition) {
+    for (const bpfString& vTime : vTimes) {
+      bpfTimeInfo vTimeInfo(vTime);
+      vLegacyNanoseconds += vTimeInfo.GetNanoseconds() + vTimeInfo.GetJulianDay();
+    }
+  }
+  vLegacyEnd = std::chrono::steady_clock::now();
+  bpfInt64 vFastNanoseconds = 0;
+  for (bpfSize vRepetition = 0; vRepetition < vRepetitions; ++vRepetition) {
+    for (const bpfString& vTime : vTimes) {
+      bpfInt32 vJulianDay = 0;
+      bpfInt64 vNanoseconds = 0;
+      bpfTimeInfo::Parse(vTime.data(), vTime.data() + vTime.size(), vJulianDay, vNanoseconds);
+      vFastNanoseconds += vNanoseconds + vJulianDay;
+    }
+  }
+  vFastEnd = std::chrono::steady_clock::now();
+  bpTestCheck(vLegacyNanoseconds == vFastNanoseconds, "time points parse to the same times");
+
+  bpfSize vNumberOfTimes = vRepetitions * vTimes.size();
+  std::printf("time point: bpfTimeInfo(string) %.0f ns, bpfTimeInfo::Parse %.0f ns\n",
+    std::chrono::duration<bpfDouble, std::nano>(vLegacyEnd - vStart).count() / vNumberOfTimes,
+    std::chrono::duration<bpfDouble, std::nano>(vFastEnd - vLegacyEnd).count() / vNumberOfTimes);
+
+  return bpTestExitCode();
+}
@@ -0,0 +1,133 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/interface/bpImageReader.h"
+#include "ImarisReader/reader/bpFileRegistry.h"
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/test/bpTestFile.h"
+
+#include <cstdio>
+#include <vector>
+
+
+using namespace bpConverterTypes;
+
+
+static ssize_t GetNumberOfOpenFiles()
+{
+  return H5Fget_obj_count(H5F_OBJ_ALL, H5F_OBJ_FILE);
+}
+
+
+static bpfSize GetSizeX(const bpfString& aFileName)
+{
+  bpImageReader<bpfUInt16> vReader(aFileName, 0, bpReaderTypes::cReadOptions());
+  std::vector<tSize5D> vImageSizes;
+  std::vector<tSize5D> vBlockSizes;
+  cImageExtent vExtent;
+  tTimeInfoVector vTimeInfos;
+  tColorInfoVector vColorInfos;
+  tCompressionAlgorithmType vCompression;
+  vReader.ReadMetadata(bpReaderTypes::eMetadataImageSize, vImageSizes, vBlockSizes, vExtent, vTimeInfos, vColorInfos, vCompression);
+  return vImageSizes.empty() ? 0 : vImageSizes[0][X];
+}
+
+
+/**
+ * Checks that readers and GetFileImagesInformation share one open file, that a file is closed with
+ * its last user, and that SWMR and the core driver are registered separately from plain opens.
+ */
+static void TestSharing(const bpfString& aFileName)
+{
+  bpFileRegistry& vRegistry = bpFileRegistry::GetInstance();
+  bpReaderTypes::cReadOptions vOptions;
+  {
+    bpFileRegistry::tFile vFile = vRegistry.Open(aFileName, vOptions);
+    bpTestCheck(vFile != nullptr, "open");
+    bpTestCheck(vRegistry.Open(aFileName, vOptions) == vFile, "a second open shares the file");
+    bpImageReader<bpfUInt16> vReader(aFileName, 0, vOptions);
+    bpImageReader<bpfUInt16> vOtherReader(aFileName, 0, vOptions);
+    bpTestCheck(GetFileImagesInformation(aFileName, vOptions).size() == 1, "GetFileImagesInformation");
+    bpTestCheck(GetNumberOfOpenFiles() == 1, "readers and GetFileImagesInformation share one open file");
+
+    bpReaderTypes::cReadOptions vCoreOptions;
+    vCoreOptions.mFileDriver = bpReaderTypes::eFileDriverCore;
+    bpFileRegistry::tFile vCoreFile = vRegistry.Open(aFileName, vCoreOptions);
+    bpTestCheck(vCoreFile != nullptr && vCoreFile != vFile, "the core driver is registered separately");
+  }
+  bpTestCheck(GetNumberOfOpenFiles() == 0, "the file is closed with its last user");
+
+  // hdf5 opens a file only once per process, either with or without SWMR
+  bpReaderTypes::cReadOptions vSWMROptions;
+  vSWMROptions.mSWMR = true;
+  {
+    bpFileRegistry::tFile vSWMRFile = vRegistry.Open(aFileName, vSWMROptions);
+    bpTestCheck(vSWMRFile != nullptr, "open with SWMR");
+    bpTestCheck(vRegistry.Open(aFileName, vSWMROptions) == vSWMRFile, "a second SWMR open shares the file");
+  }
+  bpFileRegistry::tFile vFile = vRegistry.Open(aFileName, vOptions);
+  bpTestCheck(vFile != nullptr, "open without SWMR after SWMR");
+  bpTestCheck(GetNumberOfOpenFiles() == 1, "the SWMR file is closed with its last user");
+}
+
+
+/**
+ * Replaces a file that a reader holds open by one of another size, a new reader opens the new file
+ * while the old reader keeps reading the old one.
+ */
+static void TestReplacedFile(const bpfString& aFileName)
+{
+  bpTestFileLayout vLayout;
+  vLayout.mSizeX = 64;
+  if (!bpTestCheck(bpTestWriteFile(aFileName, vLayout), "write the first file")) {
+    return;
+  }
+  bpReaderTypes::cReadOptions vOptions;
+  bpFileRegistry::tFile vFile = bpFileRegistry::GetInstance().Open(aFileName, vOptions);
+
+  // hdf5 cannot create a file that is open, the replacement is written next to it and moved over it
+  const bpfString vReplacementName = aFileName + ".new";
+  vLayout.mSizeX = 80;
+  if (!bpTestCheck(bpTestWriteFile(vReplacementName, vLayout), "write the second file")) {
+    return;
+  }
+  if (!bpTestCheck(std::rename(vReplacementName.c_str(), aFileName.c_str()) == 0, "replace the file")) {
+    std::remove(vReplacementName.c_str());
+    return;
+  }
+
+  bpFileRegistry::tFile vReplacedFile = bpFileRegistry::GetInstance().Open(aFileName, vOptions);
+  bpTestCheck(vReplacedFile != nullptr && vReplacedFile != vFile, "a replaced file is opened again");
+  bpTestCheck(GetSizeX(aFileName) == 80, "a reader of the replaced file reads the new file");
+  bpTestCheck(bpFileRegistry::GetInstance().Open(aFileName, vOptions) == vReplacedFile, "the replaced file is shared");
+}
+
+
+int main()
+{
+  const bpfString vFileName = "bpFileRegistryTest.ims";
+  if (bpTestCheck(bpTestWriteFile(vFileName, bpTestFileLayout()), "write")) {
+    TestSharing(vFileName);
+  }
+#ifndef _WIN32
+  // a file that is open cannot be replaced on windows
+  TestReplacedFile(vFileName);
+#endif
+  bpTestCheck(GetNumberOfOpenFiles() == 0, "all files are closed");
+  std::remove(vFileName.c_str());
+  return bpTestExitCode();
+}
@@ -0,0 +1,122 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/interface/bpImageReader.h"
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/test/bpTestFile.h"
+
+#include <cstdio>
+#include <vector>
+
+
+using namespace bpConverterTypes;
+
+
+static bpfSize GetSize(const tIndex5D& aBegin, const tIndex5D& aEnd)
+{
+  return (aEnd[X] - aBegin[X]) * (aEnd[Y] - aBegin[Y]) * (aEnd[Z] - aBegin[Z]) * (aEnd[C] - aBegin[C]) * (aEnd[T] - aBegin[T]);
+}
+
+
+/**
+ * Reads the regions aBegins[i], aEnds[i] with one ReadDataBatch and checks that each request
+ * holds what a separate ReadData of the same reader returns.
+ */
+template<typename TDataType>
+static void CheckBatch(bpImageReader<TDataType>& aReader, const std::vector<tIndex5D>& aBegins, const std::vector<tIndex5D>& aEnds, const bpfString& aDescription)
+{
+  std::vector<std::vector<TDataType>> vData(aBegins.size());
+  std::vector<typename bpImageReader<TDataType>::cReadRequest> vRequests;
+  for (bpfSize vRequest = 0; vRequest < aBegins.size(); ++vRequest) {
+    // a value that the file does not hold, so that voxels the batch does not write are found
+    vData[vRequest].assign(GetSize(aBegins[vRequest], aEnds[vRequest]), static_cast<TDataType>(255));
+    vRequests.push_back({ aBegins[vRequest], aEnds[vRequest], 0, vData[vRequest].data() });
+  }
+  aReader.ReadDataBatch(vRequests);
+
+  for (bpfSize vRequest = 0; vRequest < aBegins.size(); ++vRequest) {
+    std::vector<TDataType> vExpected(vData[vRequest].size(), 0);
+    aReader.ReadData(aBegins[vRequest], aEnds[vRequest], 0, vExpected.data());
+    bpTestCheck(vData[vRequest] == vExpected, aDescription + ", request " + std::to_string(vRequest) + " equals ReadData");
+  }
+}
+
+
+/**
+ * Writes files of TDataType and compares ReadDataBatch to separate ReadData calls, with a plain
+ * reader, with the chunk cache and with mParallelDecode: requests that share chunks, the same
+ * region twice, other channels and time points, and a request that reaches past the image.
+ */
+template<typename TDataType>
+static void TestBatch(const bpfString& aTypeName)
+{
+  bpTestFileLayout vLayout;
+  vLayout.mSizeX = 100;
+  vLayout.mSizeY = 45;
+  vLayout.mSizeZ = 9;
+  vLayout.mSizeC = 2;
+  vLayout.mSizeT = 2;
+  vLayout.mBlockSizeX = 32;
+  vLayout.mBlockSizeY = 16;
+  vLayout.mBlockSizeZ = 4;
+  const bpfString vFileName = "bpImageReaderBatchTest.ims";
+
+  for (bpTestFileLayout::tCompression vCompression : { bpTestFileLayout::eCompressionGzip, bpTestFileLayout::eCompressionShuffleLZ4 }) {
+    vLayout.mCompression = vCompression;
+    bpfString vName = aTypeName + (vCompression == bpTestFileLayout::eCompressionGzip ? " gzip" : " shuffle lz4");
+    if (!bpTestCheck(bpTestWriteFile<TDataType>(vFileName, vLayout), "write " + vName)) {
+      continue;
+    }
+
+    for (bpfSize vMode = 0; vMode < 3; ++vMode) {
+      bpReaderTypes::cReadOptions vOptions;
+      vOptions.mChunkCacheSizeBytes = vMode == 1 ? 16 << 20 : 0;
+      vOptions.mParallelDecode = vMode == 2;
+      const bpfChar* vModeNames[] = { "plain", "chunk cache", "parallel decode" };
+      bpImageReader<TDataType> vReader(vFileName, 0, vOptions);
+      bpfString vDescription = vName + " " + vModeNames[vMode];
+
+      // neighbouring tiles of one plane share their chunks
+      std::vector<tIndex5D> vBegins;
+      std::vector<tIndex5D> vEnds;
+      for (bpfSize vTileY = 0; vTileY < 3; ++vTileY) {
+        for (bpfSize vTileX = 0; vTileX < 4; ++vTileX) {
+          vBegins.push_back(tIndex5D(X, vTileX * 25, Y, vTileY * 15, Z, 5, C, 0, T, 0));
+          vEnds.push_back(tIndex5D(X, vTileX * 25 + 25, Y, vTileY * 15 + 15, Z, 6, C, 1, T, 1));
+        }
+      }
+      CheckBatch(vReader, vBegins, vEnds, vDescription + " tiles");
+
+      vBegins = { tIndex5D(X, 10, Y, 5, Z, 1, C, 0, T, 0), tIndex5D(X, 10, Y, 5, Z, 1, C, 0, T, 0), tIndex5D(X, 30, Y, 10, Z, 0, C, 1, T, 1),
+                  tIndex5D(X, 0, Y, 0, Z, 0, C, 0, T, 0), tIndex5D(X, 90, Y, 40, Z, 7, C, 0, T, 0) };
+      vEnds = { tIndex5D(X, 60, Y, 30, Z, 6, C, 2, T, 1), tIndex5D(X, 60, Y, 30, Z, 6, C, 2, T, 1), tIndex5D(X, 70, Y, 20, Z, 9, C, 2, T, 2),
+                tIndex5D(X, 100, Y, 45, Z, 9, C, 2, T, 2), tIndex5D(X, 110, Y, 50, Z, 11, C, 2, T, 1) };
+      CheckBatch(vReader, vBegins, vEnds, vDescription + " mixed requests");
+    }
+  }
+  std::remove(vFileName.c_str());
+}
+
+
+int main()
+{
+  TestBatch<bpfUInt8>("uint8");
+  TestBatch<bpfUInt16>("uint16");
+  TestBatch<bpfUInt32>("uint32");
+  TestBatch<bpfFloat>("float");
+  return bpTestExitCode();
+}
@@ -0,0 +1,107 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/interface/bpImageReader.h"
+#include "ImarisReader/interface/bpStorage.h"
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/test/bpTestFile.h"
+#include "ImarisReader/test/bpTestLatencyStorage.h"
+
+#include <cstdio>
+#include <vector>
+
+
+using namespace bpConverterTypes;
+
+
+/**
+ * Reads [aBegin, aEnd) through a storage that counts its requests and returns the number of
+ * requests of the read, aData receives the voxels.
+ */
+static bpUInt64 ReadThroughStorage(const bpfString& aFileName, bool aCoalesceChunkReads, const tIndex5D& aBegin, const tIndex5D& aEnd, std::vector<bpfUInt16>& aData)
+{
+  auto vStorage = bpfMakeSharedPtr<bpTestLatencyStorage>(bpfMakeSharedPtr<bpLocalStorage>(aFileName), 0);
+  bpReaderTypes::cReadOptions vOptions;
+  vOptions.mFileDriver = bpReaderTypes::eFileDriverStorage;
+  vOptions.mStorage = vStorage;
+  vOptions.mCoalesceChunkReads = aCoalesceChunkReads;
+  bpImageReader<bpfUInt16> vReader(aFileName, 0, vOptions);
+
+  // the requests of opening the file and reading its metadata are not counted
+  bpUInt64 vRequests = vStorage->GetStatistics().mRequests;
+  vReader.ReadData(aBegin, aEnd, 0, aData.data());
+  return vStorage->GetStatistics().mRequests - vRequests;
+}
+
+
+/**
+ * Reads regions of uncompressed and compressed files through a storage and checks that
+ * mCoalesceChunkReads reads the chunks of a region with fewer requests and the same voxels.
+ */
+static void TestCoalesce()
+{
+  const bpfString vFileName = "bpImageReaderCoalesceTest.ims";
+  bpTestFileLayout vLayout;
+  vLayout.mSizeX = 100;
+  vLayout.mSizeY = 45;
+  vLayout.mSizeZ = 9;
+  vLayout.mSizeC = 2;
+  vLayout.mBlockSizeX = 32;
+  vLayout.mBlockSizeY = 16;
+  vLayout.mBlockSizeZ = 4;
+
+  for (bpTestFileLayout::tCompression vCompression : { bpTestFileLayout::eCompressionNone, bpTestFileLayout::eCompressionShuffleLZ4 }) {
+    vLayout.mCompression = vCompression;
+    bpfString vName = vCompression == bpTestFileLayout::eCompressionNone ? "none" : "shuffle lz4";
+    if (!bpTestCheck(bpTestWriteFile(vFileName, vLayout), "write " + vName)) {
+      continue;
+    }
+
+    const tIndex5D vBegins[] = { tIndex5D(X, 0, Y, 0, Z, 0, C, 0, T, 0), tIndex5D(X, 5, Y, 3, Z, 1, C, 1, T, 0) };
+    const tIndex5D vEnds[] = { tIndex5D(X, 100, Y, 45, Z, 9, C, 2, T, 1), tIndex5D(X, 97, Y, 40, Z, 8, C, 2, T, 1) };
+    const bpfChar* vRegionNames[] = { "whole image", "region" };
+    for (bpfSize vRegion = 0; vRegion < 2; ++vRegion) {
+      const tIndex5D& vBegin = vBegins[vRegion];
+      const tIndex5D& vEnd = vEnds[vRegion];
+      bpfSize vSize = (vEnd[X] - vBegin[X]) * (vEnd[Y] - vBegin[Y]) * (vEnd[Z] - vBegin[Z]) * (vEnd[C] - vBegin[C]);
+      bpfString vDescription = vName + " " + vRegionNames[vRegion];
+
+      std::vector<bpfUInt16> vExpected(vSize, 0);
+      bpImageReader<bpfUInt16> vReader(vFileName, 0, bpReaderTypes::cReadOptions());
+      vReader.ReadData(vBegin, vEnd, 0, vExpected.data());
+
+      // a value that the file does not hold, so that voxels the reader does not write are found
+      std::vector<bpfUInt16> vData(vSize, 65535);
+      bpUInt64 vRequests = ReadThroughStorage(vFileName, false, vBegin, vEnd, vData);
+      bpTestCheck(vData == vExpected, vDescription + ", a read through the storage equals a plain read");
+
+      vData.assign(vSize, 65535);
+      bpUInt64 vCoalescedRequests = ReadThroughStorage(vFileName, true, vBegin, vEnd, vData);
+      bpTestCheck(vData == vExpected, vDescription + ", mCoalesceChunkReads equals a plain read");
+      bpTestCheck(vCoalescedRequests < vRequests,
+        vDescription + ", " + std::to_string(vCoalescedRequests) + " coalesced requests instead of fewer than " + std::to_string(vRequests));
+    }
+  }
+  std::remove(vFileName.c_str());
+}
+
+
+int main()
+{
+  TestCoalesce();
+  return bpTestExitCode();
+}
@@ -0,0 +1,141 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/interface/bpImageReader.h"
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/test/bpTestFile.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+
+using namespace bpConverterTypes;
+
+
+// exact value of the IEEE half precision aBits
+static bpfFloat HalfToFloat(bpfUInt16 aBits)
+{
+  bpfFloat vSign = (aBits & 0x8000) ? -1.0f : 1.0f;
+  bpfInt32 vExponent = (aBits >> 10) & 0x1f;
+  bpfInt32 vMantissa = aBits & 0x3ff;
+  if (vExponent == 0x1f) {
+    return vMantissa ? NAN : vSign * INFINITY;
+  }
+  if (vExponent == 0) {
+    return vSign * std::ldexp(static_cast<bpfFloat>(vMantissa), -24);
+  }
+  return vSign * std::ldexp(static_cast<bpfFloat>(vMantissa | 0x400), vExponent - 25);
+}
+
+
+// the stored value of voxel aIndex of the dense region [aBegin, aEnd) of time point 0
+template<typename TDataType>
+static bpfFloat GetStoredValue(const tIndex5D& aBegin, const tIndex5D& aEnd, bpfSize aIndex)
+{
+  bpfSize vSizeX = aEnd[X] - aBegin[X];
+  bpfSize vSizeY = aEnd[Y] - aBegin[Y];
+  bpfSize vSizeZ = aEnd[Z] - aBegin[Z];
+  bpfSize vX = aIndex % vSizeX;
+  bpfSize vY = aIndex / vSizeX % vSizeY;
+  bpfSize vZ = aIndex / vSizeX / vSizeY % vSizeZ;
+  bpfSize vC = aIndex / vSizeX / vSizeY / vSizeZ;
+  return static_cast<bpfFloat>(static_cast<TDataType>(bpTestGetValue(aBegin[X] + vX, aBegin[Y] + vY, aBegin[Z] + vZ, aBegin[C] + vC, 0)));
+}
+
+
+/**
+ * Reads [aBegin, aEnd) with the three ReadDataConverted overloads and checks each voxel against
+ * a scalar value * aScale + aOffset: float32 exactly, uint8 rounded and clamped exactly, float16
+ * within its rounding error.
+ */
+template<typename TDataType>
+static void CheckConverted(bpImageReaderBaseInterface& aReader, const tIndex5D& aBegin, const tIndex5D& aEnd, bpfFloat aScale, bpfFloat aOffset, const bpfString& aDescription)
+{
+  bpfSize vSize = (aEnd[X] - aBegin[X]) * (aEnd[Y] - aBegin[Y]) * (aEnd[Z] - aBegin[Z]) * (aEnd[C] - aBegin[C]);
+  std::vector<bpFloat> vFloat(vSize, -1.0f);
+  std::vector<bpReaderTypes::cFloat16> vHalf(vSize, bpReaderTypes::cFloat16{ 0xffff });
+  std::vector<bpUInt8> vUInt8(vSize, 17);
+  aReader.ReadDataConverted(aBegin, aEnd, 0, vFloat.data(), aScale, aOffset);
+  aReader.ReadDataConverted(aBegin, aEnd, 0, vHalf.data(), aScale, aOffset);
+  aReader.ReadDataConverted(aBegin, aEnd, 0, vUInt8.data(), aScale, aOffset);
+
+  bpfSize vFloatErrors = 0;
+  bpfSize vHalfErrors = 0;
+  bpfSize vUInt8Errors = 0;
+  for (bpfSize vIndex = 0; vIndex < vSize; ++vIndex) {
+    bpfFloat vExpected = GetStoredValue<TDataType>(aBegin, aEnd, vIndex) * aScale + aOffset;
+    vFloatErrors += vFloat[vIndex] != vExpected;
+    vHalfErrors += !(std::abs(HalfToFloat(vHalf[vIndex].mBits) - vExpected) <= std::abs(vExpected) / 2048 + 1e-7f);
+    bpfFloat vClamped = std::min(std::max(vExpected, 0.0f), 255.0f);
+    vUInt8Errors += vUInt8[vIndex] != static_cast<bpUInt8>(std::nearbyint(vClamped));
+  }
+  bpTestCheck(vFloatErrors == 0, aDescription + " float32, " + std::to_string(vFloatErrors) + " wrong voxels");
+  bpTestCheck(vHalfErrors == 0, aDescription + " float16, " + std::to_string(vHalfErrors) + " wrong voxels");
+  bpTestCheck(vUInt8Errors == 0, aDescription + " uint8, " + std::to_string(vUInt8Errors) + " wrong voxels");
+}
+
+
+/**
+ * Opens a file of TDataType through CreateImageReader and checks ReadDataConverted for rows of
+ * 1 to 70 voxels, so that the SIMD loops of the conversion cover none, some or most of each row
+ * and leave scalar tails of every length.
+ */
+template<typename TDataType>
+static void TestConverted(const bpfString& aTypeName)
+{
+  bpTestFileLayout vLayout;
+  vLayout.mSizeX = 70;
+  vLayout.mSizeY = 37;
+  vLayout.mSizeZ = 5;
+  vLayout.mSizeC = 2;
+  vLayout.mBlockSizeX = 32;
+  vLayout.mBlockSizeY = 16;
+  vLayout.mBlockSizeZ = 4;
+  vLayout.mCompression = bpTestFileLayout::eCompressionGzip;
+  const bpfString vFileName = "bpImageReaderConvertedTest.ims";
+  if (!bpTestCheck(bpTestWriteFile<TDataType>(vFileName, vLayout), "write " + aTypeName)) {
+    return;
+  }
+
+  bpReaderTypes::cReadOptions vOptions;
+  bpUniquePtr<bpImageReaderBaseInterface> vReader = CreateImageReader(vFileName, 0, vOptions);
+  bpTestCheck(!CreateImageReader(vFileName, 1, vOptions), aTypeName + " no reader for a missing image");
+  if (!bpTestCheck(vReader != nullptr, aTypeName + " CreateImageReader")) {
+    return;
+  }
+
+  for (bpfSize vSizeX = 1; vSizeX <= 17; ++vSizeX) {
+    CheckConverted<TDataType>(*vReader, tIndex5D(X, 3, Y, 2, Z, 1, C, 0, T, 0), tIndex5D(X, 3 + vSizeX, Y, 5, Z, 3, C, 2, T, 1), 0.37f, 1.3f,
+      aTypeName + " rows of " + std::to_string(vSizeX));
+  }
+  CheckConverted<TDataType>(*vReader, tIndex5D(X, 0, Y, 0, Z, 0, C, 0, T, 0), tIndex5D(X, 70, Y, 37, Z, 5, C, 2, T, 1), 1.0f, 0.0f, aTypeName + " whole image");
+  CheckConverted<TDataType>(*vReader, tIndex5D(X, 5, Y, 3, Z, 2, C, 1, T, 0), tIndex5D(X, 66, Y, 30, Z, 5, C, 2, T, 1), -0.25f, 200.0f, aTypeName + " negative scale");
+  vReader.reset();
+  std::remove(vFileName.c_str());
+}
+
+
+int main()
+{
+  TestConverted<bpfUInt8>("uint8");
+  TestConverted<bpfUInt16>("uint16");
+  TestConverted<bpfUInt32>("uint32");
+  TestConverted<bpfFloat>("float");
+  return bpTestExitCode();
+}
@@ -0,0 +1,189 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/interface/bpImageReader.h"
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/test/bpTestFile.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+
+using namespace bpConverterTypes;
+
+
+// the stored value of voxel (aX, aY, aZ) of channel aC, time point 0
+template<typename TDataType>
+static bpfFloat GetStoredValue(bpfSize aX, bpfSize aY, bpfSize aZ, bpfSize aC)
+{
+  return static_cast<bpfFloat>(static_cast<TDataType>(bpTestGetValue(aX, aY, aZ, aC, 0)));
+}
+
+
+// the color info of channel aC, or the defaults if aColorInfoPerChannel has no entry for it
+static cColorInfo GetColorInfo(const tColorInfoVector& aColorInfoPerChannel, bpfSize aC)
+{
+  return aC < aColorInfoPerChannel.size() ? aColorInfoPerChannel[aC] : cColorInfo();
+}
+
+
+/**
+ * Reads [aBegin, aEnd) with ReadDataDisplay and checks each voxel against the intensity of
+ * cColorInfo::GetColor for a white base color, rounded to [0, 255]. Binned lookup tables may
+ * round the other way, so a difference of 1 is allowed.
+ */
+template<typename TDataType>
+static void CheckDisplay(bpImageReaderBaseInterface& aReader, const tIndex5D& aBegin, const tIndex5D& aEnd, const tColorInfoVector& aColorInfoPerChannel, const bpfString& aDescription)
+{
+  bpfSize vSizeX = aEnd[X] - aBegin[X];
+  bpfSize vSizeY = aEnd[Y] - aBegin[Y];
+  bpfSize vSizeZ = aEnd[Z] - aBegin[Z];
+  std::vector<bpUInt8> vData(vSizeX * vSizeY * vSizeZ * (aEnd[C] - aBegin[C]), 0);
+  aReader.ReadDataDisplay(aBegin, aEnd, 0, vData.data(), aColorInfoPerChannel);
+
+  bpfSize vErrors = 0;
+  bpfSize vIndex = 0;
+  for (bpfSize vC = aBegin[C]; vC < aEnd[C]; ++vC) {
+    cColorInfo vColorInfo = GetColorInfo(aColorInfoPerChannel, vC);
+    vColorInfo.mIsBaseColorMode = true;
+    vColorInfo.mBaseColor = cColor{ 1, 1, 1, 1 };
+    for (bpfSize vZ = aBegin[Z]; vZ < aEnd[Z]; ++vZ) {
+      for (bpfSize vY = aBegin[Y]; vY < aEnd[Y]; ++vY) {
+        for (bpfSize vX = aBegin[X]; vX < aEnd[X]; ++vX, ++vIndex) {
+          bpfFloat vIntensity = vColorInfo.GetColor(GetStoredValue<TDataType>(vX, vY, vZ, vC)).mRed;
+          bpfInt32 vExpected = static_cast<bpfInt32>(std::nearbyint(vIntensity * 255.0f));
+          vErrors += std::abs(vData[vIndex] - vExpected) > 1;
+        }
+      }
+    }
+  }
+  bpTestCheck(vErrors == 0, aDescription + ", " + std::to_string(vErrors) + " wrong voxels");
+}
+
+
+/**
+ * Reads [aBegin, aEnd) with ReadDataRGBA and checks each voxel against the sum over the channels of
+ * cColorInfo::GetColor times mOpacity, saturating at 255. Each channel may round the other way.
+ * Time points past the end of the image are black.
+ */
+template<typename TDataType>
+static void CheckRGBA(bpImageReaderBaseInterface& aReader, const tIndex5D& aBegin, const tIndex5D& aEnd, bpfSize aSizeT, const tColorInfoVector& aColorInfoPerChannel, const bpfString& aDescription)
+{
+  bpfSize vSizeX = aEnd[X] - aBegin[X];
+  bpfSize vSizeY = aEnd[Y] - aBegin[Y];
+  bpfSize vSizeZ = aEnd[Z] - aBegin[Z];
+  bpfSize vNumberOfVoxels = vSizeX * vSizeY * vSizeZ;
+  bpfInt32 vNumberOfChannels = static_cast<bpfInt32>(aEnd[C] - aBegin[C]);
+  std::vector<bpUInt8> vData(vNumberOfVoxels * (aEnd[T] - aBegin[T]) * 4, 17);
+  aReader.ReadDataRGBA(aBegin, aEnd, 0, vData.data(), aColorInfoPerChannel);
+
+  bpfSize vErrors = 0;
+  for (bpfSize vT = aBegin[T]; vT < aEnd[T]; ++vT) {
+    const bpUInt8* vImage = vData.data() + vNumberOfVoxels * (vT - aBegin[T]) * 4;
+    for (bpfSize vIndex = 0; vIndex < vNumberOfVoxels; ++vIndex) {
+      bpfSize vX = aBegin[X] + vIndex % vSizeX;
+      bpfSize vY = aBegin[Y] + vIndex / vSizeX % vSizeY;
+      bpfSize vZ = aBegin[Z] + vIndex / vSizeX / vSizeY;
+      bpfFloat vSum[4] = { 0, 0, 0, 0 };
+      for (bpfSize vC = aBegin[C]; vT < aSizeT && vC < aEnd[C]; ++vC) {
+        cColorInfo vColorInfo = GetColorInfo(aColorInfoPerChannel, vC);
+        cColor vColor = vColorInfo.GetColor(GetStoredValue<TDataType>(vX, vY, vZ, vC));
+        bpfFloat vComponents[4] = { vColor.mRed, vColor.mGreen, vColor.mBlue, vColor.mAlpha };
+        for (bpfSize vComponent = 0; vComponent < 4; ++vComponent) {
+          vSum[vComponent] += std::min(std::max(vComponents[vComponent] * vColorInfo.mOpacity, 0.0f), 1.0f) * 255.0f;
+        }
+      }
+      for (bpfSize vComponent = 0; vComponent < 4; ++vComponent) {
+        bpfInt32 vExpected = static_cast<bpfInt32>(std::min(vSum[vComponent], 255.0f));
+        vErrors += std::abs(vImage[vIndex * 4 + vComponent] - vExpected) > vNumberOfChannels;
+      }
+    }
+  }
+  bpTestCheck(vErrors == 0, aDescription + ", " + std::to_string(vErrors) + " wrong components");
+}
+
+
+/**
+ * Opens a file of TDataType through CreateImageReader and checks ReadDataDisplay and ReadDataRGBA
+ * with a linear and a gamma corrected window, and for a channel without color info, on rows of 1 to
+ * 17 voxels so that the SIMD loops leave scalar tails of every length. ReadDataRGBA is checked again
+ * after the color infos change, as its channel tables are cached.
+ */
+template<typename TDataType>
+static void TestDisplay(const bpfString& aTypeName)
+{
+  bpTestFileLayout vLayout;
+  vLayout.mSizeX = 70;
+  vLayout.mSizeY = 37;
+  vLayout.mSizeZ = 5;
+  vLayout.mSizeC = 3;
+  vLayout.mBlockSizeX = 32;
+  vLayout.mBlockSizeY = 16;
+  vLayout.mBlockSizeZ = 4;
+  vLayout.mCompression = bpTestFileLayout::eCompressionGzip;
+  const bpfString vFileName = "bpImageReaderDisplayTest.ims";
+  if (!bpTestCheck(bpTestWriteFile<TDataType>(vFileName, vLayout), "write " + aTypeName)) {
+    return;
+  }
+
+  tColorInfoVector vColorInfoPerChannel(2);
+  vColorInfoPerChannel[0].mRangeMin = 10;
+  vColorInfoPerChannel[0].mRangeMax = 900;
+  vColorInfoPerChannel[1].mRangeMin = 100;
+  vColorInfoPerChannel[1].mRangeMax = 400;
+  vColorInfoPerChannel[1].mGammaCorrection = 2.2f;
+
+  bpReaderTypes::cReadOptions vOptions;
+  bpUniquePtr<bpImageReaderBaseInterface> vReader = CreateImageReader(vFileName, 0, vOptions);
+  if (!bpTestCheck(vReader != nullptr, aTypeName + " CreateImageReader")) {
+    return;
+  }
+
+  for (bpfSize vSizeX = 1; vSizeX <= 17; ++vSizeX) {
+    CheckDisplay<TDataType>(*vReader, tIndex5D(X, 3, Y, 2, Z, 1, C, 0, T, 0), tIndex5D(X, 3 + vSizeX, Y, 5, Z, 3, C, 3, T, 1), vColorInfoPerChannel,
+      aTypeName + " rows of " + std::to_string(vSizeX));
+  }
+  CheckDisplay<TDataType>(*vReader, tIndex5D(X, 0, Y, 0, Z, 0, C, 0, T, 0), tIndex5D(X, 70, Y, 37, Z, 5, C, 3, T, 1), vColorInfoPerChannel, aTypeName + " whole image");
+  CheckDisplay<TDataType>(*vReader, tIndex5D(X, 5, Y, 3, Z, 2, C, 1, T, 0), tIndex5D(X, 66, Y, 30, Z, 5, C, 3, T, 1), vColorInfoPerChannel, aTypeName + " region");
+
+  vColorInfoPerChannel[0].mBaseColor = cColor{ 1, 0.5f, 0, 1 };
+  vColorInfoPerChannel[1].mBaseColor = cColor{ 0.2f, 0.6f, 1, 1 };
+  vColorInfoPerChannel[1].mOpacity = 0.7f;
+  for (bpfSize vSizeX = 1; vSizeX <= 17; ++vSizeX) {
+    CheckRGBA<TDataType>(*vReader, tIndex5D(X, 3, Y, 2, Z, 1, C, 0, T, 0), tIndex5D(X, 3 + vSizeX, Y, 5, Z, 3, C, 3, T, 1), vLayout.mSizeT, vColorInfoPerChannel,
+      aTypeName + " rgba rows of " + std::to_string(vSizeX));
+  }
+  CheckRGBA<TDataType>(*vReader, tIndex5D(X, 0, Y, 0, Z, 0, C, 0, T, 0), tIndex5D(X, 70, Y, 37, Z, 5, C, 3, T, 2), vLayout.mSizeT, vColorInfoPerChannel, aTypeName + " rgba whole image");
+  CheckRGBA<TDataType>(*vReader, tIndex5D(X, 5, Y, 3, Z, 2, C, 1, T, 0), tIndex5D(X, 66, Y, 30, Z, 5, C, 2, T, 1), vLayout.mSizeT, vColorInfoPerChannel, aTypeName + " rgba region");
+  vColorInfoPerChannel[0].mOpacity = 0.4f;
+  vColorInfoPerChannel[1].mRangeMax = 300;
+  CheckRGBA<TDataType>(*vReader, tIndex5D(X, 0, Y, 0, Z, 0, C, 0, T, 0), tIndex5D(X, 70, Y, 37, Z, 5, C, 3, T, 1), vLayout.mSizeT, vColorInfoPerChannel, aTypeName + " rgba changed color infos");
+  vReader.reset();
+  std::remove(vFileName.c_str());
+}
+
+
+int main()
+{
+  TestDisplay<bpfUInt8>("uint8");
+  TestDisplay<bpfUInt16>("uint16");
+  TestDisplay<bpfUInt32>("uint32");
+  TestDisplay<bpfFloat>("float");
+  return bpTestExitCode();
+}
@@ -0,0 +1,123 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/interface/bpImageReader.h"
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/test/bpTestFile.h"
+#include "ImarisReader/utils/bpfH5ChunkDecoder.h"
+#include "ImarisReader/utils/bpfThreadPool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+
+using namespace bpConverterTypes;
+
+
+/**
+ * Reads [aBegin, aEnd) with aReader and compares it with the same voxels of aExpected, which holds
+ * the whole dataset as hdf5 returned it (aDataDim in [z, y, x]).
+ */
+static void CheckRead(bpImageReader<bpfUInt16>& aReader, const std::vector<bpfUInt16>& aExpected, const hsize_t (&aDataDim)[3], const tIndex5D& aBegin, const tIndex5D& aEnd, const bpfString& aDescription)
+{
+  bpfSize vSizeX = aEnd[X] - aBegin[X];
+  bpfSize vSizeY = aEnd[Y] - aBegin[Y];
+  bpfSize vSizeZ = aEnd[Z] - aBegin[Z];
+  std::vector<bpfUInt16> vData(vSizeX * vSizeY * vSizeZ, 0);
+  aReader.ReadData(aBegin, aEnd, 0, vData.data());
+
+  bpfSize vNumberOfErrors = 0;
+  for (bpfSize vZ = 0; vZ < vSizeZ; ++vZ) {
+    for (bpfSize vY = 0; vY < vSizeY; ++vY) {
+      for (bpfSize vX = 0; vX < vSizeX; ++vX) {
+        bpfSize vIndex = ((aBegin[Z] + vZ) * aDataDim[1] + aBegin[Y] + vY) * aDataDim[2] + aBegin[X] + vX;
+        if (vData[(vZ * vSizeY + vY) * vSizeX + vX] != aExpected[vIndex]) {
+          ++vNumberOfErrors;
+        }
+      }
+    }
+  }
+  bpTestCheck(vNumberOfErrors == 0, aDescription + " equals H5Dread");
+}
+
+
+/**
+ * Checks the lz4 decode against hdf5's own read of the file through the filter, for lz4 and
+ * shuffle + lz4 chunks of several lz4 blocks:
+ * - bpfH5ChunkDecoder::Decode of the raw chunks, on a thread pool and on the calling thread
+ * - ReadData with mParallelDecode of a single chunk, a part of it, and the whole image
+ */
+int main()
+{
+  bpTestFileLayout vLayout;
+  vLayout.mSizeX = 256;
+  vLayout.mSizeY = 256;
+  vLayout.mSizeZ = 32;
+  // 2MB chunks of 64KB lz4 blocks
+  vLayout.mBlockSizeX = 256;
+  vLayout.mBlockSizeY = 256;
+  vLayout.mBlockSizeZ = 16;
+  const bpfString vFileName = "bpImageReaderLZ4Test.ims";
+  bpfThreadPool vThreadPool(4);
+
+  for (bpTestFileLayout::tCompression vCompression : { bpTestFileLayout::eCompressionLZ4, bpTestFileLayout::eCompressionShuffleLZ4 }) {
+    vLayout.mCompression = vCompression;
+    bpfString vName = vCompression == bpTestFileLayout::eCompressionLZ4 ? "lz4" : "shuffle lz4";
+    if (!bpTestCheck(bpTestWriteFile(vFileName, vLayout), "write " + vName + " " + vFileName)) {
+      continue;
+    }
+
+    // the reference, decoded by hdf5 through the registered filter
+    hid_t vFileId = H5Fopen(vFileName.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t vDataId = H5Dopen2(vFileId, "DataSet/ResolutionLevel 0/TimePoint 0/Channel 0/Data", H5P_DEFAULT);
+    hsize_t vDataDim[3] = { vLayout.mSizeZ, vLayout.mSizeY, vLayout.mSizeX };
+    std::vector<bpfUInt16> vExpected(vDataDim[0] * vDataDim[1] * vDataDim[2]);
+    bpTestCheck(H5Dread(vDataId, H5T_NATIVE_UINT16, H5S_ALL, H5S_ALL, H5P_DEFAULT, vExpected.data()) >= 0, vName + " H5Dread");
+
+    bpfH5ChunkDecoder vDecoder(vDataId, H5T_NATIVE_UINT16);
+    bpTestCheck(vDecoder.IsSupported(), vName + " decoder supports the filters");
+    bpfSize vChunkElements = vLayout.mBlockSizeX * vLayout.mBlockSizeY * vLayout.mBlockSizeZ;
+    for (hsize_t vChunkZ = 0; vChunkZ < vDataDim[0]; vChunkZ += vLayout.mBlockSizeZ) {
+      hsize_t vOffset[3] = { vChunkZ, 0, 0 };
+      hsize_t vStorageSize = 0;
+      H5Dget_chunk_storage_size(vDataId, vOffset, &vStorageSize);
+      std::vector<bpfUInt8> vRaw(vStorageSize);
+      bpfUInt32 vFilterMask = 0;
+      bpTestCheck(H5Dread_chunk(vDataId, H5P_DEFAULT, vOffset, &vFilterMask, vRaw.data()) >= 0, vName + " H5Dread_chunk");
+      for (bpfThreadPool* vPool : { static_cast<bpfThreadPool*>(nullptr), &vThreadPool }) {
+        std::vector<bpfUInt16> vChunk(vChunkElements, 0);
+        bool vIsDecoded = vDecoder.Decode(vRaw.data(), vRaw.size(), vFilterMask, reinterpret_cast<bpfUInt8*>(vChunk.data()), vChunkElements * sizeof(bpfUInt16), vPool);
+        bool vIsEqual = std::equal(vChunk.begin(), vChunk.end(), vExpected.begin() + vChunkZ * vDataDim[1] * vDataDim[2]);
+        bpTestCheck(vIsDecoded && vIsEqual, vName + " chunk decoded " + (vPool ? "on the thread pool" : "on the calling thread") + " equals H5Dread");
+      }
+    }
+    H5Dclose(vDataId);
+    H5Fclose(vFileId);
+
+    bpReaderTypes::cReadOptions vOptions;
+    vOptions.mParallelDecode = true;
+    vOptions.mNumberOfDecodeThreads = 4;
+    bpImageReader<bpfUInt16> vReader(vFileName, 0, vOptions);
+    CheckRead(vReader, vExpected, vDataDim, tIndex5D(X, 0, Y, 0, Z, 0, C, 0, T, 0), tIndex5D(X, 256, Y, 256, Z, 16, C, 1, T, 1), vName + " one chunk");
+    CheckRead(vReader, vExpected, vDataDim, tIndex5D(X, 10, Y, 5, Z, 19, C, 0, T, 0), tIndex5D(X, 201, Y, 250, Z, 30, C, 1, T, 1), vName + " part of a chunk");
+    CheckRead(vReader, vExpected, vDataDim, tIndex5D(X, 0, Y, 0, Z, 0, C, 0, T, 0), tIndex5D(X, 256, Y, 256, Z, 32, C, 1, T, 1), vName + " whole image");
+  }
+
+  std::remove(vFileName.c_str());
+  return bpTestExitCode();
+}
@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/interface/bpImageReader.h"
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/test/bpTestFile.h"
+
+#include <cstdio>
+#include <vector>
+
+
+using namespace bpConverterTypes;
+
+
+/**
+ * Reads [aBegin, aEnd) with aReader and aParallelReader and checks that both return the same voxels.
+ */
+template<typename TDataType>
+static void CheckReads(bpImageReader<TDataType>& aReader, bpImageReader<TDataType>& aParallelReader, const tIndex5D& aBegin, const tIndex5D& aEnd, const bpfString& aDescription)
+{
+  bpfSize vSize = (aEnd[X] - aBegin[X]) * (aEnd[Y] - aBegin[Y]) * (aEnd[Z] - aBegin[Z]) * (aEnd[C] - aBegin[C]) * (aEnd[T] - aBegin[T]);
+  std::vector<TDataType> vExpected(vSize, 0);
+  aReader.ReadData(aBegin, aEnd, 0, vExpected.data());
+  // a value that the file does not hold, so that voxels the reader does not write are found
+  std::vector<TDataType> vData(vSize, static_cast<TDataType>(255));
+  aParallelReader.ReadData(aBegin, aEnd, 0, vData.data());
+  bpTestCheck(vData == vExpected, aDescription + ", mParallelDecode equals a plain read");
+}
+
+
+/**
+ * Writes files of TDataType with each compression and compares the reads of a reader with
+ * mParallelDecode, with 1 and 4 decode threads, to those of a plain reader: single chunks,
+ * regions that cut chunks, several channels and time points, and the whole image.
+ */
+template<typename TDataType>
+static void TestParallelDecode(const bpfString& aTypeName)
+{
+  bpTestFileLayout vLayout;
+  vLayout.mSizeX = 100;
+  vLayout.mSizeY = 45;
+  vLayout.mSizeZ = 9;
+  vLayout.mSizeC = 2;
+  vLayout.mSizeT = 2;
+  vLayout.mBlockSizeX = 32;
+  vLayout.mBlockSizeY = 16;
+  vLayout.mBlockSizeZ = 4;
+  const bpfString vFileName = "bpImageReaderParallelDecodeTest.ims";
+
+  const bpfChar* vCompressionNames[] = { "none", "gzip", "shuffle gzip", "lz4", "shuffle lz4" };
+  for (bpfSize vCompression = 0; vCompression < 5; ++vCompression) {
+    vLayout.mCompression = static_cast<bpTestFileLayout::tCompression>(vCompression);
+    bpfString vName = aTypeName + " " + vCompressionNames[vCompression];
+    if (!bpTestCheck(bpTestWriteFile<TDataType>(vFileName, vLayout), "write " + vName)) {
+      continue;
+    }
+
+    bpReaderTypes::cReadOptions vOptions;
+    bpImageReader<TDataType> vReader(vFileName, 0, vOptions);
+    for (bpfSize vNumberOfThreads : { 1, 4 }) {
+      vOptions.mParallelDecode = true;
+      vOptions.mNumberOfDecodeThreads = vNumberOfThreads;
+      bpImageReader<TDataType> vParallelReader(vFileName, 0, vOptions);
+      bpfString vDescription = vName + ", " + std::to_string(vNumberOfThreads) + " threads";
+
+      CheckReads(vReader, vParallelReader, tIndex5D(X, 32, Y, 16, Z, 4, C, 1, T, 0), tIndex5D(X, 64, Y, 32, Z, 8, C, 2, T, 1), vDescription + " one chunk");
+      CheckReads(vReader, vParallelReader, tIndex5D(X, 5, Y, 3, Z, 1, C, 0, T, 0), tIndex5D(X, 97, Y, 40, Z, 8, C, 2, T, 2), vDescription + " region");
+      CheckReads(vReader, vParallelReader, tIndex5D(X, 90, Y, 40, Z, 8, C, 0, T, 1), tIndex5D(X, 100, Y, 45, Z, 9, C, 1, T, 2), vDescription + " border chunk");
+      CheckReads(vReader, vParallelReader, tIndex5D(X, 0, Y, 0, Z, 0, C, 0, T, 0), tIndex5D(X, 100, Y, 45, Z, 9, C, 2, T, 2), vDescription + " whole image");
+    }
+  }
+  std::remove(vFileName.c_str());
+}
+
+
+int main()
+{
+  TestParallelDecode<bpfUInt8>("uint8");
+  TestParallelDecode<bpfUInt16>("uint16");
+  TestParallelDecode<bpfUInt32>("uint32");
+  TestParallelDecode<bpfFloat>("float");
+  return bpTestExitCode();
+}
@@ -0,0 +1,135 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/interface/bpImageReader.h"
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/test/bpTestFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+
+using namespace bpConverterTypes;
+
+
+/**
+ * Plans [aBegin, aEnd) and checks that:
+ * - each item lies inside its chunk, of the size the file was written with, and inside the read
+ * - the items cover each voxel of the read inside the image exactly once and none outside of it
+ * - mDestinationOffset points to the voxels of the item in the dense ReadData destination
+ */
+static void CheckPlan(bpImageReaderBaseInterface& aReader, const bpTestFileLayout& aLayout, const tIndex5D& aBegin, const tIndex5D& aEnd, const bpfString& aDescription)
+{
+  std::vector<bpReaderTypes::cReadPlanItem> vItems = aReader.PlanRead(aBegin, aEnd, 0);
+
+  bpSize vSize[] = { aEnd[X] - aBegin[X], aEnd[Y] - aBegin[Y], aEnd[Z] - aBegin[Z], aEnd[C] - aBegin[C], aEnd[T] - aBegin[T] };
+  bpSize vImageSize[] = { aLayout.mSizeX, aLayout.mSizeY, aLayout.mSizeZ };
+  bpSize vChunkSize[] = { std::min(aLayout.mBlockSizeX, aLayout.mSizeX), std::min(aLayout.mBlockSizeY, aLayout.mSizeY), std::min(aLayout.mBlockSizeZ, aLayout.mSizeZ) };
+  bpSize vBegin[] = { aBegin[X], aBegin[Y], aBegin[Z] };
+  bpSize vEnd[] = { aEnd[X], aEnd[Y], aEnd[Z] };
+  std::vector<bpfSize> vCoverage(vSize[0] * vSize[1] * vSize[2] * vSize[3] * vSize[4], 0);
+
+  bpfSize vItemErrors = 0;
+  bpfSize vOffsetErrors = 0;
+  for (const bpReaderTypes::cReadPlanItem& vItem : vItems) {
+    bool vIsValid = vItem.mTimePointIndex >= aBegin[T] && vItem.mTimePointIndex < std::min<bpSize>(aEnd[T], aLayout.mSizeT) &&
+      vItem.mChannelIndex >= aBegin[C] && vItem.mChannelIndex < std::min<bpSize>(aEnd[C], aLayout.mSizeC);
+    for (bpfSize vDim = 0; vDim < 3; ++vDim) {
+      vIsValid = vIsValid && vItem.mChunkSize[vDim] == vChunkSize[vDim] && vItem.mBegin[vDim] < vItem.mEnd[vDim] &&
+        vItem.mBegin[vDim] >= vItem.mChunkIndex[vDim] * vChunkSize[vDim] && vItem.mEnd[vDim] <= (vItem.mChunkIndex[vDim] + 1) * vChunkSize[vDim] &&
+        vItem.mBegin[vDim] >= vBegin[vDim] && vItem.mEnd[vDim] <= std::min(vEnd[vDim], vImageSize[vDim]);
+    }
+    if (!vIsValid) {
+      ++vItemErrors;
+      continue;
+    }
+
+    bpfSize vDenseOffset = (((vItem.mTimePointIndex - aBegin[T]) * vSize[3] + vItem.mChannelIndex - aBegin[C]) * vSize[2] + vItem.mBegin[2] - aBegin[Z]) * vSize[1] * vSize[0] +
+      (vItem.mBegin[1] - aBegin[Y]) * vSize[0] + vItem.mBegin[0] - aBegin[X];
+    vOffsetErrors += vItem.mDestinationOffset != vDenseOffset;
+    for (bpfSize vZ = vItem.mBegin[2]; vZ < vItem.mEnd[2]; ++vZ) {
+      for (bpfSize vY = vItem.mBegin[1]; vY < vItem.mEnd[1]; ++vY) {
+        for (bpfSize vX = vItem.mBegin[0]; vX < vItem.mEnd[0]; ++vX) {
+          ++vCoverage[vDenseOffset + ((vZ - vItem.mBegin[2]) * vSize[1] + vY - vItem.mBegin[1]) * vSize[0] + vX - vItem.mBegin[0]];
+        }
+      }
+    }
+  }
+
+  bpfSize vCoverageErrors = 0;
+  bpfSize vIndex = 0;
+  for (bpfSize vT = aBegin[T]; vT < aEnd[T]; ++vT) {
+    for (bpfSize vC = aBegin[C]; vC < aEnd[C]; ++vC) {
+      for (bpfSize vZ = aBegin[Z]; vZ < aEnd[Z]; ++vZ) {
+        for (bpfSize vY = aBegin[Y]; vY < aEnd[Y]; ++vY) {
+          for (bpfSize vX = aBegin[X]; vX < aEnd[X]; ++vX, ++vIndex) {
+            bool vIsInside = vX < aLayout.mSizeX && vY < aLayout.mSizeY && vZ < aLayout.mSizeZ && vC < aLayout.mSizeC && vT < aLayout.mSizeT;
+            vCoverageErrors += vCoverage[vIndex] != (vIsInside ? 1u : 0u);
+          }
+        }
+      }
+    }
+  }
+  bpTestCheck(vItemErrors == 0, aDescription + ", " + std::to_string(vItemErrors) + " items outside of their chunk or the read");
+  bpTestCheck(vOffsetErrors == 0, aDescription + ", " + std::to_string(vOffsetErrors) + " wrong destination offsets");
+  bpTestCheck(vCoverageErrors == 0, aDescription + ", " + std::to_string(vCoverageErrors) + " voxels not covered exactly once");
+}
+
+
+/**
+ * Writes files with chunks that divide the image evenly, unevenly and that are larger than the
+ * image, and checks the plans of single chunks, regions that cut chunks, reads past the end of
+ * the image and the whole image.
+ */
+static void TestPlanRead()
+{
+  const bpfString vFileName = "bpImageReaderPlanReadTest.ims";
+  bpTestFileLayout vLayout;
+  vLayout.mSizeC = 2;
+  vLayout.mSizeT = 2;
+
+  bpfSize vBlockSizes[][3] = { { 32, 16, 4 }, { 24, 10, 3 }, { 128, 64, 16 } };
+  for (const auto& vBlockSize : vBlockSizes) {
+    vLayout.mSizeX = 70;
+    vLayout.mSizeY = 37;
+    vLayout.mSizeZ = 9;
+    vLayout.mBlockSizeX = vBlockSize[0];
+    vLayout.mBlockSizeY = vBlockSize[1];
+    vLayout.mBlockSizeZ = vBlockSize[2];
+    bpfString vName = "chunks " + std::to_string(vBlockSize[0]) + "x" + std::to_string(vBlockSize[1]) + "x" + std::to_string(vBlockSize[2]);
+    if (!bpTestCheck(bpTestWriteFile(vFileName, vLayout), "write " + vName)) {
+      continue;
+    }
+
+    bpReaderTypes::cReadOptions vOptions;
+    bpImageReader<bpfUInt16> vReader(vFileName, 0, vOptions);
+    CheckPlan(vReader, vLayout, tIndex5D(X, 0, Y, 0, Z, 0, C, 0, T, 0), tIndex5D(X, 70, Y, 37, Z, 9, C, 2, T, 2), vName + " whole image");
+    CheckPlan(vReader, vLayout, tIndex5D(X, 0, Y, 0, Z, 0, C, 1, T, 1), tIndex5D(X, vBlockSize[0], Y, vBlockSize[1], Z, vBlockSize[2], C, 2, T, 2), vName + " first chunk");
+    CheckPlan(vReader, vLayout, tIndex5D(X, 5, Y, 3, Z, 1, C, 0, T, 0), tIndex5D(X, 61, Y, 33, Z, 8, C, 2, T, 1), vName + " region");
+    CheckPlan(vReader, vLayout, tIndex5D(X, 66, Y, 30, Z, 7, C, 1, T, 1), tIndex5D(X, 80, Y, 40, Z, 12, C, 3, T, 3), vName + " past the end");
+    CheckPlan(vReader, vLayout, tIndex5D(X, 31, Y, 15, Z, 3, C, 0, T, 0), tIndex5D(X, 33, Y, 17, Z, 5, C, 1, T, 1), vName + " across chunk borders");
+  }
+  std::remove(vFileName.c_str());
+}
+
+
+int main()
+{
+  TestPlanRead();
+  return bpTestExitCode();
+}
@@ -0,0 +1,99 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/interface/bpImageReaderPool.h"
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/test/bpTestFile.h"
+
+#include <cstdio>
+#include <vector>
+
+
+using namespace bpConverterTypes;
+
+
+static void CheckStatistics(bpImageReaderPool& aPool, bpUInt64 aHits, bpUInt64 aOpens, bpUInt64 aEvictions, bpSize aNumberOfOpenReaders, const bpfString& aDescription)
+{
+  bpReaderTypes::cReaderPoolStatistics vStatistics = aPool.GetStatistics();
+  bpTestCheck(vStatistics.mHits == aHits, aDescription + ", " + std::to_string(vStatistics.mHits) + " hits instead of " + std::to_string(aHits));
+  bpTestCheck(vStatistics.mOpens == aOpens, aDescription + ", " + std::to_string(vStatistics.mOpens) + " opens instead of " + std::to_string(aOpens));
+  bpTestCheck(vStatistics.mEvictions == aEvictions, aDescription + ", " + std::to_string(vStatistics.mEvictions) + " evictions instead of " + std::to_string(aEvictions));
+  bpTestCheck(vStatistics.mNumberOfOpenReaders == aNumberOfOpenReaders,
+    aDescription + ", " + std::to_string(vStatistics.mNumberOfOpenReaders) + " open readers instead of " + std::to_string(aNumberOfOpenReaders));
+}
+
+
+/**
+ * Checks the hit, open and eviction counters of a pool of 2 readers over 3 files: held readers
+ * exceed the bound and are closed once released, evicted readers are opened again, failed opens
+ * are not cached, and handles may outlive the pool.
+ */
+static void TestPool(const std::vector<bpfString>& aFileNames)
+{
+  bpImageReaderPool vPool(2, bpReaderTypes::cReadOptions());
+  {
+    auto vReaderA = vPool.GetReader<bpfUInt16>(aFileNames[0], 0);
+    auto vReaderB = vPool.GetReader<bpfUInt16>(aFileNames[1], 0);
+    auto vReaderC = vPool.GetReader<bpfUInt16>(aFileNames[2], 0);
+    bpTestCheck(vReaderA && vReaderB && vReaderC, "open three files");
+    CheckStatistics(vPool, 0, 3, 0, 3, "three held readers exceed the bound");
+    bpTestCheck(vPool.GetReader<bpfUInt16>(aFileNames[0], 0) == vReaderA, "a second GetReader returns the open reader");
+    CheckStatistics(vPool, 1, 3, 0, 3, "hit");
+
+    // B is now the least recently used reader
+    vReaderB.reset();
+    CheckStatistics(vPool, 1, 3, 1, 2, "a released reader over the bound is closed");
+  }
+  CheckStatistics(vPool, 1, 3, 1, 2, "released readers within the bound stay open");
+
+  bpTestCheck(vPool.GetReader<bpfUInt16>(aFileNames[2], 0) != nullptr, "get an open reader");
+  CheckStatistics(vPool, 2, 3, 1, 2, "hit after release");
+  bpTestCheck(vPool.GetReader<bpfUInt16>(aFileNames[1], 0) != nullptr, "reopen an evicted reader");
+  CheckStatistics(vPool, 2, 4, 2, 2, "an evicted reader is opened again and evicts the least recently used one");
+
+  bpTestCheck(vPool.GetReader<bpfUInt16>("bpImageReaderPoolTestMissing.ims", 0) == nullptr, "a missing file has no reader");
+  CheckStatistics(vPool, 2, 4, 2, 2, "failed opens are not counted");
+
+  auto vReader = vPool.GetReader<bpfUInt16>(aFileNames[1], 0);
+  vPool.Clear();
+  CheckStatistics(vPool, 3, 4, 3, 1, "Clear keeps held readers");
+
+  // the handle of a reader keeps it alive after the pool is gone
+  bpImageReaderPool* vOtherPool = new bpImageReaderPool(1, bpReaderTypes::cReadOptions());
+  auto vOtherReader = vOtherPool->GetReader<bpfUInt16>(aFileNames[0], 0);
+  delete vOtherPool;
+  std::vector<bpfUInt16> vData(64);
+  vOtherReader->ReadData(tIndex5D(X, 0, Y, 0, Z, 0, C, 0, T, 0), tIndex5D(X, 64, Y, 1, Z, 1, C, 1, T, 1), 0, vData.data());
+  bpTestCheck(vData[5] == bpTestGetValue(5, 0, 0, 0, 0), "a reader is usable after its pool is destroyed");
+}
+
+
+int main()
+{
+  std::vector<bpfString> vFileNames = { "bpImageReaderPoolTestA.ims", "bpImageReaderPoolTestB.ims", "bpImageReaderPoolTestC.ims" };
+  bool vIsWritten = true;
+  for (const bpfString& vFileName : vFileNames) {
+    vIsWritten = bpTestCheck(bpTestWriteFile(vFileName, bpTestFileLayout()), "write " + vFileName) && vIsWritten;
+  }
+  if (vIsWritten) {
+    TestPool(vFileNames);
+  }
+  for (const bpfString& vFileName : vFileNames) {
+    std::remove(vFileName.c_str());
+  }
+  return bpTestExitCode();
+}
@@ -0,0 +1,130 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/interface/bpImageReader.h"
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/test/bpTestFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+
+using namespace bpConverterTypes;
+
+
+/**
+ * Reads [aBegin, aEnd) with the strided ReadData into channel interleaved rows that are padded by
+ * 3 voxels, and checks each voxel against aGetExpected and that the padding is left untouched.
+ */
+template<typename TDataType, typename TGetExpected>
+static void CheckStridedRead(bpImageReader<TDataType>& aReader, const tIndex5D& aBegin, const tIndex5D& aEnd, TDataType aFillValue, TGetExpected aGetExpected, const bpfString& aDescription)
+{
+  const TDataType vPadding = static_cast<TDataType>(99);
+  bpfSize vSizeX = aEnd[X] - aBegin[X];
+  bpfSize vSizeY = aEnd[Y] - aBegin[Y];
+  bpfSize vSizeZ = aEnd[Z] - aBegin[Z];
+  bpfSize vSizeC = aEnd[C] - aBegin[C];
+  bpfSize vRowSize = vSizeX * vSizeC + 3;
+  tSize5D vByteStrides(X, vSizeC * sizeof(TDataType), Y, vRowSize * sizeof(TDataType), Z, vRowSize * vSizeY * sizeof(TDataType),
+    C, sizeof(TDataType), T, vRowSize * vSizeY * vSizeZ * sizeof(TDataType));
+  std::vector<TDataType> vData(vRowSize * vSizeY * vSizeZ, vPadding);
+  aReader.ReadData(aBegin, aEnd, 0, vData.data(), vByteStrides, aFillValue);
+
+  bpfSize vErrors = 0;
+  for (bpfSize vZ = 0; vZ < vSizeZ; ++vZ) {
+    for (bpfSize vY = 0; vY < vSizeY; ++vY) {
+      const TDataType* vRow = vData.data() + (vZ * vSizeY + vY) * vRowSize;
+      for (bpfSize vX = 0; vX < vSizeX; ++vX) {
+        for (bpfSize vC = 0; vC < vSizeC; ++vC) {
+          TDataType vExpected = aGetExpected(aBegin[X] + vX, aBegin[Y] + vY, aBegin[Z] + vZ, aBegin[C] + vC);
+          vErrors += vRow[vX * vSizeC + vC] != vExpected;
+        }
+      }
+      for (bpfSize vX = vSizeX * vSizeC; vX < vRowSize; ++vX) {
+        vErrors += vRow[vX] != vPadding;
+      }
+    }
+  }
+  bpTestCheck(vErrors == 0, aDescription + ", " + std::to_string(vErrors) + " wrong voxels");
+}
+
+
+/**
+ * Checks the strided ReadData of TDataType for:
+ * - regions inside of the image, which hold bpTestGetValue
+ * - regions past the end of the image, where the voxels outside are set to the fill value of the call
+ * - chunks that were never written, which hold the fill value of the dataset, as through H5Dread
+ * once with a plain reader, which reads through H5Dread, and once per reader that reads raw chunks.
+ */
+template<typename TDataType>
+static void TestStride(const bpfString& aTypeName)
+{
+  bpTestFileLayout vLayout;
+  vLayout.mSizeX = 70;
+  vLayout.mSizeY = 37;
+  vLayout.mSizeZ = 9;
+  vLayout.mSizeC = 2;
+  vLayout.mBlockSizeX = 32;
+  vLayout.mBlockSizeY = 16;
+  vLayout.mBlockSizeZ = 4;
+  vLayout.mCompression = bpTestFileLayout::eCompressionGzip;
+  vLayout.mWrittenSizeZ = 4;
+  vLayout.mFillValue = 7;
+  const bpfString vFileName = "bpImageReaderStrideTest.ims";
+  if (!bpTestCheck(bpTestWriteFile<TDataType>(vFileName, vLayout), "write " + aTypeName)) {
+    return;
+  }
+
+  const TDataType vCallFillValue = static_cast<TDataType>(5);
+  auto vGetValue = [&](bpfSize aX, bpfSize aY, bpfSize aZ, bpfSize aC) {
+    if (aX >= vLayout.mSizeX || aY >= vLayout.mSizeY || aZ >= vLayout.mSizeZ) {
+      return vCallFillValue;
+    }
+    if (aZ >= vLayout.mWrittenSizeZ) {
+      return static_cast<TDataType>(vLayout.mFillValue);
+    }
+    return static_cast<TDataType>(bpTestGetValue(aX, aY, aZ, aC, 0));
+  };
+
+  for (bpfSize vMode = 0; vMode < 4; ++vMode) {
+    bpReaderTypes::cReadOptions vOptions;
+    vOptions.mParallelDecode = vMode == 1;
+    vOptions.mChunkCacheSizeBytes = vMode == 2 ? 16 << 20 : 0;
+    vOptions.mConcurrentReadData = vMode == 3;
+    const bpfChar* vModeNames[] = { "H5Dread", "parallel decode", "chunk cache", "concurrent" };
+    bpfString vName = aTypeName + " " + vModeNames[vMode];
+    bpImageReader<TDataType> vReader(vFileName, 0, vOptions);
+
+    CheckStridedRead(vReader, tIndex5D(X, 0, Y, 0, Z, 0, C, 0, T, 0), tIndex5D(X, 70, Y, 37, Z, 4, C, 2, T, 1), vCallFillValue, vGetValue, vName + " written planes");
+    CheckStridedRead(vReader, tIndex5D(X, 3, Y, 5, Z, 1, C, 1, T, 0), tIndex5D(X, 67, Y, 30, Z, 3, C, 2, T, 1), vCallFillValue, vGetValue, vName + " region");
+    CheckStridedRead(vReader, tIndex5D(X, 60, Y, 30, Z, 2, C, 0, T, 0), tIndex5D(X, 80, Y, 40, Z, 4, C, 2, T, 1), vCallFillValue, vGetValue, vName + " past the end");
+    CheckStridedRead(vReader, tIndex5D(X, 0, Y, 0, Z, 2, C, 0, T, 0), tIndex5D(X, 70, Y, 37, Z, 9, C, 2, T, 1), vCallFillValue, vGetValue, vName + " unwritten chunks");
+    CheckStridedRead(vReader, tIndex5D(X, 50, Y, 20, Z, 5, C, 0, T, 0), tIndex5D(X, 75, Y, 41, Z, 10, C, 1, T, 1), vCallFillValue, vGetValue, vName + " unwritten chunks past the end");
+  }
+  std::remove(vFileName.c_str());
+}
+
+
+int main()
+{
+  TestStride<bpfUInt8>("uint8");
+  TestStride<bpfUInt16>("uint16");
+  TestStride<bpfUInt32>("uint32");
+  TestStride<bpfFloat>("float");
+  return bpTestExitCode();
+}
@@ -0,0 +1,104 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/interface/bpImageReader.h"
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/test/bpTestFile.h"
+#include "ImarisReader/utils/bpfH5ChunkDecoder.h"
+
+#include <cstdio>
+#include <vector>
+
+
+using namespace bpConverterTypes;
+
+
+/**
+ * Reads [aBegin, aEnd) with each of aReaders and checks that all return what the first one read.
+ */
+template<typename TDataType>
+static void CheckReads(std::vector<bpImageReader<TDataType>*>& aReaders, const tIndex5D& aBegin, const tIndex5D& aEnd, const bpfString& aDescription)
+{
+  bpfSize vSize = (aEnd[X] - aBegin[X]) * (aEnd[Y] - aBegin[Y]) * (aEnd[Z] - aBegin[Z]) * (aEnd[C] - aBegin[C]);
+  std::vector<TDataType> vExpected(vSize, 0);
+  aReaders[0]->ReadData(aBegin, aEnd, 0, vExpected.data());
+  for (bpfSize vReader = 1; vReader < aReaders.size(); ++vReader) {
+    // a value that the file does not hold, so that voxels the reader does not write are found
+    std::vector<TDataType> vData(vSize, static_cast<TDataType>(255));
+    aReaders[vReader]->ReadData(aBegin, aEnd, 0, vData.data());
+    bpTestCheck(vData == vExpected, aDescription + ", reader " + std::to_string(vReader) + " equals H5Dread");
+  }
+}
+
+
+/**
+ * Writes shuffle + gzip and shuffle + lz4 files of TDataType and compares the unshuffle into the
+ * destination (mUnshuffleIntoDestination, once per region and once per whole chunk through the
+ * chunk cache) with a plain reader, which reads through H5Dread. The rows of the second chunk in x
+ * are 73 voxels long, so that the SIMD loops leave a scalar tail, and the regions start at odd offsets.
+ */
+template<typename TDataType>
+static void TestUnshuffle(const bpfString& aTypeName)
+{
+  bpTestFileLayout vLayout;
+  vLayout.mSizeX = 150;
+  vLayout.mSizeY = 37;
+  vLayout.mSizeZ = 9;
+  vLayout.mSizeC = 2;
+  vLayout.mBlockSizeX = 77;
+  vLayout.mBlockSizeY = 16;
+  vLayout.mBlockSizeZ = 4;
+  const bpfString vFileName = "bpImageReaderUnshuffleTest.ims";
+
+  for (bpTestFileLayout::tCompression vCompression : { bpTestFileLayout::eCompressionShuffleGzip, bpTestFileLayout::eCompressionShuffleLZ4 }) {
+    vLayout.mCompression = vCompression;
+    bpfString vName = aTypeName + (vCompression == bpTestFileLayout::eCompressionShuffleGzip ? " shuffle gzip" : " shuffle lz4");
+    if (!bpTestCheck(bpTestWriteFile<TDataType>(vFileName, vLayout), "write " + vName)) {
+      continue;
+    }
+
+    for (bool vIsAVX2Enabled : { true, false }) {
+      bpfH5ChunkDecoder::SetAVX2Enabled(vIsAVX2Enabled);
+      bpfString vDescription = vName + (vIsAVX2Enabled ? "" : " without avx2");
+
+      bpReaderTypes::cReadOptions vOptions;
+      bpImageReader<TDataType> vReader(vFileName, 0, vOptions);
+      vOptions.mUnshuffleIntoDestination = true;
+      bpImageReader<TDataType> vUnshuffleReader(vFileName, 0, vOptions);
+      vOptions.mChunkCacheSizeBytes = 16 << 20;
+      bpImageReader<TDataType> vChunkCacheReader(vFileName, 0, vOptions);
+      std::vector<bpImageReader<TDataType>*> vReaders = { &vReader, &vUnshuffleReader, &vChunkCacheReader };
+
+      CheckReads(vReaders, tIndex5D(X, 0, Y, 0, Z, 0, C, 0, T, 0), tIndex5D(X, 150, Y, 37, Z, 9, C, 2, T, 1), vDescription + " whole image");
+      CheckReads(vReaders, tIndex5D(X, 3, Y, 1, Z, 2, C, 1, T, 0), tIndex5D(X, 148, Y, 35, Z, 7, C, 2, T, 1), vDescription + " region");
+      CheckReads(vReaders, tIndex5D(X, 77, Y, 16, Z, 4, C, 0, T, 0), tIndex5D(X, 150, Y, 37, Z, 9, C, 1, T, 1), vDescription + " border chunks");
+      CheckReads(vReaders, tIndex5D(X, 81, Y, 5, Z, 1, C, 0, T, 0), tIndex5D(X, 98, Y, 6, Z, 2, C, 1, T, 1), vDescription + " part of a row");
+    }
+  }
+  bpfH5ChunkDecoder::SetAVX2Enabled(true);
+  std::remove(vFileName.c_str());
+}
+
+
+int main()
+{
+  TestUnshuffle<bpfUInt8>("uint8");
+  TestUnshuffle<bpfUInt16>("uint16");
+  TestUnshuffle<bpfUInt32>("uint32");
+  TestUnshuffle<bpfFloat>("float");
+  return bpTestExitCode();
+}
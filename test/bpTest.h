@@ -0,0 +1,62 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BP_TEST__
+#define __BP_TEST__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+
+#include <iostream>
+
+
+/**
+ * Minimal checks for the test programs: a failed check is printed and counted,
+ * main returns bpTestExitCode() so that ctest reports the program as failed.
+ */
+inline bpfSize& bpTestNumberOfFailures()
+{
+  static bpfSize vNumberOfFailures = 0;
+  return vNumberOfFailures;
+}
+
+
+inline bool bpTestCheck(bool aCondition, const bpfString& aDescription)
+{
+  if (!aCondition) {
+    // the first failures are enough to see what went wrong
+    if (bpTestNumberOfFailures() < 20) {
+      std::cerr << "FAILED: " << aDescription << std::endl;
+    }
+    ++bpTestNumberOfFailures();
+  }
+  return aCondition;
+}
+
+
+inline int bpTestExitCode()
+{
+  if (bpTestNumberOfFailures() > 0) {
+    std::cerr << bpTestNumberOfFailures() << " checks failed" << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+
+#endif // __BP_TEST__
@@ -0,0 +1,224 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BP_TEST_FILE__
+#define __BP_TEST_FILE__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+#include "ImarisReader/utils/bpfH5LZ4.h"
+
+#include "hdf5.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+
+/**
+ * Layout of a single resolution .ims file written by bpTestWriteFile.
+ */
+struct bpTestFileLayout
+{
+  enum tCompression {
+    eCompressionNone = 0,
+    eCompressionGzip = 1,
+    eCompressionShuffleGzip = 2,
+    eCompressionLZ4 = 3,
+    eCompressionShuffleLZ4 = 4
+  };
+
+  bpfSize mSizeX = 64;
+  bpfSize mSizeY = 64;
+  bpfSize mSizeZ = 16;
+  bpfSize mSizeC = 1;
+  bpfSize mSizeT = 1;
+  // chunk size of the "Data" datasets
+  bpfSize mBlockSizeX = 32;
+  bpfSize mBlockSizeY = 32;
+  bpfSize mBlockSizeZ = 8;
+  tCompression mCompression = eCompressionNone;
+  // time points after mSizeT that only have an empty group and a TimeInfo entry, for long series
+  bpfSize mNumberOfEmptyTimePoints = 0;
+  // when not 0, only the planes below mWrittenSizeZ are written, the chunks after them are never allocated
+  bpfSize mWrittenSizeZ = 0;
+  // the fill value of the "Data" datasets, which unallocated chunks read as
+  bpfFloat mFillValue = 0;
+};
+
+
+/**
+ * The voxel values that bpTestWriteFile writes, so that reads can be checked without a copy of the image.
+ */
+inline bpfUInt16 bpTestGetValue(bpfSize aX, bpfSize aY, bpfSize aZ, bpfSize aC, bpfSize aT)
+{
+  return static_cast<bpfUInt16>((aX * 7 + aY * 13 + aZ * 31 + aC * 101 + aT * 211) % 250 + (aX * aY) % 1000);
+}
+
+
+// the hdf5 type of the voxels that bpTestWriteFile<TDataType> writes
+template<typename TDataType>
+inline hid_t bpTestGetH5Type();
+
+template<>
+inline hid_t bpTestGetH5Type<bpfUInt8>()
+{
+  return H5T_NATIVE_UCHAR;
+}
+
+template<>
+inline hid_t bpTestGetH5Type<bpfUInt16>()
+{
+  return H5T_NATIVE_USHORT;
+}
+
+template<>
+inline hid_t bpTestGetH5Type<bpfUInt32>()
+{
+  return H5T_NATIVE_UINT32;
+}
+
+template<>
+inline hid_t bpTestGetH5Type<bpfFloat>()
+{
+  return H5T_NATIVE_FLOAT;
+}
+
+
+inline void bpTestWriteAttribute(hid_t aLocation, const bpfString& aName, const bpfString& aValue)
+{
+  hsize_t vSize = aValue.size();
+  hid_t vSpaceId = H5Screate_simple(1, &vSize, nullptr);
+  hid_t vAttributeId = H5Acreate2(aLocation, aName.c_str(), H5T_C_S1, vSpaceId, H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite(vAttributeId, H5T_C_S1, aValue.data());
+  H5Aclose(vAttributeId);
+  H5Sclose(vSpaceId);
+}
+
+
+inline bpfString bpTestGetTimePoint(bpfSize aIndexT)
+{
+  bpfChar vTime[64];
+  std::snprintf(vTime, sizeof(vTime), "2021-03-%02d %02d:%02d:%02d.%03d", static_cast<int>(1 + aIndexT / 86400 % 28),
+    static_cast<int>(aIndexT / 3600 % 24), static_cast<int>(aIndexT / 60 % 60), static_cast<int>(aIndexT % 60), static_cast<int>(aIndexT * 7 % 1000));
+  return vTime;
+}
+
+
+/**
+ * Writes an .ims file with the given layout, the voxels hold bpTestGetValue as TDataType. Returns false on error.
+ */
+template<typename TDataType = bpfUInt16>
+inline bool bpTestWriteFile(const bpfString& aFileName, const bpTestFileLayout& aLayout)
+{
+  // the 1.8 format keeps many links and attributes in dense storage, the old one grows the object header
+  hid_t vAccessId = H5Pcreate(H5P_FILE_ACCESS);
+  H5Pset_libver_bounds(vAccessId, H5F_LIBVER_V18, H5F_LIBVER_LATEST);
+  hid_t vFileId = H5Fcreate(aFileName.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, vAccessId);
+  H5Pclose(vAccessId);
+  if (vFileId < 0) {
+    return false;
+  }
+  bpTestWriteAttribute(vFileId, "ImarisVersion", "5.5.0");
+  bpTestWriteAttribute(vFileId, "ImarisDataSet", "ImarisDataSet");
+
+  hsize_t vChunkDim[3] = { std::min(aLayout.mBlockSizeZ, aLayout.mSizeZ), std::min(aLayout.mBlockSizeY, aLayout.mSizeY), std::min(aLayout.mBlockSizeX, aLayout.mSizeX) };
+  hsize_t vDataDim[3] = {
+    (aLayout.mSizeZ + vChunkDim[0] - 1) / vChunkDim[0] * vChunkDim[0],
+    (aLayout.mSizeY + vChunkDim[1] - 1) / vChunkDim[1] * vChunkDim[1],
+    (aLayout.mSizeX + vChunkDim[2] - 1) / vChunkDim[2] * vChunkDim[2] };
+  hid_t vCreateId = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(vCreateId, 3, vChunkDim);
+  H5Pset_fill_value(vCreateId, H5T_NATIVE_FLOAT, &aLayout.mFillValue);
+  bpTestFileLayout::tCompression vCompression = aLayout.mCompression;
+  if (vCompression == bpTestFileLayout::eCompressionShuffleGzip || vCompression == bpTestFileLayout::eCompressionShuffleLZ4) {
+    H5Pset_shuffle(vCreateId);
+  }
+  if (vCompression == bpTestFileLayout::eCompressionGzip || vCompression == bpTestFileLayout::eCompressionShuffleGzip) {
+    H5Pset_deflate(vCreateId, 2);
+  }
+  if (vCompression == bpTestFileLayout::eCompressionLZ4 || vCompression == bpTestFileLayout::eCompressionShuffleLZ4) {
+    H5Pset_lz4(vCreateId, 1 << 16);
+  }
+  hid_t vSpaceId = H5Screate_simple(3, vDataDim, nullptr);
+  std::vector<TDataType> vData(vDataDim[0] * vDataDim[1] * vDataDim[2], 0);
+  hid_t vWrittenSpaceId = H5Scopy(vSpaceId);
+  if (aLayout.mWrittenSizeZ > 0) {
+    hsize_t vStart[3] = { 0, 0, 0 };
+    hsize_t vCount[3] = { aLayout.mWrittenSizeZ, vDataDim[1], vDataDim[2] };
+    H5Sselect_hyperslab(vWrittenSpaceId, H5S_SELECT_SET, vStart, nullptr, vCount, nullptr);
+  }
+
+  hid_t vDataSetGroupId = H5Gcreate2(vFileId, "DataSet", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  hid_t vLevelId = H5Gcreate2(vDataSetGroupId, "ResolutionLevel 0", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  bool vIsWritten = true;
+  for (bpfSize vIndexT = 0; vIndexT < aLayout.mSizeT + aLayout.mNumberOfEmptyTimePoints; ++vIndexT) {
+    hid_t vTimePointId = H5Gcreate2(vLevelId, ("TimePoint " + std::to_string(vIndexT)).c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    for (bpfSize vIndexC = 0; vIndexT < aLayout.mSizeT && vIndexC < aLayout.mSizeC; ++vIndexC) {
+      hid_t vChannelId = H5Gcreate2(vTimePointId, ("Channel " + std::to_string(vIndexC)).c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      bpTestWriteAttribute(vChannelId, "ImageSizeX", std::to_string(aLayout.mSizeX));
+      bpTestWriteAttribute(vChannelId, "ImageSizeY", std::to_string(aLayout.mSizeY));
+      bpTestWriteAttribute(vChannelId, "ImageSizeZ", std::to_string(aLayout.mSizeZ));
+      for (bpfSize vZ = 0; vZ < aLayout.mSizeZ; ++vZ) {
+        for (bpfSize vY = 0; vY < aLayout.mSizeY; ++vY) {
+          for (bpfSize vX = 0; vX < aLayout.mSizeX; ++vX) {
+            vData[(vZ * vDataDim[1] + vY) * vDataDim[2] + vX] = static_cast<TDataType>(bpTestGetValue(vX, vY, vZ, vIndexC, vIndexT));
+          }
+        }
+      }
+      hid_t vDataId = H5Dcreate2(vChannelId, "Data", bpTestGetH5Type<TDataType>(), vSpaceId, H5P_DEFAULT, vCreateId, H5P_DEFAULT);
+      vIsWritten = vIsWritten && vDataId >= 0 && H5Dwrite(vDataId, bpTestGetH5Type<TDataType>(), vWrittenSpaceId, vWrittenSpaceId, H5P_DEFAULT, vData.data()) >= 0;
+      H5Dclose(vDataId);
+      H5Gclose(vChannelId);
+    }
+    H5Gclose(vTimePointId);
+  }
+  H5Gclose(vLevelId);
+  H5Gclose(vDataSetGroupId);
+  H5Sclose(vWrittenSpaceId);
+  H5Sclose(vSpaceId);
+  H5Pclose(vCreateId);
+
+  hid_t vInfoId = H5Gcreate2(vFileId, "DataSetInfo", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  hid_t vImageId = H5Gcreate2(vInfoId, "Image", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  bpTestWriteAttribute(vImageId, "ExtMin0", "0");
+  bpTestWriteAttribute(vImageId, "ExtMin1", "0");
+  bpTestWriteAttribute(vImageId, "ExtMin2", "0");
+  bpTestWriteAttribute(vImageId, "ExtMax0", std::to_string(aLayout.mSizeX));
+  bpTestWriteAttribute(vImageId, "ExtMax1", std::to_string(aLayout.mSizeY));
+  bpTestWriteAttribute(vImageId, "ExtMax2", std::to_string(aLayout.mSizeZ));
+  H5Gclose(vImageId);
+  hid_t vTimeInfoId = H5Gcreate2(vInfoId, "TimeInfo", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  bpfSize vNumberOfTimePoints = aLayout.mSizeT + aLayout.mNumberOfEmptyTimePoints;
+  bpTestWriteAttribute(vTimeInfoId, "DatasetTimePoints", std::to_string(vNumberOfTimePoints));
+  for (bpfSize vIndexT = 0; vIndexT < vNumberOfTimePoints; ++vIndexT) {
+    bpTestWriteAttribute(vTimeInfoId, "TimePoint" + std::to_string(vIndexT + 1), bpTestGetTimePoint(vIndexT));
+  }
+  H5Gclose(vTimeInfoId);
+  for (bpfSize vIndexC = 0; vIndexC < aLayout.mSizeC; ++vIndexC) {
+    hid_t vChannelId = H5Gcreate2(vInfoId, ("Channel " + std::to_string(vIndexC)).c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    bpTestWriteAttribute(vChannelId, "Color", "1 0 0");
+    bpTestWriteAttribute(vChannelId, "ColorRange", "0 1250");
+    H5Gclose(vChannelId);
+  }
+  H5Gclose(vInfoId);
+  return H5Fclose(vFileId) >= 0 && vIsWritten;
+}
+
+
+#endif // __BP_TEST_FILE__
@@ -0,0 +1,121 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BP_TEST_LATENCY_STORAGE__
+#define __BP_TEST_LATENCY_STORAGE__
+
+
+#include "ImarisReader/interface/bpStorageInterface.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+
+/**
+ * Stand-in for a remote store: forwards to another storage and waits a fixed latency
+ * per request plus the transfer time at a given bandwidth. Each run of contiguous
+ * ranges passed to ReadRanges is one request.
+ * Counts requests and bytes, e.g. to check how well reads are coalesced.
+ */
+class bpTestLatencyStorage : public bpStorageInterface
+{
+public:
+  struct cStatistics
+  {
+    bpUInt64 mRequests = 0;
+    bpUInt64 mRanges = 0;
+    bpUInt64 mBytes = 0;
+  };
+
+  // aBytesPerSecond 0 does not limit the bandwidth
+  bpTestLatencyStorage(bpSharedPtr<bpStorageInterface> aStorage, bpUInt64 aLatencyMicroseconds, bpUInt64 aBytesPerSecond = 0)
+    : mStorage(std::move(aStorage)),
+      mLatencyMicroseconds(aLatencyMicroseconds),
+      mBytesPerSecond(aBytesPerSecond),
+      mRequests(0),
+      mRanges(0),
+      mBytes(0)
+  {
+  }
+
+  bpUInt64 GetSize() override
+  {
+    return mStorage->GetSize();
+  }
+
+  bool Read(bpUInt64 aOffset, bpSize aSize, void* aData) override
+  {
+    ++mRequests;
+    ++mRanges;
+    mBytes += aSize;
+    Wait(aSize);
+    return mStorage->Read(aOffset, aSize, aData);
+  }
+
+  bool ReadRanges(const std::vector<cRange>& aRanges) override
+  {
+    for (bpSize vBegin = 0; vBegin < aRanges.size();) {
+      // the run of ranges that each start where the previous one ends
+      bpSize vEnd = vBegin + 1;
+      bpUInt64 vBytes = aRanges[vBegin].mSize;
+      while (vEnd < aRanges.size() && aRanges[vEnd].mOffset == aRanges[vEnd - 1].mOffset + aRanges[vEnd - 1].mSize) {
+        vBytes += aRanges[vEnd].mSize;
+        ++vEnd;
+      }
+      ++mRequests;
+      mRanges += vEnd - vBegin;
+      mBytes += vBytes;
+      Wait(vBytes);
+      vBegin = vEnd;
+    }
+    return mStorage->ReadRanges(aRanges);
+  }
+
+  cStatistics GetStatistics() const
+  {
+    cStatistics vStatistics;
+    vStatistics.mRequests = mRequests;
+    vStatistics.mRanges = mRanges;
+    vStatistics.mBytes = mBytes;
+    return vStatistics;
+  }
+
+private:
+  void Wait(bpUInt64 aBytes) const
+  {
+    bpUInt64 vMicroseconds = mLatencyMicroseconds;
+    if (mBytesPerSecond > 0) {
+      vMicroseconds += aBytes * 1000000 / mBytesPerSecond;
+    }
+    if (vMicroseconds > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(vMicroseconds));
+    }
+  }
+
+  bpSharedPtr<bpStorageInterface> mStorage;
+  bpUInt64 mLatencyMicroseconds;
+  bpUInt64 mBytesPerSecond;
+
+  std::atomic<bpUInt64> mRequests;
+  std::atomic<bpUInt64> mRanges;
+  std::atomic<bpUInt64> mBytes;
+};
+
+
+#endif // __BP_TEST_LATENCY_STORAGE__
@@ -0,0 +1,202 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#include "ImarisReader/test/bpTest.h"
+#include "ImarisReader/types/bpfTimeInfo.h"
+#include "ImarisReader/utils/bpfStringTokenizer.h"
+#include "ImarisReader/utils/bpfUtils.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+
+// numbers the stream parses, and input that only the stream path handles
+static const std::vector<bpfString> mNumbers = {
+  "0", "-0", "1", "70", "+1", "-0.25", ".5", "5.", "0.0001", "255", "4294967295", "18446744073709551615", "18446744073709551616",
+  // exponents
+  "1e2", "1E-2", "1.5e+3", "-2.5e-3", "1e0", "1e-0", "1e10", "1e22", "1e23", "3.4028235e38", "3.4028236e38", "1e38", "1e39", "1e-38",
+  "1.17549435e-38", "1e", "1e+", "e5", "1e5.5",
+  // subnormals and underflow
+  "1e-40", "1.4e-45", "1.401298464e-45", "7e-46", "-1e-42", "1e-50", "1.1754942e-38",
+  // long mantissas
+  "0.1000000000000000055511151231257827", "3.14159265358979323846264338327950288", "123456789012345678901234567890",
+  "0.000000000000000000000000000001", "16777217", "16777216.5", "9007199254740993", "1.00000005960464477539062500001",
+  // leading and trailing whitespace
+  " 1.5", "1.5 ", "  -3", "\t2", "2\n", " ", "\n", "",
+  // malformed
+  "abc", "1.5x", "x1", "--1", "-+1", "1..2", "1,5", "0x10", "nan", "inf", "-", "+", ".", "1 2"
+};
+
+
+static bpfString Describe(const bpfString& aString)
+{
+  return "\"" + aString + "\"";
+}
+
+
+static void CheckFloat(const bpfString& aString)
+{
+  bpfFloat vExpected = 12345.0f;
+  bpfFloat vResult = 12345.0f;
+  bpfFromString(aString, vExpected);
+  bpfFromString(aString.data(), aString.data() + aString.size(), vResult);
+  bpTestCheck(std::memcmp(&vExpected, &vResult, sizeof(bpfFloat)) == 0, "float " + Describe(aString));
+}
+
+
+static void CheckSize(const bpfString& aString)
+{
+  bpfSize vExpected = 777;
+  bpfSize vResult = 777;
+  bpfFromString(aString, vExpected);
+  bpfFromString(aString.data(), aString.data() + aString.size(), vResult);
+  bpTestCheck(vExpected == vResult, "size " + Describe(aString));
+}
+
+
+static void CheckTokenizer(const bpfString& aString)
+{
+  for (bpfSize vFlags = 0; vFlags < 4; ++vFlags) {
+    bool vSkipEmptyParts = (vFlags & 1) != 0;
+    bool vSkipEmptyBoundParts = (vFlags & 2) != 0;
+    std::vector<bpfString> vExpected = bpfSplit(aString, " ", vSkipEmptyParts, vSkipEmptyBoundParts);
+    std::vector<bpfString> vResult;
+    bpfStringTokenizer vTokenizer(aString, ' ', vSkipEmptyParts, vSkipEmptyBoundParts);
+    const bpfChar* vTokenBegin;
+    const bpfChar* vTokenEnd;
+    while (vTokenizer.Next(vTokenBegin, vTokenEnd)) {
+      vResult.emplace_back(vTokenBegin, vTokenEnd);
+    }
+    bpTestCheck(vExpected == vResult, "tokens of " + Describe(aString));
+  }
+}
+
+
+/**
+ * A time that Parse accepts must give the same time as the legacy constructor.
+ */
+static bool CheckTime(const bpfString& aString)
+{
+  bpfInt32 vJulianDay = 0;
+  bpfInt64 vNanoseconds = 0;
+  if (!bpfTimeInfo::Parse(aString.data(), aString.data() + aString.size(), vJulianDay, vNanoseconds)) {
+    return false;
+  }
+  bpfTimeInfo vExpected(aString);
+  bpTestCheck(vExpected.GetJulianDay() == vJulianDay && vExpected.GetNanoseconds() == vNanoseconds, "time " + Describe(aString));
+  return true;
+}
+
+
+static void TestNumbers()
+{
+  for (const bpfString& vNumber : mNumbers) {
+    CheckFloat(vNumber);
+    CheckSize(vNumber);
+    CheckTokenizer(vNumber);
+  }
+
+  // decimal numbers of all magnitudes, and random strings of number characters
+  std::mt19937 vRandom(5);
+  const bpfChar vCharacters[] = "0123456789.-+eE x";
+  for (bpfSize vIteration = 0; vIteration < 300000; ++vIteration) {
+    bpfChar vBuffer[64];
+    int vLength = 0;
+    switch (vIteration % 3) {
+    case 0:
+      vLength = std::snprintf(vBuffer, sizeof(vBuffer), "%.*g", static_cast<int>(1 + vRandom() % 12),
+        std::ldexp(vRandom() / 4294967296.0, static_cast<int>(vRandom() % 300) - 160) * ((vRandom() & 1) ? -1 : 1));
+      break;
+    case 1:
+      vLength = std::snprintf(vBuffer, sizeof(vBuffer), "%u.%0*u", static_cast<unsigned>(vRandom() % 100000),
+        static_cast<int>(vRandom() % 9 + 1), static_cast<unsigned>(vRandom() % 1000000000));
+      break;
+    default:
+      vLength = static_cast<int>(vRandom() % 12);
+      for (int vIndex = 0; vIndex < vLength; ++vIndex) {
+        vBuffer[vIndex] = vCharacters[vRandom() % (sizeof(vCharacters) - 1)];
+      }
+      break;
+    }
+    bpfString vString(vBuffer, vLength);
+    CheckFloat(vString);
+    CheckSize(vString);
+    CheckTokenizer(vString);
+  }
+}
+
+
+static void TestTimes()
+{
+  const std::vector<bpfString> vValid = {
+    "2011-11-27 15:42:37.285", "2011-11-27 15:42:37", "2000-01-01 00:00:00.000", "1970-01-01 00:00:00.5",
+    "2021-03-05 12:00:59.999999999", "2024-02-29 23:59:59.123456", "1900-02-28 01:02:03.000000001", "2021-03-05 12:00:00.1"
+  };
+  for (const bpfString& vTime : vValid) {
+    bpTestCheck(CheckTime(vTime), "parse " + Describe(vTime));
+  }
+
+  const std::vector<bpfString> vMalformed = {
+    "", " ", "15:55", "2021-03-05", " 2021-03-05 12:00:00", "2021-03-05 12:00:00 ", "2021-03-05  12:00:00", "2021-03-05T12:00:00",
+    "2021-03-05 12:00:00.", "2021-03-05 12:00:00:123", "2021-03-05 12:00:00.123456789012", "2021-03-05 12-00-00", "2021/03/05 12:00:00",
+    "2021-13-05 12:00:00.5", "2021-03-05 24:00:00.5", "2021-03-05 12:00:61", "99999-01-01 00:00:00", "-2021-03-05 12:00:00",
+    "2021-3-5 1:2:3", "2021-03-05 12:00:0x", "abcd-ef-gh ij:kl:mn"
+  };
+  for (const bpfString& vTime : vMalformed) {
+    // either rejected, or parsed like the legacy constructor
+    CheckTime(vTime);
+  }
+  bpTestCheck(!CheckTime("2021-03-05 12:00:00.123456789012"), "more than nine fractional digits are rejected");
+  bpTestCheck(!CheckTime("2021-03-05T12:00:00"), "a T separator is rejected");
+  bpTestCheck(!CheckTime(" 2021-03-05 12:00:00"), "leading whitespace is rejected");
+
+  std::mt19937 vRandom(1);
+  const bpfChar vCharacters[] = "0123456789-: .";
+  bpfSize vNumberOfParsed = 0;
+  for (bpfSize vIteration = 0; vIteration < 300000; ++vIteration) {
+    bpfChar vBuffer[64];
+    int vLength = 0;
+    if (vIteration % 2) {
+      vLength = std::snprintf(vBuffer, sizeof(vBuffer), "%d-%d-%d %d:%d:%d.%0*u", static_cast<int>(vRandom() % 3000),
+        static_cast<int>(vRandom() % 40), static_cast<int>(vRandom() % 40), static_cast<int>(vRandom() % 30),
+        static_cast<int>(vRandom() % 70), static_cast<int>(vRandom() % 70), static_cast<int>(1 + vRandom() % 9),
+        static_cast<unsigned>(vRandom() % 1000000000));
+    }
+    else {
+      vLength = static_cast<int>(1 + vRandom() % 30);
+      for (int vIndex = 0; vIndex < vLength; ++vIndex) {
+        vBuffer[vIndex] = vCharacters[vRandom() % (sizeof(vCharacters) - 1)];
+      }
+    }
+    if (CheckTime(bpfString(vBuffer, vLength))) {
+      ++vNumberOfParsed;
+    }
+  }
+  bpTestCheck(vNumberOfParsed > 0, "random times are parsed");
+}
+
+
+int main()
+{
+  TestNumbers();
+  TestTimes();
+  return bpTestExitCode();
+}
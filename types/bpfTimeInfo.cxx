@@ -515,6 +515,81 @@ bpfInt32 bpfTimeInfo::ToJulianDay(bpfInt32 aYear, bpfInt32 aMonth, bpfInt32 aDay
 }
 
 
+// reads 1 to aMaxDigits decimal digits at aPos, advancing it
+static bool ParseDigits(const bpfChar*& aPos, const bpfChar* aEnd, bpfSize aMaxDigits, bpfInt64& aValue, bpfSize& aNumberOfDigits)
+{
+  aValue = 0;
+  aNumberOfDigits = 0;
+  while (aPos != aEnd && *aPos >= '0' && *aPos <= '9') {
+    if (aNumberOfDigits == aMaxDigits) {
+      return false;
+    }
+    aValue = 10 * aValue + (*aPos - '0');
+    ++aNumberOfDigits;
+    ++aPos;
+  }
+  return aNumberOfDigits > 0;
+}
+
+
+// reads the separator aSeparator at aPos, advancing it
+static bool ParseSeparator(const bpfChar*& aPos, const bpfChar* aEnd, bpfChar aSeparator)
+{
+  if (aPos == aEnd || *aPos != aSeparator) {
+    return false;
+  }
+  ++aPos;
+  return true;
+}
+
+
+bool bpfTimeInfo::Parse(const bpfChar* aBegin, const bpfChar* aEnd,
+                        bpfInt32& aJulianDay,
+                        bpfInt64& aNanosecondsOfDay)
+{
+  const bpfChar* vPos = aBegin;
+  bpfInt64 vYear = 0;
+  bpfInt64 vMonth = 0;
+  bpfInt64 vDay = 0;
+  bpfInt64 vHour = 0;
+  bpfInt64 vMin = 0;
+  bpfInt64 vSecond = 0;
+  bpfInt64 vFraction = 0;
+  bpfSize vDigits = 0;
+  bpfSize vFractionDigits = 0;
+  if (!ParseDigits(vPos, aEnd, 4, vYear, vDigits) || !ParseSeparator(vPos, aEnd, '-') ||
+      !ParseDigits(vPos, aEnd, 2, vMonth, vDigits) || !ParseSeparator(vPos, aEnd, '-') ||
+      !ParseDigits(vPos, aEnd, 2, vDay, vDigits) || !ParseSeparator(vPos, aEnd, ' ') ||
+      !ParseDigits(vPos, aEnd, 2, vHour, vDigits) || !ParseSeparator(vPos, aEnd, ':') ||
+      !ParseDigits(vPos, aEnd, 2, vMin, vDigits) || !ParseSeparator(vPos, aEnd, ':') ||
+      !ParseDigits(vPos, aEnd, 2, vSecond, vDigits)) {
+    return false;
+  }
+  if (vPos != aEnd && (!ParseSeparator(vPos, aEnd, '.') || !ParseDigits(vPos, aEnd, 9, vFraction, vFractionDigits))) {
+    return false;
+  }
+  if (vPos != aEnd) {
+    return false;
+  }
+
+  // as SetDate, swap day and month if non ISO 8601 format
+  if (vMonth > 12) {
+    std::swap(vMonth, vDay);
+  }
+  aJulianDay = ToJulianDay(static_cast<bpfInt32>(vYear), static_cast<bpfInt32>(vMonth), static_cast<bpfInt32>(vDay));
+
+  // as SetTime, an invalid time is midnight
+  aNanosecondsOfDay = 0;
+  if (vHour < 24 && vMin < 60 && vSecond < 60) {
+    for (; vFractionDigits < 9; ++vFractionDigits) {
+      vFraction *= 10;
+    }
+    aNanosecondsOfDay = ((vHour * 60 + vMin) * 60 + vSecond) * 1000LL * 1000 * 1000 + vFraction;
+  }
+  return true;
+}
+
+
 void bpfTimeInfo::FromJulianDay(bpfInt32 aJulianDay,
                                bpfInt32& aYear,
                                bpfInt32& aMonth,
@@ -242,6 +242,15 @@ public:
                             bpfInt32& aMonth,
                             bpfInt32& aDay);
 
+  /**
+   * Parses [aBegin, aEnd) of the form "2011-11-27 15:42:37.285", with up to nine
+   * fractional digits, without allocating. Returns false for any other form, which
+   * FromString may still accept; the results are the same as of FromString otherwise.
+   */
+  static bool Parse(const bpfChar* aBegin, const bpfChar* aEnd,
+                    bpfInt32& aJulianDay,
+                    bpfInt64& aNanosecondsOfDay);
+
 private:
 
   /**
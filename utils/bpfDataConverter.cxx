@@ -0,0 +1,494 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#include "ImarisReader/utils/bpfDataConverter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BPF_CONVERT_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BPF_TARGET_AVX2_F16C
+#else
+#define BPF_TARGET_AVX2_F16C __attribute__((target("avx2,f16c")))
+#endif
+#else
+#define BPF_CONVERT_SIMD 0
+#endif
+
+
+static bpfUInt16 FloatToHalf(bpfFloat aValue)
+{
+  bpfUInt32 vBits;
+  std::memcpy(&vBits, &aValue, sizeof(vBits));
+  bpfUInt32 vSign = (vBits >> 16) & 0x8000;
+  bpfUInt32 vAbs = vBits & 0x7fffffff;
+
+  if (vAbs >= 0x7f800000) {
+    // infinity, or a quiet NaN keeping the upper payload bits
+    return static_cast<bpfUInt16>(vSign | 0x7c00 | (vAbs > 0x7f800000 ? 0x200 | ((vAbs >> 13) & 0x3ff) : 0));
+  }
+  if (vAbs >= 0x477ff000) {
+    // 65520 and above round to infinity
+    return static_cast<bpfUInt16>(vSign | 0x7c00);
+  }
+  if (vAbs < 0x38800000) {
+    // below the smallest normal half, 2^-14
+    if (vAbs < 0x33000000) {
+      return static_cast<bpfUInt16>(vSign);
+    }
+    bpfUInt32 vMantissa = (vAbs & 0x7fffff) | 0x800000;
+    bpfUInt32 vShift = 126 - (vAbs >> 23);
+    bpfUInt32 vHalf = vMantissa >> vShift;
+    bpfUInt32 vRemainder = vMantissa & ((1u << vShift) - 1);
+    bpfUInt32 vMiddle = 1u << (vShift - 1);
+    if (vRemainder > vMiddle || (vRemainder == vMiddle && (vHalf & 1))) {
+      ++vHalf;
+    }
+    return static_cast<bpfUInt16>(vSign | vHalf);
+  }
+
+  // rebias the exponent from 127 to 15 and round away the lower 13 mantissa bits
+  bpfUInt32 vHalf = (vAbs - 0x38000000) >> 13;
+  bpfUInt32 vRemainder = vAbs & 0x1fff;
+  if (vRemainder > 0x1000 || (vRemainder == 0x1000 && (vHalf & 1))) {
+    ++vHalf;
+  }
+  return static_cast<bpfUInt16>(vSign | vHalf);
+}
+
+
+template<typename TSrc>
+static bpfFloat LoadScalar(const bpfUInt8* aSrc)
+{
+  TSrc vValue;
+  std::memcpy(&vValue, aSrc, sizeof(TSrc));
+  return static_cast<bpfFloat>(vValue);
+}
+
+
+template<bpfDataConverter::tType TDest>
+static void StoreScalar(bpfFloat aValue, bpfUInt8* aDest);
+
+template<>
+void StoreScalar<bpfDataConverter::eFloat32>(bpfFloat aValue, bpfUInt8* aDest)
+{
+  std::memcpy(aDest, &aValue, sizeof(aValue));
+}
+
+template<>
+void StoreScalar<bpfDataConverter::eFloat16>(bpfFloat aValue, bpfUInt8* aDest)
+{
+  bpfUInt16 vHalf = FloatToHalf(aValue);
+  std::memcpy(aDest, &vHalf, sizeof(vHalf));
+}
+
+template<>
+void StoreScalar<bpfDataConverter::eUInt8>(bpfFloat aValue, bpfUInt8* aDest)
+{
+  // written so that NaN ends up as 0, like the simd max
+  aValue = aValue > 0.0f ? aValue : 0.0f;
+  aValue = aValue < 255.0f ? aValue : 255.0f;
+  *aDest = static_cast<bpfUInt8>(std::nearbyint(aValue));
+}
+
+
+#if BPF_CONVERT_SIMD
+
+static bool HasAVX2AndF16C()
+{
+#if defined(_MSC_VER)
+  static const bool vHasAVX2AndF16C = [] {
+    int vInfo[4];
+    __cpuid(vInfo, 1);
+    bool vHasF16C = (vInfo[2] & (1 << 29)) != 0;
+    __cpuidex(vInfo, 7, 0);
+    return vHasF16C && (vInfo[1] & (1 << 5)) != 0;
+  }();
+  return vHasAVX2AndF16C;
+#else
+  static const bool vHasAVX2AndF16C = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+  return vHasAVX2AndF16C;
+#endif
+}
+
+
+// SSE2, four elements at a time
+
+template<typename TSrc>
+static __m128 Load4(const bpfUInt8* aSrc);
+
+template<>
+__m128 Load4<bpfUInt8>(const bpfUInt8* aSrc)
+{
+  bpfInt32 vBytes;
+  std::memcpy(&vBytes, aSrc, sizeof(vBytes));
+  __m128i vZero = _mm_setzero_si128();
+  __m128i vValues = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(vBytes), vZero), vZero);
+  return _mm_cvtepi32_ps(vValues);
+}
+
+template<>
+__m128 Load4<bpfUInt16>(const bpfUInt8* aSrc)
+{
+  __m128i vValues = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(aSrc));
+  return _mm_cvtepi32_ps(_mm_unpacklo_epi16(vValues, _mm_setzero_si128()));
+}
+
+template<>
+__m128 Load4<bpfUInt32>(const bpfUInt8* aSrc)
+{
+  // both halves convert exactly, so the sum is rounded once like a scalar conversion
+  __m128i vValues = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aSrc));
+  __m128 vHigh = _mm_cvtepi32_ps(_mm_srli_epi32(vValues, 16));
+  __m128 vLow = _mm_cvtepi32_ps(_mm_and_si128(vValues, _mm_set1_epi32(0xffff)));
+  return _mm_add_ps(_mm_mul_ps(vHigh, _mm_set1_ps(65536.0f)), vLow);
+}
+
+template<>
+__m128 Load4<bpfFloat>(const bpfUInt8* aSrc)
+{
+  return _mm_loadu_ps(reinterpret_cast<const float*>(aSrc));
+}
+
+
+template<typename TSrc, bpfDataConverter::tType TDest>
+static bpfSize ConvertSSE2(const bpfUInt8* aSrc, bpfSize aCount, bpfUInt8* aDest, bpfFloat aScale, bpfFloat aOffset)
+{
+  if (TDest == bpfDataConverter::eFloat16) {
+    return 0;
+  }
+
+  __m128 vScale = _mm_set1_ps(aScale);
+  __m128 vOffset = _mm_set1_ps(aOffset);
+  bpfSize vIndex = 0;
+  for (; vIndex + 4 <= aCount; vIndex += 4) {
+    __m128 vValues = _mm_add_ps(_mm_mul_ps(Load4<TSrc>(aSrc + vIndex * sizeof(TSrc)), vScale), vOffset);
+    if (TDest == bpfDataConverter::eFloat32) {
+      _mm_storeu_ps(reinterpret_cast<float*>(aDest + vIndex * sizeof(float)), vValues);
+    }
+    else {
+      vValues = _mm_min_ps(_mm_max_ps(vValues, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+      __m128i vWords = _mm_packs_epi32(_mm_cvtps_epi32(vValues), _mm_setzero_si128());
+      bpfInt32 vBytes = _mm_cvtsi128_si32(_mm_packus_epi16(vWords, vWords));
+      std::memcpy(aDest + vIndex, &vBytes, sizeof(vBytes));
+    }
+  }
+  return vIndex;
+}
+
+
+// AVX2 and F16C, eight elements at a time
+
+template<typename TSrc>
+BPF_TARGET_AVX2_F16C
+static __m256 Load8(const bpfUInt8* aSrc);
+
+template<>
+BPF_TARGET_AVX2_F16C
+__m256 Load8<bpfUInt8>(const bpfUInt8* aSrc)
+{
+  __m128i vBytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(aSrc));
+  return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(vBytes));
+}
+
+template<>
+BPF_TARGET_AVX2_F16C
+__m256 Load8<bpfUInt16>(const bpfUInt8* aSrc)
+{
+  __m128i vWords = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aSrc));
+  return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(vWords));
+}
+
+template<>
+BPF_TARGET_AVX2_F16C
+__m256 Load8<bpfUInt32>(const bpfUInt8* aSrc)
+{
+  __m256i vValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(aSrc));
+  __m256 vHigh = _mm256_cvtepi32_ps(_mm256_srli_epi32(vValues, 16));
+  __m256 vLow = _mm256_cvtepi32_ps(_mm256_and_si256(vValues, _mm256_set1_epi32(0xffff)));
+  return _mm256_add_ps(_mm256_mul_ps(vHigh, _mm256_set1_ps(65536.0f)), vLow);
+}
+
+template<>
+BPF_TARGET_AVX2_F16C
+__m256 Load8<bpfFloat>(const bpfUInt8* aSrc)
+{
+  return _mm256_loadu_ps(reinterpret_cast<const float*>(aSrc));
+}
+
+
+template<typename TSrc, bpfDataConverter::tType TDest>
+BPF_TARGET_AVX2_F16C
+static bpfSize ConvertAVX2(const bpfUInt8* aSrc, bpfSize aCount, bpfUInt8* aDest, bpfFloat aScale, bpfFloat aOffset)
+{
+  __m256 vScale = _mm256_set1_ps(aScale);
+  __m256 vOffset = _mm256_set1_ps(aOffset);
+  bpfSize vIndex = 0;
+  for (; vIndex + 8 <= aCount; vIndex += 8) {
+    // multiply and add separately, a fused multiply add would round differently than the scalar tail
+    __m256 vValues = _mm256_add_ps(_mm256_mul_ps(Load8<TSrc>(aSrc + vIndex * sizeof(TSrc)), vScale), vOffset);
+    if (TDest == bpfDataConverter::eFloat32) {
+      _mm256_storeu_ps(reinterpret_cast<float*>(aDest + vIndex * sizeof(float)), vValues);
+    }
+    else if (TDest == bpfDataConverter::eFloat16) {
+      __m128i vHalfs = _mm256_cvtps_ph(vValues, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(aDest + vIndex * sizeof(bpfUInt16)), vHalfs);
+    }
+    else {
+      vValues = _mm256_min_ps(_mm256_max_ps(vValues, _mm256_setzero_ps()), _mm256_set1_ps(255.0f));
+      __m256i vInts = _mm256_cvtps_epi32(vValues);
+      __m128i vWords = _mm_packs_epi32(_mm256_castsi256_si128(vInts), _mm256_extracti128_si256(vInts, 1));
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(aDest + vIndex), _mm_packus_epi16(vWords, vWords));
+    }
+  }
+  return vIndex;
+}
+
+
+// the table index of a row of values, vectorized, the table lookup itself is scalar
+
+template<typename TSrc>
+static bpfSize LookUpBinnedSSE2(const bpfUInt8* aSrc, bpfSize aCount, bpfUInt8* aDest, const std::vector<bpfUInt8>& aTable, bpfFloat aScale, bpfFloat aOffset)
+{
+  __m128 vScale = _mm_set1_ps(aScale);
+  __m128 vOffset = _mm_set1_ps(aOffset);
+  __m128 vMax = _mm_set1_ps(static_cast<bpfFloat>(aTable.size() - 1));
+  alignas(16) bpfInt32 vBins[4];
+  bpfSize vIndex = 0;
+  for (; vIndex + 4 <= aCount; vIndex += 4) {
+    __m128 vValues = _mm_add_ps(_mm_mul_ps(Load4<TSrc>(aSrc + vIndex * sizeof(TSrc)), vScale), vOffset);
+    vValues = _mm_min_ps(_mm_max_ps(vValues, _mm_setzero_ps()), vMax);
+    _mm_store_si128(reinterpret_cast<__m128i*>(vBins), _mm_cvtps_epi32(vValues));
+    for (bpfSize vLane = 0; vLane < 4; ++vLane) {
+      aDest[vIndex + vLane] = aTable[vBins[vLane]];
+    }
+  }
+  return vIndex;
+}
+
+
+template<typename TSrc>
+BPF_TARGET_AVX2_F16C
+static bpfSize LookUpBinnedAVX2(const bpfUInt8* aSrc, bpfSize aCount, bpfUInt8* aDest, const std::vector<bpfUInt8>& aTable, bpfFloat aScale, bpfFloat aOffset)
+{
+  __m256 vScale = _mm256_set1_ps(aScale);
+  __m256 vOffset = _mm256_set1_ps(aOffset);
+  __m256 vMax = _mm256_set1_ps(static_cast<bpfFloat>(aTable.size() - 1));
+  alignas(32) bpfInt32 vBins[8];
+  bpfSize vIndex = 0;
+  for (; vIndex + 8 <= aCount; vIndex += 8) {
+    __m256 vValues = _mm256_add_ps(_mm256_mul_ps(Load8<TSrc>(aSrc + vIndex * sizeof(TSrc)), vScale), vOffset);
+    vValues = _mm256_min_ps(_mm256_max_ps(vValues, _mm256_setzero_ps()), vMax);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(vBins), _mm256_cvtps_epi32(vValues));
+    for (bpfSize vLane = 0; vLane < 8; ++vLane) {
+      aDest[vIndex + vLane] = aTable[vBins[vLane]];
+    }
+  }
+  return vIndex;
+}
+
+#endif
+
+
+template<typename TSrc, bpfDataConverter::tType TDest>
+static void ConvertRow(const bpfUInt8* aSrc, bpfSize aCount, bpfUInt8* aDest, bpfFloat aScale, bpfFloat aOffset, bpfSize aDestSize)
+{
+  bpfSize vDone = 0;
+#if BPF_CONVERT_SIMD
+  vDone = HasAVX2AndF16C() ? ConvertAVX2<TSrc, TDest>(aSrc, aCount, aDest, aScale, aOffset) : ConvertSSE2<TSrc, TDest>(aSrc, aCount, aDest, aScale, aOffset);
+#endif
+  for (bpfSize vIndex = vDone; vIndex < aCount; ++vIndex) {
+    StoreScalar<TDest>(LoadScalar<TSrc>(aSrc + vIndex * sizeof(TSrc)) * aScale + aOffset, aDest + vIndex * aDestSize);
+  }
+}
+
+
+template<typename TSrc>
+static void ConvertRow(bpfDataConverter::tType aDestType, const bpfUInt8* aSrc, bpfSize aCount, bpfUInt8* aDest, bpfFloat aScale, bpfFloat aOffset, bpfSize aDestSize)
+{
+  switch (aDestType) {
+  case bpfDataConverter::eUInt8:
+    ConvertRow<TSrc, bpfDataConverter::eUInt8>(aSrc, aCount, aDest, aScale, aOffset, aDestSize);
+    break;
+  case bpfDataConverter::eFloat32:
+    ConvertRow<TSrc, bpfDataConverter::eFloat32>(aSrc, aCount, aDest, aScale, aOffset, aDestSize);
+    break;
+  case bpfDataConverter::eFloat16:
+    ConvertRow<TSrc, bpfDataConverter::eFloat16>(aSrc, aCount, aDest, aScale, aOffset, aDestSize);
+    break;
+  default:
+    break;
+  }
+}
+
+
+template<typename TSrc>
+static void LookUpRow(const bpfUInt8* aSrc, bpfSize aCount, bpfUInt8* aDest, const std::vector<bpfUInt8>& aTable)
+{
+  for (bpfSize vIndex = 0; vIndex < aCount; ++vIndex) {
+    TSrc vValue;
+    std::memcpy(&vValue, aSrc + vIndex * sizeof(TSrc), sizeof(TSrc));
+    aDest[vIndex] = aTable[vValue];
+  }
+}
+
+
+template<typename TSrc>
+static void LookUpBinnedRow(const bpfUInt8* aSrc, bpfSize aCount, bpfUInt8* aDest, const std::vector<bpfUInt8>& aTable, bpfFloat aScale, bpfFloat aOffset)
+{
+  bpfSize vDone = 0;
+#if BPF_CONVERT_SIMD
+  vDone = HasAVX2AndF16C() ? LookUpBinnedAVX2<TSrc>(aSrc, aCount, aDest, aTable, aScale, aOffset) : LookUpBinnedSSE2<TSrc>(aSrc, aCount, aDest, aTable, aScale, aOffset);
+#endif
+  bpfFloat vMax = static_cast<bpfFloat>(aTable.size() - 1);
+  for (bpfSize vIndex = vDone; vIndex < aCount; ++vIndex) {
+    bpfFloat vBin = LoadScalar<TSrc>(aSrc + vIndex * sizeof(TSrc)) * aScale + aOffset;
+    vBin = vBin > 0.0f ? vBin : 0.0f;
+    vBin = vBin < vMax ? vBin : vMax;
+    aDest[vIndex] = aTable[static_cast<bpfSize>(std::nearbyint(vBin))];
+  }
+}
+
+
+bpfDataConverter::bpfDataConverter(tType aSrcType, tType aDestType, bpfFloat aScale, bpfFloat aOffset)
+  : mSrcType(aSrcType),
+    mDestType(aDestType),
+    mScale(aScale),
+    mOffset(aOffset)
+{
+}
+
+
+bpfDataConverter::bpfDataConverter(tType aSrcType, bpfFloat aRangeMin, bpfFloat aRangeMax, bpfFloat aGammaCorrection)
+  : mSrcType(aSrcType),
+    mDestType(eUInt8),
+    mScale(1),
+    mOffset(0)
+{
+  // an empty window becomes a step at aRangeMin
+  bpfFloat vRange = std::max(aRangeMax - aRangeMin, std::numeric_limits<bpfFloat>::epsilon() * std::max(std::abs(aRangeMin), 1.0f));
+  bool vIsInteger = aSrcType == eUInt8 || aSrcType == eUInt16;
+  bpfSize vTableSize = aSrcType == eUInt8 ? 256 : 65536;
+  if (!vIsInteger && aGammaCorrection == 1.0f) {
+    // a linear window needs no table
+    mScale = 255.0f / vRange;
+    mOffset = -aRangeMin * mScale;
+    return;
+  }
+
+  // same mapping as cColorInfo::GetColor, the table is built once per window
+  mTable.resize(vTableSize);
+  for (bpfSize vIndex = 0; vIndex < vTableSize; ++vIndex) {
+    bpfFloat vValue = vIsInteger ? static_cast<bpfFloat>(vIndex) : aRangeMin + vRange * vIndex / (vTableSize - 1);
+    bpfFloat vIntensity = 1;
+    if (vValue <= aRangeMin) {
+      vIntensity = 0;
+    }
+    else if (vValue < aRangeMax) {
+      vIntensity = (vValue - aRangeMin) / vRange;
+      if (aGammaCorrection != 1.0f) {
+        vIntensity = std::pow(vIntensity, 1.0f / aGammaCorrection);
+      }
+    }
+    mTable[vIndex] = static_cast<bpfUInt8>(std::nearbyint(vIntensity * 255.0f));
+  }
+  if (!vIsInteger) {
+    mScale = (vTableSize - 1) / vRange;
+    mOffset = -aRangeMin * mScale;
+  }
+}
+
+
+bpfSize bpfDataConverter::GetSize(tType aType)
+{
+  switch (aType) {
+  case eUInt8:
+    return 1;
+  case eUInt16:
+  case eFloat16:
+    return 2;
+  default:
+    return 4;
+  }
+}
+
+
+bpfSize bpfDataConverter::GetSrcSize() const
+{
+  return GetSize(mSrcType);
+}
+
+
+bpfSize bpfDataConverter::GetDestSize() const
+{
+  return GetSize(mDestType);
+}
+
+
+void bpfDataConverter::Convert(const bpfUInt8* aSrc, bpfSize aCount, bpfUInt8* aDest) const
+{
+  if (!mTable.empty()) {
+    switch (mSrcType) {
+    case eUInt8:
+      LookUpRow<bpfUInt8>(aSrc, aCount, aDest, mTable);
+      break;
+    case eUInt16:
+      LookUpRow<bpfUInt16>(aSrc, aCount, aDest, mTable);
+      break;
+    case eUInt32:
+      LookUpBinnedRow<bpfUInt32>(aSrc, aCount, aDest, mTable, mScale, mOffset);
+      break;
+    case eFloat32:
+      LookUpBinnedRow<bpfFloat>(aSrc, aCount, aDest, mTable, mScale, mOffset);
+      break;
+    default:
+      break;
+    }
+    return;
+  }
+
+  if (mSrcType == mDestType && mScale == 1.0f && mOffset == 0.0f) {
+    std::memcpy(aDest, aSrc, aCount * GetSrcSize());
+    return;
+  }
+
+  bpfSize vDestSize = GetDestSize();
+  switch (mSrcType) {
+  case eUInt8:
+    ConvertRow<bpfUInt8>(mDestType, aSrc, aCount, aDest, mScale, mOffset, vDestSize);
+    break;
+  case eUInt16:
+    ConvertRow<bpfUInt16>(mDestType, aSrc, aCount, aDest, mScale, mOffset, vDestSize);
+    break;
+  case eUInt32:
+    ConvertRow<bpfUInt32>(mDestType, aSrc, aCount, aDest, mScale, mOffset, vDestSize);
+    break;
+  case eFloat32:
+    ConvertRow<bpfFloat>(mDestType, aSrc, aCount, aDest, mScale, mOffset, vDestSize);
+    break;
+  default:
+    break;
+  }
+}
@@ -0,0 +1,105 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BPF_DATA_CONVERTER__
+#define __BPF_DATA_CONVERTER__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+
+#include <vector>
+
+
+/**
+ * Converts rows of voxels from the stored type of a dataset to another type while
+ * applying value * scale + offset, so that reads can write their output type directly.
+ *
+ * Source types are eUInt8, eUInt16, eUInt32 and eFloat32, destination types eUInt8,
+ * eFloat32 and eFloat16 (IEEE half precision). Uses AVX2 and F16C or SSE2 if available.
+ */
+class bpfDataConverter
+{
+public:
+  enum tType {
+    eUInt8,
+    eUInt16,
+    eUInt32,
+    eFloat32,
+    eFloat16
+  };
+
+  template<typename TDataType>
+  static tType GetType();
+
+  bpfDataConverter(tType aSrcType, tType aDestType, bpfFloat aScale, bpfFloat aOffset);
+
+  /**
+   * Maps the display window [aRangeMin, aRangeMax] to uint8 with gamma correction, like the
+   * intensity of cColorInfo::GetColor. Uses a lookup table over all values for uint8 and uint16
+   * sources and over 65536 steps of the window for uint32 and float sources.
+   */
+  bpfDataConverter(tType aSrcType, bpfFloat aRangeMin, bpfFloat aRangeMax, bpfFloat aGammaCorrection);
+
+  bpfSize GetSrcSize() const;
+  bpfSize GetDestSize() const;
+
+  /**
+   * Converts aCount elements from aSrc to aDest. uint8 results are rounded to the nearest
+   * integer and clamped to [0, 255], NaN becomes 0. float16 results are rounded to nearest even.
+   */
+  void Convert(const bpfUInt8* aSrc, bpfSize aCount, bpfUInt8* aDest) const;
+
+private:
+  static bpfSize GetSize(tType aType);
+
+  tType mSrcType;
+  tType mDestType;
+  bpfFloat mScale;
+  bpfFloat mOffset;
+
+  // uint8 results by source value, or by bin (value * mScale + mOffset) for uint32 and float; empty if unused
+  std::vector<bpfUInt8> mTable;
+};
+
+
+template<>
+inline bpfDataConverter::tType bpfDataConverter::GetType<bpfUInt8>()
+{
+  return eUInt8;
+}
+
+template<>
+inline bpfDataConverter::tType bpfDataConverter::GetType<bpfUInt16>()
+{
+  return eUInt16;
+}
+
+template<>
+inline bpfDataConverter::tType bpfDataConverter::GetType<bpfUInt32>()
+{
+  return eUInt32;
+}
+
+template<>
+inline bpfDataConverter::tType bpfDataConverter::GetType<bpfFloat>()
+{
+  return eFloat32;
+}
+
+
+#endif // __BPF_DATA_CONVERTER__
@@ -429,6 +429,21 @@ bpfUInt64 bpfFileTools::GetFileSize(const bpfString& aFileName)
 }
 
 
+bpfInt64 bpfFileTools::GetFileModificationTime(const bpfString& aFileName)
+{
+  try {
+#ifdef BP_UTF8_FILENAMES
+    return static_cast<bpfInt64>(fs::last_write_time(FromUtf8Path(aFileName)));
+#else
+    return static_cast<bpfInt64>(fs::last_write_time(aFileName));
+#endif
+  }
+  catch (fs::filesystem_error& eE) {
+    throw bpfException(eE.what());
+  }
+}
+
+
 bpfString bpfFileTools::GetAbsoluteFilePath(const bpfString& aFileName)
 {
 #ifdef BP_UTF8_FILENAMES
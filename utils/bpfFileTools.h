@@ -142,6 +142,11 @@ std::list<bpfString> GetDirectoriesOfDirectory(const bpfString& aPath);
  */
 bpfUInt64 GetFileSize(const bpfString& aFileName);
 
+/**
+ * Return the time of the last modification of a file, in seconds since the epoch.
+ */
+bpfInt64 GetFileModificationTime(const bpfString& aFileName);
+
 /**
  * Get the full path of a file
  * "image.tif" => "c:/data/image.tif"
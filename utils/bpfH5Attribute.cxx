@@ -0,0 +1,94 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/utils/bpfH5Attribute.h"
+
+
+bool bpfH5ReadAttributeString(const bpfString& aAttributeName, bpfString& aAttributeValue, hid_t aAttributeLocation)
+{
+  auto vExists = H5Aexists(aAttributeLocation, aAttributeName.c_str());
+
+  if (vExists <= 0) {
+    BP_DEBUG_MSG("ReadAttribute() - Could not find attribute with name: " + aAttributeName);
+    return false;
+  }
+
+  hid_t vAttributeId = H5Aopen_by_name(aAttributeLocation, ".", aAttributeName.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+
+  if (vAttributeId < 0) {
+    BP_DEBUG_MSG("ReadAttribute() - Could not find attribute with name: " + aAttributeName);
+    return false;
+  }
+
+  hid_t vAttributeTypeId = H5Aget_type(vAttributeId);
+
+  if (vAttributeTypeId < 0) {
+    H5Aclose(vAttributeId);
+    BP_DEBUG_MSG("ReadAttribute() - Could not get datatype from attribute" + aAttributeName);
+    return false;
+  }
+
+  hid_t vAttributeSpaceId = H5Aget_space(vAttributeId);
+
+  if (vAttributeSpaceId < 0) {
+    H5Tclose(vAttributeTypeId);
+    H5Aclose(vAttributeId);
+    BP_DEBUG_MSG("ReadAttribute() - Could not get dataspace from attribute" + aAttributeName);
+    return false;
+  }
+
+  bpfInt32 vAttributeRank = H5Sget_simple_extent_ndims(vAttributeSpaceId);
+
+  if (vAttributeRank != 1) {
+    H5Sclose(vAttributeSpaceId);
+    H5Tclose(vAttributeTypeId);
+    H5Aclose(vAttributeId);
+    BP_DEBUG_MSG("ReadAttribute() - Dataspace rank of attribute " + aAttributeName + " is not 1!");
+    return false;
+  }
+
+  hsize_t vAttributeSize = 0;
+
+  if (H5Sget_simple_extent_dims(vAttributeSpaceId, &vAttributeSize, nullptr) < 0) {
+    H5Sclose(vAttributeSpaceId);
+    H5Tclose(vAttributeTypeId);
+    H5Aclose(vAttributeId);
+    BP_DEBUG_MSG("ReadAttribute() - Could not get size of attribute " + aAttributeName);
+    return false;
+  }
+
+  bpfChar* vBuffer = new bpfChar[(bpfSize)vAttributeSize + 1];
+  vBuffer[vAttributeSize] = '\0';
+
+  if (H5Aread(vAttributeId, vAttributeTypeId, vBuffer) < 0) {
+    delete[] vBuffer;
+    H5Sclose(vAttributeSpaceId);
+    H5Tclose(vAttributeTypeId);
+    H5Aclose(vAttributeId);
+    BP_DEBUG_MSG("ReadAttribute() - Could not read attribute " + aAttributeName + "!");
+    return false;
+  }
+
+  aAttributeValue = vBuffer;
+
+  delete[] vBuffer;
+  H5Sclose(vAttributeSpaceId);
+  H5Tclose(vAttributeTypeId);
+  H5Aclose(vAttributeId);
+
+  return true;
+}
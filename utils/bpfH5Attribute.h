@@ -0,0 +1,34 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#ifndef __BPF_H5_ATTRIBUTE__
+#define __BPF_H5_ATTRIBUTE__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+
+#include "hdf5.h"
+
+
+/**
+ * Reads the one dimensional string attribute aAttributeName of aAttributeLocation into aAttributeValue.
+ * Returns false if the attribute does not exist or cannot be read, aAttributeValue is then unchanged.
+ */
+bool bpfH5ReadAttributeString(const bpfString& aAttributeName, bpfString& aAttributeValue, hid_t aAttributeLocation);
+
+
+#endif // __BPF_H5_ATTRIBUTE__
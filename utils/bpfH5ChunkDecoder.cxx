@@ -0,0 +1,442 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/utils/bpfH5ChunkDecoder.h"
+
+#include "ImarisReader/utils/bpfH5LZ4.h"
+
+#include <zlib.h>
+
+#include <atomic>
+#include <cstring>
+
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BPF_UNSHUFFLE_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BPF_TARGET_AVX2
+#else
+#define BPF_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define BPF_UNSHUFFLE_SIMD 0
+#endif
+
+
+static std::atomic<bool>& GetIsAVX2Enabled()
+{
+  static std::atomic<bool> vIsEnabled(true);
+  return vIsEnabled;
+}
+
+
+#if BPF_UNSHUFFLE_SIMD
+
+static bool HasAVX2()
+{
+#if defined(_MSC_VER)
+  static const bool vHasAVX2 = [] {
+    int vInfo[4];
+    __cpuidex(vInfo, 7, 0);
+    return (vInfo[1] & (1 << 5)) != 0;
+  }();
+#else
+  static const bool vHasAVX2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+  return vHasAVX2 && GetIsAVX2Enabled();
+}
+
+
+// the Unshuffle functions below take the byte planes of aNumberOfElements elements and write
+// the elements [aBegin, aBegin + aCount) to aDest, returning how many elements they handled
+
+static bpfSize Unshuffle2SSE2(const bpfUInt8* aSrc, bpfSize aNumberOfElements, bpfSize aBegin, bpfSize aCount, bpfUInt8* aDest)
+{
+  const bpfUInt8* vSrc0 = aSrc + aBegin;
+  const bpfUInt8* vSrc1 = vSrc0 + aNumberOfElements;
+  bpfSize vIndex = 0;
+  for (; vIndex + 16 <= aCount; vIndex += 16) {
+    __m128i vByte0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vSrc0 + vIndex));
+    __m128i vByte1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vSrc1 + vIndex));
+    __m128i* vDest = reinterpret_cast<__m128i*>(aDest + 2 * vIndex);
+    _mm_storeu_si128(vDest, _mm_unpacklo_epi8(vByte0, vByte1));
+    _mm_storeu_si128(vDest + 1, _mm_unpackhi_epi8(vByte0, vByte1));
+  }
+  return vIndex;
+}
+
+
+static bpfSize Unshuffle4SSE2(const bpfUInt8* aSrc, bpfSize aNumberOfElements, bpfSize aBegin, bpfSize aCount, bpfUInt8* aDest)
+{
+  const bpfUInt8* vSrc0 = aSrc + aBegin;
+  const bpfUInt8* vSrc1 = vSrc0 + aNumberOfElements;
+  const bpfUInt8* vSrc2 = vSrc1 + aNumberOfElements;
+  const bpfUInt8* vSrc3 = vSrc2 + aNumberOfElements;
+  bpfSize vIndex = 0;
+  for (; vIndex + 16 <= aCount; vIndex += 16) {
+    __m128i vByte0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vSrc0 + vIndex));
+    __m128i vByte1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vSrc1 + vIndex));
+    __m128i vByte2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vSrc2 + vIndex));
+    __m128i vByte3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vSrc3 + vIndex));
+    __m128i vLow01 = _mm_unpacklo_epi8(vByte0, vByte1);
+    __m128i vHigh01 = _mm_unpackhi_epi8(vByte0, vByte1);
+    __m128i vLow23 = _mm_unpacklo_epi8(vByte2, vByte3);
+    __m128i vHigh23 = _mm_unpackhi_epi8(vByte2, vByte3);
+    __m128i* vDest = reinterpret_cast<__m128i*>(aDest + 4 * vIndex);
+    _mm_storeu_si128(vDest, _mm_unpacklo_epi16(vLow01, vLow23));
+    _mm_storeu_si128(vDest + 1, _mm_unpackhi_epi16(vLow01, vLow23));
+    _mm_storeu_si128(vDest + 2, _mm_unpacklo_epi16(vHigh01, vHigh23));
+    _mm_storeu_si128(vDest + 3, _mm_unpackhi_epi16(vHigh01, vHigh23));
+  }
+  return vIndex;
+}
+
+
+BPF_TARGET_AVX2
+static bpfSize Unshuffle2AVX2(const bpfUInt8* aSrc, bpfSize aNumberOfElements, bpfSize aBegin, bpfSize aCount, bpfUInt8* aDest)
+{
+  const bpfUInt8* vSrc0 = aSrc + aBegin;
+  const bpfUInt8* vSrc1 = vSrc0 + aNumberOfElements;
+  bpfSize vIndex = 0;
+  for (; vIndex + 32 <= aCount; vIndex += 32) {
+    __m256i vByte0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vSrc0 + vIndex));
+    __m256i vByte1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vSrc1 + vIndex));
+    // unpack works per 128 bit lane, the permutes restore the element order
+    __m256i vLow = _mm256_unpacklo_epi8(vByte0, vByte1);
+    __m256i vHigh = _mm256_unpackhi_epi8(vByte0, vByte1);
+    __m256i* vDest = reinterpret_cast<__m256i*>(aDest + 2 * vIndex);
+    _mm256_storeu_si256(vDest, _mm256_permute2x128_si256(vLow, vHigh, 0x20));
+    _mm256_storeu_si256(vDest + 1, _mm256_permute2x128_si256(vLow, vHigh, 0x31));
+  }
+  return vIndex;
+}
+
+
+BPF_TARGET_AVX2
+static bpfSize Unshuffle4AVX2(const bpfUInt8* aSrc, bpfSize aNumberOfElements, bpfSize aBegin, bpfSize aCount, bpfUInt8* aDest)
+{
+  const bpfUInt8* vSrc0 = aSrc + aBegin;
+  const bpfUInt8* vSrc1 = vSrc0 + aNumberOfElements;
+  const bpfUInt8* vSrc2 = vSrc1 + aNumberOfElements;
+  const bpfUInt8* vSrc3 = vSrc2 + aNumberOfElements;
+  bpfSize vIndex = 0;
+  for (; vIndex + 32 <= aCount; vIndex += 32) {
+    __m256i vByte0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vSrc0 + vIndex));
+    __m256i vByte1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vSrc1 + vIndex));
+    __m256i vByte2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vSrc2 + vIndex));
+    __m256i vByte3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vSrc3 + vIndex));
+    __m256i vLow01 = _mm256_unpacklo_epi8(vByte0, vByte1);
+    __m256i vHigh01 = _mm256_unpackhi_epi8(vByte0, vByte1);
+    __m256i vLow23 = _mm256_unpacklo_epi8(vByte2, vByte3);
+    __m256i vHigh23 = _mm256_unpackhi_epi8(vByte2, vByte3);
+    // per lane: elements [0, 4) [4, 8) [8, 12) [12, 16) of the lane's 16 elements
+    __m256i vElements0 = _mm256_unpacklo_epi16(vLow01, vLow23);
+    __m256i vElements1 = _mm256_unpackhi_epi16(vLow01, vLow23);
+    __m256i vElements2 = _mm256_unpacklo_epi16(vHigh01, vHigh23);
+    __m256i vElements3 = _mm256_unpackhi_epi16(vHigh01, vHigh23);
+    __m256i* vDest = reinterpret_cast<__m256i*>(aDest + 4 * vIndex);
+    _mm256_storeu_si256(vDest, _mm256_permute2x128_si256(vElements0, vElements1, 0x20));
+    _mm256_storeu_si256(vDest + 1, _mm256_permute2x128_si256(vElements2, vElements3, 0x20));
+    _mm256_storeu_si256(vDest + 2, _mm256_permute2x128_si256(vElements0, vElements1, 0x31));
+    _mm256_storeu_si256(vDest + 3, _mm256_permute2x128_si256(vElements2, vElements3, 0x31));
+  }
+  return vIndex;
+}
+
+#endif
+
+
+/**
+ * Writes the elements [aBegin, aBegin + aCount) of the shuffled aSrc, which holds
+ * aNumberOfElements elements of aTypeSize bytes, to aDest.
+ */
+static void Unshuffle(const bpfUInt8* aSrc, bpfSize aNumberOfElements, bpfSize aTypeSize, bpfSize aBegin, bpfSize aCount, bpfUInt8* aDest)
+{
+  bpfSize vDone = 0;
+#if BPF_UNSHUFFLE_SIMD
+  if (aTypeSize == 2) {
+    vDone = HasAVX2() ? Unshuffle2AVX2(aSrc, aNumberOfElements, aBegin, aCount, aDest) : Unshuffle2SSE2(aSrc, aNumberOfElements, aBegin, aCount, aDest);
+  }
+  else if (aTypeSize == 4) {
+    vDone = HasAVX2() ? Unshuffle4AVX2(aSrc, aNumberOfElements, aBegin, aCount, aDest) : Unshuffle4SSE2(aSrc, aNumberOfElements, aBegin, aCount, aDest);
+  }
+#endif
+
+  for (bpfSize vByte = 0; vByte < aTypeSize; ++vByte) {
+    const bpfUInt8* vSrc = aSrc + vByte * aNumberOfElements + aBegin;
+    bpfUInt8* vDest = aDest + vByte;
+    for (bpfSize vIndex = vDone; vIndex < aCount; ++vIndex) {
+      vDest[vIndex * aTypeSize] = vSrc[vIndex];
+    }
+  }
+}
+
+
+static void Unshuffle(const bpfUInt8* aSrc, bpfSize aSize, bpfSize aTypeSize, bpfUInt8* aDest)
+{
+  bpfSize vNumberOfElements = aSize / aTypeSize;
+  Unshuffle(aSrc, vNumberOfElements, aTypeSize, 0, vNumberOfElements, aDest);
+  // trailing bytes that do not form a full element are not shuffled
+  bpfSize vShuffled = vNumberOfElements * aTypeSize;
+  std::memcpy(aDest + vShuffled, aSrc + vShuffled, aSize - vShuffled);
+}
+
+
+bpfH5ChunkDecoder::bpfH5ChunkDecoder(hid_t aDataId, hid_t aMemTypeId)
+  : mTypeSize(0),
+    mIsSupported(false)
+{
+  hid_t vTypeId = H5Dget_type(aDataId);
+  if (vTypeId < 0) {
+    return;
+  }
+  mTypeSize = H5Tget_size(vTypeId);
+  bool vIsNativeType = H5Tequal(vTypeId, aMemTypeId) > 0;
+  H5Tclose(vTypeId);
+  if (!vIsNativeType) {
+    return;
+  }
+
+  hid_t vPlist = H5Dget_create_plist(aDataId);
+  if (vPlist < 0) {
+    return;
+  }
+  if (H5Pget_layout(vPlist) != H5D_CHUNKED) {
+    H5Pclose(vPlist);
+    return;
+  }
+
+  // zero unless the dataset defines one
+  mFillValue.assign(mTypeSize, 0);
+  H5Pget_fill_value(vPlist, aMemTypeId, mFillValue.data());
+
+  mIsSupported = true;
+  int vNumFilters = H5Pget_nfilters(vPlist);
+  for (int vIndex = 0; vIndex < vNumFilters; ++vIndex) {
+    cFilter vFilter;
+    unsigned int vFlags = 0;
+    size_t vNumValues = 8;
+    vFilter.mValues.resize(vNumValues);
+    vFilter.mId = H5Pget_filter2(vPlist, vIndex, &vFlags, &vNumValues, vFilter.mValues.data(), 0, nullptr, nullptr);
+    vFilter.mValues.resize(std::min<size_t>(vNumValues, 8));
+    if (vFilter.mId != H5Z_FILTER_DEFLATE && vFilter.mId != H5Z_FILTER_SHUFFLE && vFilter.mId != H5Z_FILTER_LZ4) {
+      mIsSupported = false;
+    }
+    mFilters.push_back(vFilter);
+  }
+  H5Pclose(vPlist);
+}
+
+
+bool bpfH5ChunkDecoder::IsSupported() const
+{
+  return mIsSupported;
+}
+
+
+bool bpfH5ChunkDecoder::Decode(const bpfUInt8* aSrc, bpfSize aSrcSize, bpfUInt32 aFilterMask, bpfUInt8* aDest, bpfSize aDestSize, bpfThreadPool* aThreadPool) const
+{
+  bpfSize vLastFilter = GetLastFilter(aFilterMask);
+  if (vLastFilter == mFilters.size()) {
+    if (aSrcSize < aDestSize) {
+      return false;
+    }
+    std::memcpy(aDest, aSrc, aDestSize);
+    return true;
+  }
+
+  const bpfUInt8* vSrc = Run(aSrc, aSrcSize, aFilterMask, vLastFilter + 1, aDestSize, aThreadPool);
+  if (!vSrc) {
+    return false;
+  }
+  return Apply(mFilters[vLastFilter], vSrc, aSrcSize, aDest, aDestSize, aThreadPool) == aDestSize;
+}
+
+
+bool bpfH5ChunkDecoder::DecodeRegion(const bpfUInt8* aSrc, bpfSize aSrcSize, bpfUInt32 aFilterMask, const cRegion& aRegion, bpfThreadPool* aThreadPool) const
+{
+  bpfSize vNumberOfElements = aRegion.mChunkDim[0] * aRegion.mChunkDim[1] * aRegion.mChunkDim[2];
+  bpfSize vDestSize = vNumberOfElements * mTypeSize;
+  bpfSize vLastFilter = GetLastFilter(aFilterMask);
+
+  // a trailing shuffle writes its rows directly to the destination, without unshuffling the whole chunk
+  bool vUnshuffle = vLastFilter < mFilters.size() && mFilters[vLastFilter].mId == H5Z_FILTER_SHUFFLE && mTypeSize > 1 &&
+    (mFilters[vLastFilter].mValues.empty() || mFilters[vLastFilter].mValues[0] == mTypeSize);
+
+  const bpfUInt8* vDecoded = nullptr;
+  if (vLastFilter == mFilters.size()) {
+    if (aSrcSize < vDestSize) {
+      return false;
+    }
+    vDecoded = aSrc;
+  }
+  else if (vUnshuffle) {
+    vDecoded = Run(aSrc, aSrcSize, aFilterMask, vLastFilter + 1, vDestSize, aThreadPool);
+    if (!vDecoded || aSrcSize != vDestSize) {
+      return false;
+    }
+  }
+  else {
+    thread_local std::vector<bpfUInt8> vBuffer;
+    vBuffer.resize(vDestSize);
+    if (!Decode(aSrc, aSrcSize, aFilterMask, vBuffer.data(), vDestSize, aThreadPool)) {
+      return false;
+    }
+    vDecoded = vBuffer.data();
+  }
+
+  bpfSize vRowSize = aRegion.mEnd[2] - aRegion.mBegin[2];
+  const bpfDataConverter* vConverter = aRegion.mConverter;
+  bpfSize vDestTypeSize = vConverter ? vConverter->GetDestSize() : mTypeSize;
+  bool vIsDenseRow = aRegion.mDestStride[2] == vDestTypeSize;
+  // a row goes straight to a dense destination by its last step, unshuffle, conversion or copy
+  bool vUnshuffleToDest = vUnshuffle && vIsDenseRow && !vConverter;
+  thread_local std::vector<bpfUInt8> vRow;
+  thread_local std::vector<bpfUInt8> vConvertedRow;
+  if (vUnshuffle && !vUnshuffleToDest) {
+    vRow.resize(vRowSize * mTypeSize);
+  }
+  if (vConverter && !vIsDenseRow) {
+    vConvertedRow.resize(vRowSize * vDestTypeSize);
+  }
+
+  for (bpfSize vZ = aRegion.mBegin[0]; vZ < aRegion.mEnd[0]; ++vZ) {
+    for (bpfSize vY = aRegion.mBegin[1]; vY < aRegion.mEnd[1]; ++vY) {
+      bpfUInt8* vDest = aRegion.mDest + (vZ - aRegion.mBegin[0]) * aRegion.mDestStride[0] + (vY - aRegion.mBegin[1]) * aRegion.mDestStride[1];
+      bpfSize vBegin = (vZ * aRegion.mChunkDim[1] + vY) * aRegion.mChunkDim[2] + aRegion.mBegin[2];
+      const bpfUInt8* vSrc = vDecoded + vBegin * mTypeSize;
+      if (vUnshuffle) {
+        bpfUInt8* vRowDest = vUnshuffleToDest ? vDest : vRow.data();
+        Unshuffle(vDecoded, vNumberOfElements, mTypeSize, vBegin, vRowSize, vRowDest);
+        vSrc = vRowDest;
+      }
+      if (vConverter) {
+        bpfUInt8* vRowDest = vIsDenseRow ? vDest : vConvertedRow.data();
+        vConverter->Convert(vSrc, vRowSize, vRowDest);
+        vSrc = vRowDest;
+      }
+      if (vIsDenseRow) {
+        if (!vUnshuffleToDest && !vConverter) {
+          std::memcpy(vDest, vSrc, vRowSize * mTypeSize);
+        }
+        continue;
+      }
+      for (bpfSize vX = 0; vX < vRowSize; ++vX) {
+        std::memcpy(vDest + vX * aRegion.mDestStride[2], vSrc + vX * vDestTypeSize, vDestTypeSize);
+      }
+    }
+  }
+  return true;
+}
+
+
+void bpfH5ChunkDecoder::SetAVX2Enabled(bool aIsEnabled)
+{
+  GetIsAVX2Enabled() = aIsEnabled;
+}
+
+
+bool bpfH5ChunkDecoder::HasShuffle() const
+{
+  for (const cFilter& vFilter : mFilters) {
+    if (vFilter.mId == H5Z_FILTER_SHUFFLE) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+bool bpfH5ChunkDecoder::HasFilters() const
+{
+  return !mFilters.empty();
+}
+
+
+const bpfUInt8* bpfH5ChunkDecoder::GetFillValue() const
+{
+  return mFillValue.data();
+}
+
+
+bpfSize bpfH5ChunkDecoder::GetLastFilter(bpfUInt32 aFilterMask) const
+{
+  // filters are applied in reverse order when reading, the first active one is applied last
+  bpfSize vNumFilters = mFilters.size();
+  for (bpfSize vIndex = 0; vIndex < vNumFilters; ++vIndex) {
+    if ((aFilterMask & (1u << vIndex)) == 0) {
+      return vIndex;
+    }
+  }
+  return vNumFilters;
+}
+
+
+const bpfUInt8* bpfH5ChunkDecoder::Run(const bpfUInt8* aSrc, bpfSize& aSrcSize, bpfUInt32 aFilterMask, bpfSize aFirstFilter, bpfSize aDestSize, bpfThreadPool* aThreadPool) const
+{
+  thread_local std::vector<bpfUInt8> vBuffers[2];
+  bpfSize vBufferIndex = 0;
+  const bpfUInt8* vSrc = aSrc;
+  for (bpfSize vIndex = mFilters.size(); vIndex-- > aFirstFilter; ) {
+    if ((aFilterMask & (1u << vIndex)) != 0) {
+      continue;
+    }
+    vBuffers[vBufferIndex].resize(aDestSize);
+    bpfUInt8* vDest = vBuffers[vBufferIndex].data();
+    vBufferIndex = 1 - vBufferIndex;
+    aSrcSize = Apply(mFilters[vIndex], vSrc, aSrcSize, vDest, aDestSize, aThreadPool);
+    if (aSrcSize == 0) {
+      return nullptr;
+    }
+    vSrc = vDest;
+  }
+  return vSrc;
+}
+
+
+bpfSize bpfH5ChunkDecoder::Apply(const cFilter& aFilter, const bpfUInt8* aSrc, bpfSize aSrcSize, bpfUInt8* aDest, bpfSize aDestSize, bpfThreadPool* aThreadPool) const
+{
+  switch (aFilter.mId) {
+  case H5Z_FILTER_DEFLATE: {
+    uLongf vDestSize = static_cast<uLongf>(aDestSize);
+    if (uncompress(aDest, &vDestSize, aSrc, static_cast<uLong>(aSrcSize)) != Z_OK) {
+      return 0;
+    }
+    return vDestSize;
+  }
+  case H5Z_FILTER_SHUFFLE: {
+    if (aSrcSize > aDestSize) {
+      return 0;
+    }
+    bpfSize vTypeSize = aFilter.mValues.empty() ? mTypeSize : aFilter.mValues[0];
+    if (vTypeSize <= 1) {
+      std::memcpy(aDest, aSrc, aSrcSize);
+    }
+    else {
+      Unshuffle(aSrc, aSrcSize, vTypeSize, aDest);
+    }
+    return aSrcSize;
+  }
+  default:
+    if (aFilter.mId == H5Z_FILTER_LZ4) {
+      return bpfH5LZ4Decode(aSrc, aSrcSize, aDest, aDestSize, aThreadPool);
+    }
+    return 0;
+  }
+}
@@ -0,0 +1,110 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#ifndef __BPF_H5_CHUNK_DECODER__
+#define __BPF_H5_CHUNK_DECODER__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+#include "ImarisReader/utils/bpfDataConverter.h"
+
+#include "hdf5.h"
+
+#include <vector>
+
+
+class bpfThreadPool;
+
+
+/**
+ * Reverses the filter pipeline of a chunked dataset outside of HDF5, so that
+ * raw chunks obtained with H5Dread_chunk can be decoded on any thread.
+ *
+ * Supported filters are deflate (gzip), shuffle and lz4. For other filters,
+ * or if the stored type differs from the native memory type, IsSupported()
+ * returns false and the caller has to read through H5Dread.
+ */
+class bpfH5ChunkDecoder
+{
+public:
+  bpfH5ChunkDecoder(hid_t aDataId, hid_t aMemTypeId);
+
+  /**
+   * Part of a chunk and where it goes. Coordinates are in hdf5 order, [z, y, x], relative
+   * to the chunk start. mDest receives element mBegin, the strides are in bytes.
+   * If mConverter is set, the rows are converted to its destination type on the way.
+   */
+  struct cRegion
+  {
+    bpfSize mChunkDim[3];
+    bpfSize mBegin[3];
+    bpfSize mEnd[3];
+    bpfUInt8* mDest;
+    bpfSize mDestStride[3];
+    const bpfDataConverter* mConverter = nullptr;
+  };
+
+  bool IsSupported() const;
+
+  bool HasShuffle() const;
+
+  // chunks of a dataset without filters are stored as they are in memory
+  bool HasFilters() const;
+
+  // the fill value of the dataset in the memory type, which chunks that were never written hold
+  const bpfUInt8* GetFillValue() const;
+
+  /**
+   * Decodes the raw chunk aSrc of aSrcSize bytes into aDest, which holds aDestSize bytes
+   * (the uncompressed size of a full chunk). aFilterMask is the mask returned by
+   * H5Dread_chunk, a set bit i means that filter i was skipped for this chunk.
+   * If aThreadPool is set, the blocks of an lz4 chunk are decoded on it.
+   */
+  bool Decode(const bpfUInt8* aSrc, bpfSize aSrcSize, bpfUInt32 aFilterMask, bpfUInt8* aDest, bpfSize aDestSize, bpfThreadPool* aThreadPool = nullptr) const;
+
+  /**
+   * Decodes the raw chunk aSrc and writes aRegion of it to the destination. If shuffle is the
+   * last filter to reverse, it is fused with the copy and only the rows of aRegion are unshuffled.
+   * aThreadPool as for Decode.
+   */
+  bool DecodeRegion(const bpfUInt8* aSrc, bpfSize aSrcSize, bpfUInt32 aFilterMask, const cRegion& aRegion, bpfThreadPool* aThreadPool = nullptr) const;
+
+  /**
+   * The unshuffle uses AVX2 on cpus that have it, unless disabled here; then it uses SSE2.
+   * Lets tests check the SSE2 path on any x86-64 cpu.
+   */
+  static void SetAVX2Enabled(bool aIsEnabled);
+
+private:
+  struct cFilter
+  {
+    H5Z_filter_t mId;
+    std::vector<bpfUInt32> mValues;
+  };
+
+  bpfSize GetLastFilter(bpfUInt32 aFilterMask) const;
+  const bpfUInt8* Run(const bpfUInt8* aSrc, bpfSize& aSrcSize, bpfUInt32 aFilterMask, bpfSize aFirstFilter, bpfSize aDestSize, bpfThreadPool* aThreadPool) const;
+  bpfSize Apply(const cFilter& aFilter, const bpfUInt8* aSrc, bpfSize aSrcSize, bpfUInt8* aDest, bpfSize aDestSize, bpfThreadPool* aThreadPool) const;
+
+  std::vector<cFilter> mFilters;
+  std::vector<bpfUInt8> mFillValue;
+  bpfSize mTypeSize;
+  bool mIsSupported;
+};
+
+
+#endif // __BPF_H5_CHUNK_DECODER__
@@ -16,28 +16,244 @@
 
 
 #include "ImarisReader/utils/bpfH5LZ4.h"
+#include "ImarisReader/utils/bpfThreadPool.h"
 
-#include <H5PLextern.h>
+#include <lz4.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 
 const H5Z_filter_t H5Z_FILTER_LZ4 = 32004;
 
+// lz4 needs blocks < 1.9GB
+static const unsigned int mDefaultBlockSize = 1 << 30;
+
+// chunks smaller than this are decoded on the calling thread
+static const size_t mMinParallelSize = 1 << 20;
 
-extern "C" {
+// thread pool of the innermost bpfH5LZ4ThreadPoolScope on this thread
+static thread_local bpfThreadPool* mThreadPool = nullptr;
 
-  const void *H5PLget_plugin_info_lz4(void);
 
+namespace
+{
+  struct cBlock
+  {
+    const unsigned char* mSrc;
+    size_t mSrcSize;
+    char* mDest;
+    size_t mDestSize;
+  };
 }
 
 
-static htri_t H5Zregister_lz4_impl()
+bpfH5LZ4ThreadPoolScope::bpfH5LZ4ThreadPoolScope(bpfThreadPool* aThreadPool)
+  : mPrevious(mThreadPool)
+{
+  mThreadPool = aThreadPool;
+}
+
+
+bpfH5LZ4ThreadPoolScope::~bpfH5LZ4ThreadPoolScope()
+{
+  mThreadPool = mPrevious;
+}
+
+
+static uint64_t ReadBigEndian(const unsigned char* aData, size_t aSize)
+{
+  uint64_t vValue = 0;
+  for (size_t vIndex = 0; vIndex < aSize; ++vIndex) {
+    vValue = (vValue << 8) | aData[vIndex];
+  }
+  return vValue;
+}
+
+
+static void WriteBigEndian(uint64_t aValue, unsigned char* aData, size_t aSize)
+{
+  for (size_t vIndex = aSize; vIndex-- > 0; ) {
+    aData[vIndex] = static_cast<unsigned char>(aValue & 0xff);
+    aValue >>= 8;
+  }
+}
+
+
+/**
+ * Reads the chunk header and the size prefixes of all blocks. Returns the original size, 0 on error.
+ */
+static size_t GetBlocks(const void* aSrc, size_t aSrcSize, void* aDest, size_t aDestSize, std::vector<cBlock>& aBlocks)
+{
+  const unsigned char* vSrc = static_cast<const unsigned char*>(aSrc);
+  const unsigned char* vSrcEnd = vSrc + aSrcSize;
+  if (aSrcSize < 12) {
+    return 0;
+  }
+
+  uint64_t vOrigSize = ReadBigEndian(vSrc, 8);
+  uint64_t vBlockSize = ReadBigEndian(vSrc + 8, 4);
+  vSrc += 12;
+  if (vOrigSize > aDestSize || vBlockSize == 0) {
+    return 0;
+  }
+  if (vBlockSize > vOrigSize) {
+    vBlockSize = vOrigSize;
+  }
+
+  char* vDest = static_cast<char*>(aDest);
+  uint64_t vDecompSize = 0;
+  while (vDecompSize < vOrigSize) {
+    uint64_t vSize = std::min<uint64_t>(vBlockSize, vOrigSize - vDecompSize);
+    if (vSrcEnd - vSrc < 4) {
+      return 0;
+    }
+    uint64_t vCompressedSize = ReadBigEndian(vSrc, 4);
+    vSrc += 4;
+    if (static_cast<uint64_t>(vSrcEnd - vSrc) < vCompressedSize) {
+      return 0;
+    }
+    aBlocks.push_back({ vSrc, static_cast<size_t>(vCompressedSize), vDest, static_cast<size_t>(vSize) });
+    vSrc += vCompressedSize;
+    vDest += vSize;
+    vDecompSize += vSize;
+  }
+  return static_cast<size_t>(vOrigSize);
+}
+
+
+static bool DecodeBlock(const cBlock& aBlock)
+{
+  if (aBlock.mSrcSize == aBlock.mDestSize) {
+    // block was stored uncompressed
+    std::memcpy(aBlock.mDest, aBlock.mSrc, aBlock.mDestSize);
+    return true;
+  }
+  return LZ4_decompress_safe(reinterpret_cast<const char*>(aBlock.mSrc), aBlock.mDest, static_cast<int>(aBlock.mSrcSize), static_cast<int>(aBlock.mDestSize)) == static_cast<int>(aBlock.mDestSize);
+}
+
+
+static size_t Decode(const void* aSrc, size_t aSrcSize, void* aDest, size_t aDestSize, bpfThreadPool* aThreadPool)
+{
+  std::vector<cBlock> vBlocks;
+  size_t vOrigSize = GetBlocks(aSrc, aSrcSize, aDest, aDestSize, vBlocks);
+  if (vOrigSize == 0) {
+    return 0;
+  }
+
+  if (!aThreadPool || vBlocks.size() < 2 || vOrigSize < mMinParallelSize) {
+    for (const cBlock& vBlock : vBlocks) {
+      if (!DecodeBlock(vBlock)) {
+        return 0;
+      }
+    }
+    return vOrigSize;
+  }
+
+  // blocks are compressed independently
+  std::vector<char> vSucceeded(vBlocks.size(), 0);
+  aThreadPool->ParallelFor(vBlocks.size(), [&vBlocks, &vSucceeded](bpfSize aIndex) {
+    vSucceeded[aIndex] = DecodeBlock(vBlocks[aIndex]) ? 1 : 0;
+  });
+  if (std::find(vSucceeded.begin(), vSucceeded.end(), 0) != vSucceeded.end()) {
+    return 0;
+  }
+  return vOrigSize;
+}
+
+
+static size_t Encode(unsigned int aBlockSize, const void* aSrc, size_t aSrcSize, void* aDest)
+{
+  size_t vBlockSize = std::min<size_t>(aBlockSize, aSrcSize);
+  size_t vNumberOfBlocks = (aSrcSize - 1) / vBlockSize + 1;
+
+  unsigned char* vDest = static_cast<unsigned char*>(aDest);
+  WriteBigEndian(aSrcSize, vDest, 8);
+  WriteBigEndian(vBlockSize, vDest + 8, 4);
+  vDest += 12;
+
+  const char* vSrc = static_cast<const char*>(aSrc);
+  for (size_t vBlock = 0; vBlock < vNumberOfBlocks; ++vBlock) {
+    size_t vSize = std::min(vBlockSize, aSrcSize - vBlock * vBlockSize);
+    int vCompressedSize = LZ4_compress_default(vSrc, reinterpret_cast<char*>(vDest + 4), static_cast<int>(vSize), LZ4_compressBound(static_cast<int>(vSize)));
+    if (vCompressedSize <= 0) {
+      return 0;
+    }
+    if (static_cast<size_t>(vCompressedSize) >= vSize) {
+      // compression did not save any space
+      vCompressedSize = static_cast<int>(vSize);
+      std::memcpy(vDest + 4, vSrc, vSize);
+    }
+    WriteBigEndian(static_cast<uint64_t>(vCompressedSize), vDest, 4);
+    vSrc += vSize;
+    vDest += 4 + vCompressedSize;
+  }
+  return vDest - static_cast<unsigned char*>(aDest);
+}
+
+
+static size_t H5Z_filter_lz4(unsigned int aFlags, size_t aNumberOfValues, const unsigned int aValues[], size_t aNumberOfBytes, size_t* aBufferSize, void** aBuffer)
 {
-  if (H5Zfilter_avail(H5Z_FILTER_LZ4) > 0) {
-    // already dynamically loaded?
-    // https://support.hdfgroup.org/HDF5/doc/Advanced/DynamicallyLoadedFilters/HDF5DynamicallyLoadedFilters.pdf
-    return 1;
+  void* vOutput = nullptr;
+  size_t vOutputSize = 0;
+  size_t vResult = 0;
+
+  if (aFlags & H5Z_FLAG_REVERSE) {
+    if (aNumberOfBytes < 12) {
+      return 0;
+    }
+    vOutputSize = static_cast<size_t>(ReadBigEndian(static_cast<const unsigned char*>(*aBuffer), 8));
+    vOutput = malloc(std::max<size_t>(vOutputSize, 1));
+    if (vOutput) {
+      vResult = Decode(*aBuffer, aNumberOfBytes, vOutput, vOutputSize, mThreadPool);
+    }
   }
-  if (H5Zregister(H5PLget_plugin_info_lz4()) < 0) {
+  else {
+    if (aNumberOfBytes == 0 || aNumberOfBytes > INT32_MAX) {
+      // can only compress chunks up to 2GB
+      return 0;
+    }
+    unsigned int vBlockSize = aNumberOfValues > 0 && aValues[0] > 0 ? aValues[0] : mDefaultBlockSize;
+    size_t vNumberOfBlocks = (aNumberOfBytes - 1) / std::min<size_t>(vBlockSize, aNumberOfBytes) + 1;
+    vOutputSize = 12 + vNumberOfBlocks * 4 + LZ4_compressBound(static_cast<int>(aNumberOfBytes)) + vNumberOfBlocks * 16;
+    vOutput = malloc(vOutputSize);
+    if (vOutput) {
+      vResult = Encode(vBlockSize, *aBuffer, aNumberOfBytes, vOutput);
+    }
+  }
+
+  if (vResult == 0) {
+    free(vOutput);
+    return 0;
+  }
+
+  // hdf5 hands the ownership of its buffer to the filter
+  free(*aBuffer);
+  *aBuffer = vOutput;
+  *aBufferSize = vOutputSize;
+  return vResult;
+}
+
+
+static const H5Z_class2_t H5Z_LZ4 = {
+  H5Z_CLASS_T_VERS,
+  H5Z_FILTER_LZ4,
+  1, // encoder present
+  1, // decoder present
+  "HDF5 lz4 filter; see http://www.hdfgroup.org/services/contributions.html",
+  nullptr, // can apply
+  nullptr, // set local
+  static_cast<H5Z_func_t>(H5Z_filter_lz4)
+};
+
+
+static htri_t H5Zregister_lz4_impl()
+{
+  // replaces a dynamically loaded lz4 plugin, the chunk format is the same
+  if (H5Zregister(&H5Z_LZ4) < 0) {
     return -1;
   }
   return H5Zfilter_avail(H5Z_FILTER_LZ4);
@@ -59,3 +275,8 @@ herr_t H5Pset_lz4(hid_t aPListId, unsigned int aBlockSize)
   return H5Pset_filter(aPListId, H5Z_FILTER_LZ4, H5Z_FLAG_MANDATORY, 1, &aBlockSize);
 }
 
+
+size_t bpfH5LZ4Decode(const void* aSrc, size_t aSrcSize, void* aDest, size_t aDestSize, bpfThreadPool* aThreadPool)
+{
+  return Decode(aSrc, aSrcSize, aDest, aDestSize, aThreadPool);
+}
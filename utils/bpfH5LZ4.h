@@ -22,11 +22,42 @@
 #include <hdf5.h>
 
 
+class bpfThreadPool;
+
 extern const H5Z_filter_t H5Z_FILTER_LZ4;
 
+/**
+ * While it exists, the lz4 filter decodes the chunks that hdf5 reads on the creating thread
+ * on aThreadPool. Without a scope (or with a null pool) the filter decodes on the calling thread.
+ */
+class bpfH5LZ4ThreadPoolScope
+{
+public:
+  explicit bpfH5LZ4ThreadPoolScope(bpfThreadPool* aThreadPool);
+  ~bpfH5LZ4ThreadPoolScope();
+
+  bpfH5LZ4ThreadPoolScope(const bpfH5LZ4ThreadPoolScope&) = delete;
+  bpfH5LZ4ThreadPoolScope& operator=(const bpfH5LZ4ThreadPoolScope&) = delete;
+
+private:
+  bpfThreadPool* mPrevious;
+};
+
+/**
+ * Registers the in-tree lz4 filter. Chunks of at least 1MB that consist of several blocks
+ * are decoded in parallel on the pool of the current bpfH5LZ4ThreadPoolScope, if any.
+ */
 htri_t H5Zregister_lz4();
 
 herr_t H5Pset_lz4(hid_t aPListId, unsigned int aBlockSize = (1<<30));
 
+/**
+ * Decodes a chunk written by the lz4 filter (big endian 8 byte original size, 4 byte block size,
+ * followed by the compressed blocks, each prefixed with its 4 byte compressed size).
+ * Chunks of at least 1MB that consist of several blocks are decoded in parallel on aThreadPool,
+ * if not null. Returns the number of bytes written to aDest, 0 on error.
+ */
+size_t bpfH5LZ4Decode(const void* aSrc, size_t aSrcSize, void* aDest, size_t aDestSize, bpfThreadPool* aThreadPool);
+
 
 #endif
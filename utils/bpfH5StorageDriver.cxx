@@ -0,0 +1,296 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#include "ImarisReader/utils/bpfH5StorageDriver.h"
+
+#if H5_VERSION_GE(1, 14, 0)
+#include <H5FDdevelop.h>
+#endif
+
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <vector>
+
+
+namespace
+{
+  // the driver info of a file access property list
+  struct cStorageFapl
+  {
+    bpfSharedPtr<bpStorageInterface> mStorage;
+    bpfSize mReadAheadBytes;
+  };
+
+
+  class cStorageFileState
+  {
+  public:
+    explicit cStorageFileState(const cStorageFapl& aFapl)
+      : mEoa(0),
+        mEof(aFapl.mStorage->GetSize()),
+        mFapl(aFapl)
+    {
+    }
+
+    haddr_t mEoa;
+    haddr_t mEof;
+
+    const cStorageFapl& GetFapl() const
+    {
+      return mFapl;
+    }
+
+    bool Read(H5FD_mem_t aType, haddr_t aAddress, size_t aSize, void* aBuffer)
+    {
+      bpfUInt8* vBuffer = static_cast<bpfUInt8*>(aBuffer);
+      if (aAddress >= mEof) {
+        // hdf5 expects zeros past the end of the file
+        std::memset(vBuffer, 0, aSize);
+        return true;
+      }
+      if (aAddress + aSize > mEof) {
+        size_t vSize = static_cast<size_t>(mEof - aAddress);
+        std::memset(vBuffer + vSize, 0, aSize - vSize);
+        aSize = vSize;
+      }
+
+      bpfSize vBlockSize = mFapl.mReadAheadBytes;
+      if (aType == H5FD_MEM_DRAW || vBlockSize == 0 || aSize >= vBlockSize) {
+        return mFapl.mStorage->Read(aAddress, aSize, vBuffer);
+      }
+
+      std::lock_guard<std::mutex> vLock(mMutex);
+      while (aSize > 0) {
+        haddr_t vBlockAddress = aAddress - aAddress % vBlockSize;
+        const std::vector<bpfUInt8>* vBlock = GetBlock(vBlockAddress);
+        if (!vBlock) {
+          return false;
+        }
+        size_t vOffset = static_cast<size_t>(aAddress - vBlockAddress);
+        size_t vSize = std::min(aSize, vBlock->size() - vOffset);
+        std::memcpy(vBuffer, vBlock->data() + vOffset, vSize);
+        vBuffer += vSize;
+        aAddress += vSize;
+        aSize -= vSize;
+      }
+      return true;
+    }
+
+  private:
+    // blocks kept per file when reading ahead
+    static const bpfSize mMaxNumberOfBlocks = 64;
+
+    using tBlock = std::pair<haddr_t, std::vector<bpfUInt8>>;
+    using tBlocks = std::list<tBlock>;
+
+    // the cached block at aAddress, read if it is not cached yet
+    const std::vector<bpfUInt8>* GetBlock(haddr_t aAddress)
+    {
+      auto vIndexIt = mBlockIndex.find(aAddress);
+      if (vIndexIt != mBlockIndex.end()) {
+        mBlocks.splice(mBlocks.begin(), mBlocks, vIndexIt->second);
+        return &vIndexIt->second->second;
+      }
+
+      std::vector<bpfUInt8> vData(static_cast<size_t>(std::min<haddr_t>(mFapl.mReadAheadBytes, mEof - aAddress)));
+      if (!mFapl.mStorage->Read(aAddress, vData.size(), vData.data())) {
+        return nullptr;
+      }
+
+      if (mBlocks.size() >= mMaxNumberOfBlocks) {
+        mBlockIndex.erase(mBlocks.back().first);
+        mBlocks.pop_back();
+      }
+      mBlocks.emplace_front(aAddress, std::move(vData));
+      mBlockIndex[aAddress] = mBlocks.begin();
+      return &mBlocks.front().second;
+    }
+
+    cStorageFapl mFapl;
+
+    std::mutex mMutex;
+    // most recently used first
+    tBlocks mBlocks;
+    std::map<haddr_t, tBlocks::iterator> mBlockIndex;
+  };
+
+
+  // the public part must come first, hdf5 only knows H5FD_t
+  struct cStorageFile
+  {
+    H5FD_t mPublic;
+    cStorageFileState* mState;
+  };
+
+
+  cStorageFileState& GetState(const H5FD_t* aFile)
+  {
+    return *reinterpret_cast<const cStorageFile*>(aFile)->mState;
+  }
+
+
+  void* FaplCopy(const void* aFapl)
+  {
+    return new cStorageFapl(*static_cast<const cStorageFapl*>(aFapl));
+  }
+
+
+  herr_t FaplFree(void* aFapl)
+  {
+    delete static_cast<cStorageFapl*>(aFapl);
+    return 0;
+  }
+
+
+  void* FaplGet(H5FD_t* aFile)
+  {
+    return FaplCopy(&GetState(aFile).GetFapl());
+  }
+
+
+  H5FD_t* Open(const char* /*aName*/, unsigned aFlags, hid_t aFapl, haddr_t aMaxAddress)
+  {
+    if ((aFlags & (H5F_ACC_RDWR | H5F_ACC_CREAT | H5F_ACC_TRUNC)) != 0 || aMaxAddress == 0 || aMaxAddress == HADDR_UNDEF) {
+      return nullptr;
+    }
+    const cStorageFapl* vFapl = static_cast<const cStorageFapl*>(H5Pget_driver_info(aFapl));
+    if (!vFapl || !vFapl->mStorage) {
+      return nullptr;
+    }
+
+    cStorageFile* vFile = new cStorageFile();
+    vFile->mState = new cStorageFileState(*vFapl);
+    return &vFile->mPublic;
+  }
+
+
+  herr_t Close(H5FD_t* aFile)
+  {
+    cStorageFile* vFile = reinterpret_cast<cStorageFile*>(aFile);
+    delete vFile->mState;
+    delete vFile;
+    return 0;
+  }
+
+
+  int Compare(const H5FD_t* aFile1, const H5FD_t* aFile2)
+  {
+    const bpStorageInterface* vStorage1 = GetState(aFile1).GetFapl().mStorage.get();
+    const bpStorageInterface* vStorage2 = GetState(aFile2).GetFapl().mStorage.get();
+    return std::less<const bpStorageInterface*>()(vStorage1, vStorage2) ? -1 : (vStorage1 == vStorage2 ? 0 : 1);
+  }
+
+
+  herr_t Query(const H5FD_t* /*aFile*/, unsigned long* aFlags)
+  {
+    if (aFlags) {
+      // as the sec2 driver, hdf5 batches small metadata and raw data accesses
+      *aFlags = H5FD_FEAT_AGGREGATE_METADATA | H5FD_FEAT_ACCUMULATE_METADATA | H5FD_FEAT_DATA_SIEVE | H5FD_FEAT_AGGREGATE_SMALLDATA;
+    }
+    return 0;
+  }
+
+
+  haddr_t GetEoa(const H5FD_t* aFile, H5FD_mem_t /*aType*/)
+  {
+    return GetState(aFile).mEoa;
+  }
+
+
+  herr_t SetEoa(H5FD_t* aFile, H5FD_mem_t /*aType*/, haddr_t aAddress)
+  {
+    GetState(aFile).mEoa = aAddress;
+    return 0;
+  }
+
+
+  haddr_t GetEof(const H5FD_t* aFile, H5FD_mem_t /*aType*/)
+  {
+    return GetState(aFile).mEof;
+  }
+
+
+  herr_t Read(H5FD_t* aFile, H5FD_mem_t aType, hid_t /*aDxpl*/, haddr_t aAddress, size_t aSize, void* aBuffer)
+  {
+    cStorageFileState& vState = GetState(aFile);
+    if (aAddress == HADDR_UNDEF || aAddress + aSize > vState.mEoa) {
+      return -1;
+    }
+    return vState.Read(aType, aAddress, aSize, aBuffer) ? 0 : -1;
+  }
+
+
+  herr_t Write(H5FD_t* /*aFile*/, H5FD_mem_t /*aType*/, hid_t /*aDxpl*/, haddr_t /*aAddress*/, size_t /*aSize*/, const void* /*aBuffer*/)
+  {
+    // read only
+    return -1;
+  }
+
+
+  hid_t Register()
+  {
+    H5FD_class_t vClass;
+    std::memset(&vClass, 0, sizeof(vClass));
+#if H5_VERSION_GE(1, 14, 0)
+    vClass.version = H5FD_CLASS_VERSION;
+    // from the range hdf5 leaves to drivers that are not registered with the hdf group
+    vClass.value = 512 + 0x49;
+#endif
+    vClass.name = "bpfStorage";
+    vClass.maxaddr = static_cast<haddr_t>(std::numeric_limits<bpfInt64>::max());
+    vClass.fc_degree = H5F_CLOSE_WEAK;
+    vClass.fapl_size = sizeof(cStorageFapl);
+    vClass.fapl_get = FaplGet;
+    vClass.fapl_copy = FaplCopy;
+    vClass.fapl_free = FaplFree;
+    vClass.open = Open;
+    vClass.close = Close;
+    vClass.cmp = Compare;
+    vClass.query = Query;
+    vClass.get_eoa = GetEoa;
+    vClass.set_eoa = SetEoa;
+    vClass.get_eof = GetEof;
+    vClass.read = Read;
+    vClass.write = Write;
+    const H5FD_mem_t vFreeListMap[H5FD_MEM_NTYPES] = H5FD_FLMAP_DICHOTOMY;
+    std::memcpy(vClass.fl_map, vFreeListMap, sizeof(vFreeListMap));
+    return H5FDregister(&vClass);
+  }
+}
+
+
+hid_t H5FD_storage_init()
+{
+  static hid_t vDriverId = Register();
+  return vDriverId;
+}
+
+
+herr_t H5Pset_fapl_storage(hid_t aPListId, bpfSharedPtr<bpStorageInterface> aStorage, bpfSize aReadAheadBytes)
+{
+  hid_t vDriverId = H5FD_storage_init();
+  if (vDriverId < 0 || !aStorage) {
+    return -1;
+  }
+  cStorageFapl vFapl{ std::move(aStorage), aReadAheadBytes };
+  return H5Pset_driver(aPListId, vDriverId, &vFapl);
+}
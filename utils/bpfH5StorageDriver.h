@@ -0,0 +1,44 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BPF_H5_STORAGE_DRIVER__
+#define __BPF_H5_STORAGE_DRIVER__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+#include "ImarisReader/interface/bpStorageInterface.h"
+
+#include <hdf5.h>
+
+
+/**
+ * Returns the id of the read only hdf5 file driver that reads through a
+ * bpStorageInterface, registering it on first use.
+ */
+hid_t H5FD_storage_init();
+
+/**
+ * Makes files opened with the file access property list aPListId read through aStorage,
+ * the file name passed to H5Fopen is ignored. Metadata reads smaller than aReadAheadBytes
+ * are widened to aligned blocks of that size, which are kept for later metadata reads;
+ * 0 passes every read through.
+ */
+herr_t H5Pset_fapl_storage(hid_t aPListId, bpfSharedPtr<bpStorageInterface> aStorage, bpfSize aReadAheadBytes);
+
+
+#endif // __BPF_H5_STORAGE_DRIVER__
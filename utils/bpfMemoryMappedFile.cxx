@@ -0,0 +1,127 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#if defined(_WIN32)
+  #define NOMINMAX
+#endif
+
+#include "ImarisReader/utils/bpfMemoryMappedFile.h"
+#include "ImarisReader/utils/bpfFileTools.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+
+#if defined(_WIN32)
+
+bpfMemoryMappedFile::bpfMemoryMappedFile(const bpfString& aFileName)
+  : mData(nullptr),
+    mSize(0),
+    mFile(INVALID_HANDLE_VALUE),
+    mMapping(nullptr)
+{
+  mFile = CreateFileW(bpfFileTools::FromUtf8Path(aFileName).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (mFile == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  LARGE_INTEGER vSize;
+  if (!GetFileSizeEx(mFile, &vSize) || vSize.QuadPart == 0) {
+    return;
+  }
+  mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mMapping) {
+    return;
+  }
+  mData = static_cast<const bpfUInt8*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+  if (mData) {
+    mSize = static_cast<bpfSize>(vSize.QuadPart);
+  }
+}
+
+
+bpfMemoryMappedFile::~bpfMemoryMappedFile()
+{
+  if (mData) {
+    UnmapViewOfFile(mData);
+  }
+  if (mMapping) {
+    CloseHandle(mMapping);
+  }
+  if (mFile != INVALID_HANDLE_VALUE) {
+    CloseHandle(mFile);
+  }
+}
+
+#else
+
+bpfMemoryMappedFile::bpfMemoryMappedFile(const bpfString& aFileName)
+  : mData(nullptr),
+    mSize(0)
+{
+  int vFile = open(aFileName.c_str(), O_RDONLY);
+  if (vFile < 0) {
+    return;
+  }
+  struct stat vStat;
+  if (fstat(vFile, &vStat) == 0 && vStat.st_size > 0) {
+    void* vData = mmap(nullptr, static_cast<size_t>(vStat.st_size), PROT_READ, MAP_SHARED, vFile, 0);
+    if (vData != MAP_FAILED) {
+      mData = static_cast<const bpfUInt8*>(vData);
+      mSize = static_cast<bpfSize>(vStat.st_size);
+    }
+  }
+  // the mapping keeps its own reference to the file
+  close(vFile);
+}
+
+
+bpfMemoryMappedFile::~bpfMemoryMappedFile()
+{
+  if (mData) {
+    munmap(const_cast<bpfUInt8*>(mData), mSize);
+  }
+}
+
+#endif // _WIN32
+
+
+bool bpfMemoryMappedFile::IsMapped() const
+{
+  return mData != nullptr;
+}
+
+
+const bpfUInt8* bpfMemoryMappedFile::GetData(bpfUInt64 aOffset, bpfSize aSize) const
+{
+  if (!mData || aOffset > mSize || aSize > mSize - aOffset) {
+    return nullptr;
+  }
+  return mData + aOffset;
+}
+
+
+bpfSize bpfMemoryMappedFile::GetSize() const
+{
+  return mSize;
+}
@@ -0,0 +1,58 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BPF_MEMORY_MAPPED_FILE__
+#define __BPF_MEMORY_MAPPED_FILE__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+
+
+/**
+ * Read-only mapping of a whole file into the address space. The mapped bytes
+ * stay valid until the object is destroyed.
+ */
+class bpfMemoryMappedFile
+{
+public:
+  explicit bpfMemoryMappedFile(const bpfString& aFileName);
+  ~bpfMemoryMappedFile();
+
+  bpfMemoryMappedFile(const bpfMemoryMappedFile&) = delete;
+  bpfMemoryMappedFile& operator=(const bpfMemoryMappedFile&) = delete;
+
+  bool IsMapped() const;
+
+  /**
+   * Returns the aSize bytes at aOffset, or nullptr if they are not inside the mapping.
+   */
+  const bpfUInt8* GetData(bpfUInt64 aOffset, bpfSize aSize) const;
+
+  bpfSize GetSize() const;
+
+private:
+  const bpfUInt8* mData;
+  bpfSize mSize;
+#if defined(_WIN32)
+  void* mFile;
+  void* mMapping;
+#endif
+};
+
+
+#endif // __BPF_MEMORY_MAPPED_FILE__
@@ -0,0 +1,264 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#include "ImarisReader/utils/bpfRGBACompositor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BPF_COMPOSITE_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BPF_TARGET_AVX2
+#else
+#define BPF_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define BPF_COMPOSITE_SIMD 0
+#endif
+
+
+const bpfSize bpfRGBAChannelTable::mBinnedTableSize;
+
+
+template<typename TDataType>
+static bool IsBinned()
+{
+  return !std::is_same<TDataType, bpfUInt8>::value && !std::is_same<TDataType, bpfUInt16>::value;
+}
+
+
+// table index of one voxel, values outside of the table of a binned channel are clamped
+template<typename TDataType>
+static bpfSize GetTableIndex(TDataType aValue, bpfFloat aScale, bpfFloat aOffset)
+{
+  if (!IsBinned<TDataType>()) {
+    return static_cast<bpfSize>(aValue);
+  }
+  bpfFloat vBin = static_cast<bpfFloat>(aValue) * aScale + aOffset;
+  vBin = vBin > 0.0f ? vBin : 0.0f;
+  const bpfFloat vMaxBin = static_cast<bpfFloat>(bpfRGBAChannelTable::mBinnedTableSize - 1);
+  vBin = vBin < vMaxBin ? vBin : vMaxBin;
+  return static_cast<bpfSize>(std::nearbyint(vBin));
+}
+
+
+#if BPF_COMPOSITE_SIMD
+
+static bool HasAVX2()
+{
+#if defined(_MSC_VER)
+  static const bool vHasAVX2 = [] {
+    int vInfo[4];
+    __cpuidex(vInfo, 7, 0);
+    return (vInfo[1] & (1 << 5)) != 0;
+  }();
+  return vHasAVX2;
+#else
+  static const bool vHasAVX2 = __builtin_cpu_supports("avx2");
+  return vHasAVX2;
+#endif
+}
+
+
+template<typename TDataType>
+BPF_TARGET_AVX2
+static __m256i GetTableIndices8(const TDataType* aData, bpfFloat aScale, bpfFloat aOffset);
+
+template<>
+BPF_TARGET_AVX2
+__m256i GetTableIndices8<bpfUInt8>(const bpfUInt8* aData, bpfFloat, bpfFloat)
+{
+  return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(aData)));
+}
+
+template<>
+BPF_TARGET_AVX2
+__m256i GetTableIndices8<bpfUInt16>(const bpfUInt16* aData, bpfFloat, bpfFloat)
+{
+  return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(aData)));
+}
+
+BPF_TARGET_AVX2
+static __m256i GetBins8(__m256 aValues, bpfFloat aScale, bpfFloat aOffset)
+{
+  __m256 vBins = _mm256_add_ps(_mm256_mul_ps(aValues, _mm256_set1_ps(aScale)), _mm256_set1_ps(aOffset));
+  vBins = _mm256_min_ps(_mm256_max_ps(vBins, _mm256_setzero_ps()), _mm256_set1_ps(static_cast<bpfFloat>(bpfRGBAChannelTable::mBinnedTableSize - 1)));
+  return _mm256_cvtps_epi32(vBins);
+}
+
+template<>
+BPF_TARGET_AVX2
+__m256i GetTableIndices8<bpfUInt32>(const bpfUInt32* aData, bpfFloat aScale, bpfFloat aOffset)
+{
+  // both halves convert exactly, so the sum is rounded once like a scalar conversion
+  __m256i vValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(aData));
+  __m256 vHigh = _mm256_cvtepi32_ps(_mm256_srli_epi32(vValues, 16));
+  __m256 vLow = _mm256_cvtepi32_ps(_mm256_and_si256(vValues, _mm256_set1_epi32(0xffff)));
+  return GetBins8(_mm256_add_ps(_mm256_mul_ps(vHigh, _mm256_set1_ps(65536.0f)), vLow), aScale, aOffset);
+}
+
+template<>
+BPF_TARGET_AVX2
+__m256i GetTableIndices8<bpfFloat>(const bpfFloat* aData, bpfFloat aScale, bpfFloat aOffset)
+{
+  return GetBins8(_mm256_loadu_ps(aData), aScale, aOffset);
+}
+
+
+// eight voxels at a time, the colors of all channels are gathered from their tables and added with saturation
+template<typename TDataType>
+BPF_TARGET_AVX2
+static bpfSize CompositeAVX2(const TDataType* const* aData, bpfSize aNumberOfVoxels, const bpfRGBAChannelTable* const* aChannels, bpfSize aNumberOfChannels, bpfPackedRGBA* aRGBA)
+{
+  bpfSize vIndex = 0;
+  for (; vIndex + 8 <= aNumberOfVoxels; vIndex += 8) {
+    __m256i vSum = _mm256_setzero_si256();
+    for (bpfSize vChannel = 0; vChannel < aNumberOfChannels; ++vChannel) {
+      const bpfRGBAChannelTable& vTable = *aChannels[vChannel];
+      __m256i vIndices = GetTableIndices8<TDataType>(aData[vChannel] + vIndex, vTable.mScale, vTable.mOffset);
+      __m256i vColors = _mm256_i32gather_epi32(reinterpret_cast<const int*>(vTable.mTable.data()), vIndices, 4);
+      vSum = _mm256_adds_epu8(vSum, vColors);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(aRGBA + vIndex), vSum);
+  }
+  return vIndex;
+}
+
+
+// four voxels at a time, the table lookups are scalar
+template<typename TDataType>
+static bpfSize CompositeSSE2(const TDataType* const* aData, bpfSize aNumberOfVoxels, const bpfRGBAChannelTable* const* aChannels, bpfSize aNumberOfChannels, bpfPackedRGBA* aRGBA)
+{
+  bpfSize vIndex = 0;
+  for (; vIndex + 4 <= aNumberOfVoxels; vIndex += 4) {
+    __m128i vSum = _mm_setzero_si128();
+    for (bpfSize vChannel = 0; vChannel < aNumberOfChannels; ++vChannel) {
+      const bpfRGBAChannelTable& vTable = *aChannels[vChannel];
+      const TDataType* vData = aData[vChannel] + vIndex;
+      alignas(16) bpfPackedRGBA vColors[4];
+      for (bpfSize vLane = 0; vLane < 4; ++vLane) {
+        vColors[vLane] = vTable.mTable[GetTableIndex(vData[vLane], vTable.mScale, vTable.mOffset)];
+      }
+      vSum = _mm_adds_epu8(vSum, _mm_load_si128(reinterpret_cast<const __m128i*>(vColors)));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(aRGBA + vIndex), vSum);
+  }
+  return vIndex;
+}
+
+#endif
+
+
+template<typename TDataType>
+bpfRGBACompositor<TDataType>::bpfRGBACompositor(const bpConverterTypes::tColorInfoVector& aColorInfoPerChannel)
+  : mChannels(aColorInfoPerChannel.size())
+{
+  for (bpfSize vIndex = 0; vIndex < aColorInfoPerChannel.size(); ++vIndex) {
+    SetColorInfo(vIndex, aColorInfoPerChannel[vIndex]);
+  }
+}
+
+
+template<typename TDataType>
+bpfSharedPtr<const bpfRGBAChannelTable> bpfRGBACompositor<TDataType>::MakeChannelTable(const bpConverterTypes::cColorInfo& aColorInfo)
+{
+  auto vChannel = bpfMakeSharedPtr<bpfRGBAChannelTable>();
+
+  bool vIsBinned = IsBinned<TDataType>();
+  bpfSize vTableSize = vIsBinned ? bpfRGBAChannelTable::mBinnedTableSize : static_cast<bpfSize>(std::numeric_limits<TDataType>::max()) + 1;
+  // an empty range becomes a step at mRangeMin
+  bpfFloat vRange = std::max(aColorInfo.mRangeMax - aColorInfo.mRangeMin, std::numeric_limits<bpfFloat>::epsilon() * std::max(std::abs(aColorInfo.mRangeMin), 1.0f));
+  if (vIsBinned) {
+    vChannel->mScale = (vTableSize - 1) / vRange;
+    vChannel->mOffset = -aColorInfo.mRangeMin * vChannel->mScale;
+  }
+
+  vChannel->mTable.assign(vTableSize, bpfPackedRGBA(0, 0, 0, 0));
+  if (!aColorInfo.mIsBaseColorMode && aColorInfo.mColorTable.empty()) {
+    return vChannel;
+  }
+  bpfFloat vOpacity = aColorInfo.mOpacity;
+  for (bpfSize vIndex = 0; vIndex < vTableSize; ++vIndex) {
+    bpfFloat vValue = vIsBinned ? aColorInfo.mRangeMin + vRange * vIndex / (vTableSize - 1) : static_cast<bpfFloat>(vIndex);
+    bpConverterTypes::cColor vColor = aColorInfo.GetColor(vValue);
+    bpfColor vRGB(std::min(std::max(vColor.mRed * vOpacity, 0.0f), 1.0f),
+                  std::min(std::max(vColor.mGreen * vOpacity, 0.0f), 1.0f),
+                  std::min(std::max(vColor.mBlue * vOpacity, 0.0f), 1.0f));
+    bpfPackedRGBA& vEntry = vChannel->mTable[vIndex];
+    vEntry = vRGB;
+    vEntry.a = static_cast<bpfUInt8>(std::min(std::max(vColor.mAlpha * vOpacity, 0.0f), 1.0f) * 255);
+  }
+  return vChannel;
+}
+
+
+template<typename TDataType>
+void bpfRGBACompositor<TDataType>::SetColorInfo(bpfSize aChannelIndex, const bpConverterTypes::cColorInfo& aColorInfo)
+{
+  SetChannelTable(aChannelIndex, MakeChannelTable(aColorInfo));
+}
+
+
+template<typename TDataType>
+void bpfRGBACompositor<TDataType>::SetChannelTable(bpfSize aChannelIndex, bpfSharedPtr<const bpfRGBAChannelTable> aTable)
+{
+  if (aChannelIndex >= mChannels.size()) {
+    mChannels.resize(aChannelIndex + 1);
+  }
+  mChannels[aChannelIndex] = std::move(aTable);
+}
+
+
+template<typename TDataType>
+void bpfRGBACompositor<TDataType>::Composite(const TDataType* aData, bpfSize aNumberOfVoxels, bpfSize aFirstChannelIndex, bpfSize aNumberOfChannels, bpfPackedRGBA* aRGBA) const
+{
+  // channels without a table do not contribute
+  std::vector<const bpfRGBAChannelTable*> vChannels;
+  std::vector<const TDataType*> vData;
+  for (bpfSize vChannel = 0; vChannel < aNumberOfChannels; ++vChannel) {
+    if (aFirstChannelIndex + vChannel < mChannels.size() && mChannels[aFirstChannelIndex + vChannel]) {
+      vChannels.push_back(mChannels[aFirstChannelIndex + vChannel].get());
+      vData.push_back(aData + vChannel * aNumberOfVoxels);
+    }
+  }
+
+  bpfSize vDone = 0;
+#if BPF_COMPOSITE_SIMD
+  vDone = HasAVX2() ? CompositeAVX2(vData.data(), aNumberOfVoxels, vChannels.data(), vChannels.size(), aRGBA) : CompositeSSE2(vData.data(), aNumberOfVoxels, vChannels.data(), vChannels.size(), aRGBA);
+#endif
+  for (bpfSize vIndex = vDone; vIndex < aNumberOfVoxels; ++vIndex) {
+    bpfPackedRGBA vSum(0, 0, 0, 0);
+    for (bpfSize vChannel = 0; vChannel < vChannels.size(); ++vChannel) {
+      const bpfRGBAChannelTable& vTable = *vChannels[vChannel];
+      vSum += vTable.mTable[GetTableIndex(vData[vChannel][vIndex], vTable.mScale, vTable.mOffset)];
+    }
+    aRGBA[vIndex] = vSum;
+  }
+}
+
+
+template class bpfRGBACompositor<bpfUInt8>;
+template class bpfRGBACompositor<bpfUInt16>;
+template class bpfRGBACompositor<bpfUInt32>;
+template class bpfRGBACompositor<bpfFloat>;
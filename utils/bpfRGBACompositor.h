@@ -0,0 +1,78 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BPF_RGBA_COMPOSITOR__
+#define __BPF_RGBA_COMPOSITOR__
+
+
+#include "ImarisReader/types/bpfPackedRGBA.h"
+#include "ImarisReader/types/bpfSmartPtr.h"
+#include "ImarisReader/interface/bpReaderTypes.h"
+
+#include <vector>
+
+
+/**
+ * The lookup table of one channel, built once per color info and shared by the compositors that use it.
+ */
+struct bpfRGBAChannelTable
+{
+  // entries of the table of a uint32 or float channel, which bins the display range
+  static const bpfSize mBinnedTableSize = 65536;
+
+  std::vector<bpfPackedRGBA> mTable;
+  // table index of a value for uint32 and float
+  bpfFloat mScale = 1;
+  bpfFloat mOffset = 0;
+};
+
+
+/**
+ * Composites the channels of a region read with ReadData into interleaved RGBA8 by additive
+ * blending, components saturate at 255. Every channel is mapped through a lookup table that
+ * holds cColorInfo::GetColor times the channel opacity, for all uint8 or uint16 values or for
+ * 65536 steps of the display range of uint32 and float channels.
+ */
+template<typename TDataType>
+class bpfRGBACompositor
+{
+public:
+  bpfRGBACompositor() = default;
+  explicit bpfRGBACompositor(const bpConverterTypes::tColorInfoVector& aColorInfoPerChannel);
+
+  // the table of aColorInfo for TDataType
+  static bpfSharedPtr<const bpfRGBAChannelTable> MakeChannelTable(const bpConverterTypes::cColorInfo& aColorInfo);
+
+  // rebuilds the table of one channel, e.g. after its range or color was changed
+  void SetColorInfo(bpfSize aChannelIndex, const bpConverterTypes::cColorInfo& aColorInfo);
+
+  // uses a table made by MakeChannelTable for one channel, a channel without table does not contribute
+  void SetChannelTable(bpfSize aChannelIndex, bpfSharedPtr<const bpfRGBAChannelTable> aTable);
+
+  /**
+   * aData holds aNumberOfChannels blocks of aNumberOfVoxels voxels each, as ReadData writes one
+   * time point, starting at channel aFirstChannelIndex. Writes aNumberOfVoxels colors to aRGBA.
+   */
+  void Composite(const TDataType* aData, bpfSize aNumberOfVoxels, bpfSize aFirstChannelIndex, bpfSize aNumberOfChannels, bpfPackedRGBA* aRGBA) const;
+
+private:
+  std::vector<bpfSharedPtr<const bpfRGBAChannelTable>> mChannels;
+};
+
+
+#endif // __BPF_RGBA_COMPOSITOR__
@@ -0,0 +1,88 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#include "ImarisReader/utils/bpfReadCoalescer.h"
+
+#include <algorithm>
+
+
+bpfReadCoalescer::bpfReadCoalescer(bpfSize aMaxGapBytes, bpfSize aMaxReadBytes)
+  : mMaxGapBytes(aMaxGapBytes),
+    mMaxReadBytes(aMaxReadBytes)
+{
+}
+
+
+void bpfReadCoalescer::Add(bpfUInt64 aOffset, bpfSize aSize, void* aData)
+{
+  mReads.push_back({ { aOffset, aSize, aData }, mReads.size() });
+}
+
+
+void bpfReadCoalescer::Read(bpStorageInterface& aStorage, std::vector<bool>& aIsRead)
+{
+  aIsRead.assign(mReads.size(), false);
+  if (mReads.empty()) {
+    return;
+  }
+
+  std::sort(mReads.begin(), mReads.end(), [](const cRead& aLeft, const cRead& aRight) {
+    return aLeft.mRange.mOffset < aRight.mRange.mOffset;
+  });
+
+  // each merged read is one run of contiguous ranges, the gaps share one scratch buffer
+  bpfSize vMaxGapSize = 0;
+  std::vector<bpfSize> vReadBegins;
+  for (bpfSize vIndex = 0; vIndex < mReads.size(); ++vIndex) {
+    const bpStorageInterface::cRange& vRange = mReads[vIndex].mRange;
+    if (vIndex > 0) {
+      const bpStorageInterface::cRange& vFirst = mReads[vReadBegins.back()].mRange;
+      const bpStorageInterface::cRange& vLast = mReads[vIndex - 1].mRange;
+      bpfUInt64 vReadEnd = vLast.mOffset + vLast.mSize;
+      if (vRange.mOffset >= vReadEnd && vRange.mOffset - vReadEnd <= mMaxGapBytes && vRange.mOffset + vRange.mSize - vFirst.mOffset <= mMaxReadBytes) {
+        vMaxGapSize = std::max(vMaxGapSize, static_cast<bpfSize>(vRange.mOffset - vReadEnd));
+        continue;
+      }
+    }
+    vReadBegins.push_back(vIndex);
+  }
+  vReadBegins.push_back(mReads.size());
+  mGap.resize(std::max(mGap.size(), vMaxGapSize));
+  bpfSize vNumberOfReads = vReadBegins.size() - 1;
+
+  std::vector<bpStorageInterface::cRange> vRanges;
+  for (bpfSize vRead = 0; vRead < vNumberOfReads; ++vRead) {
+    vRanges.clear();
+    for (bpfSize vIndex = vReadBegins[vRead]; vIndex < vReadBegins[vRead + 1]; ++vIndex) {
+      const bpStorageInterface::cRange& vRange = mReads[vIndex].mRange;
+      if (!vRanges.empty() && vRanges.back().mOffset + vRanges.back().mSize < vRange.mOffset) {
+        bpfUInt64 vGapBegin = vRanges.back().mOffset + vRanges.back().mSize;
+        vRanges.push_back({ vGapBegin, static_cast<bpfSize>(vRange.mOffset - vGapBegin), mGap.data() });
+      }
+      vRanges.push_back(vRange);
+    }
+
+    bool vIsRead = aStorage.ReadRanges(vRanges);
+    for (bpfSize vIndex = vReadBegins[vRead]; vIndex < vReadBegins[vRead + 1]; ++vIndex) {
+      const cRead& vRange = mReads[vIndex];
+      aIsRead[vRange.mIndex] = vIsRead || aStorage.Read(vRange.mRange.mOffset, vRange.mRange.mSize, vRange.mRange.mData);
+    }
+  }
+  mReads.clear();
+}
+
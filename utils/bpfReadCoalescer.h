@@ -0,0 +1,63 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BPF_READ_COALESCER__
+#define __BPF_READ_COALESCER__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+#include "ImarisReader/interface/bpStorageInterface.h"
+
+#include <vector>
+
+
+/**
+ * Collects reads of byte ranges of one file and issues them sorted by offset,
+ * ranges at most aMaxGapBytes apart are merged into one read of at most
+ * aMaxReadBytes. The gaps are read into a scratch buffer, so each merged read
+ * is one call of bpStorageInterface::ReadRanges with a run of contiguous ranges.
+ */
+class bpfReadCoalescer
+{
+public:
+  bpfReadCoalescer(bpfSize aMaxGapBytes, bpfSize aMaxReadBytes);
+
+  void Add(bpfUInt64 aOffset, bpfSize aSize, void* aData);
+
+  /**
+   * Reads the ranges added since the last call. If a merged read fails, its
+   * ranges are read one by one and aIsRead tells which of them, in the
+   * order they were added, were read completely.
+   */
+  void Read(bpStorageInterface& aStorage, std::vector<bool>& aIsRead);
+
+private:
+  struct cRead
+  {
+    bpStorageInterface::cRange mRange;
+    bpfSize mIndex;
+  };
+
+  bpfSize mMaxGapBytes;
+  bpfSize mMaxReadBytes;
+  std::vector<cRead> mReads;
+  std::vector<bpfUInt8> mGap;
+};
+
+
+#endif // __BPF_READ_COALESCER__
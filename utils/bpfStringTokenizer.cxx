@@ -0,0 +1,66 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#include "ImarisReader/utils/bpfStringTokenizer.h"
+
+#include <algorithm>
+
+
+bpfStringTokenizer::bpfStringTokenizer(const bpfChar* aBegin, const bpfChar* aEnd, bpfChar aSeparator, bool aSkipEmptyParts, bool aSkipEmptyBoundParts)
+  : mBegin(aBegin),
+    mEnd(aEnd),
+    mCurrent(aBegin),
+    mSeparator(aSeparator),
+    mSkipEmptyParts(aSkipEmptyParts),
+    mSkipEmptyBoundParts(aSkipEmptyBoundParts),
+    mIsDone(aBegin == aEnd)
+{
+}
+
+
+bpfStringTokenizer::bpfStringTokenizer(const bpfString& aString, bpfChar aSeparator, bool aSkipEmptyParts, bool aSkipEmptyBoundParts)
+  : bpfStringTokenizer(aString.data(), aString.data() + aString.size(), aSeparator, aSkipEmptyParts, aSkipEmptyBoundParts)
+{
+}
+
+
+bool bpfStringTokenizer::Next(const bpfChar*& aTokenBegin, const bpfChar*& aTokenEnd)
+{
+  while (!mIsDone) {
+    const bpfChar* vSeparator = std::find(mCurrent, mEnd, mSeparator);
+    aTokenBegin = mCurrent;
+    aTokenEnd = vSeparator;
+
+    if (vSeparator == mEnd) {
+      // the part after the last separator
+      mIsDone = true;
+      return aTokenBegin != aTokenEnd || !mSkipEmptyBoundParts;
+    }
+
+    mCurrent = vSeparator + 1;
+    // as bpfSplit, only a separator at the very beginning makes an empty bound part
+    bool vIsLeadingSeparator = vSeparator == mBegin;
+    if (vIsLeadingSeparator && mSkipEmptyBoundParts) {
+      continue;
+    }
+    if (aTokenBegin != aTokenEnd || !mSkipEmptyParts || (!mSkipEmptyBoundParts && vIsLeadingSeparator)) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,54 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+
+#ifndef __BPF_STRING_TOKENIZER__
+#define __BPF_STRING_TOKENIZER__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+
+
+/**
+ * Splits a character range at a separator character without copying. Returns the
+ * same tokens as bpfSplit(aString, aSeparator, aSkipEmptyParts, aSkipEmptyBoundParts),
+ * as pointers into the range, which must outlive the tokenizer.
+ */
+class bpfStringTokenizer
+{
+public:
+  bpfStringTokenizer(const bpfChar* aBegin, const bpfChar* aEnd, bpfChar aSeparator, bool aSkipEmptyParts, bool aSkipEmptyBoundParts);
+
+  explicit bpfStringTokenizer(const bpfString& aString, bpfChar aSeparator = ' ', bool aSkipEmptyParts = false, bool aSkipEmptyBoundParts = true);
+
+  /**
+   * Sets [aTokenBegin, aTokenEnd) to the next token. Returns false once all tokens were returned.
+   */
+  bool Next(const bpfChar*& aTokenBegin, const bpfChar*& aTokenEnd);
+
+private:
+  const bpfChar* mBegin;
+  const bpfChar* mEnd;
+  const bpfChar* mCurrent;
+  bpfChar mSeparator;
+  bool mSkipEmptyParts;
+  bool mSkipEmptyBoundParts;
+  bool mIsDone;
+};
+
+
+#endif // __BPF_STRING_TOKENIZER__
@@ -0,0 +1,122 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#include "ImarisReader/utils/bpfThreadPool.h"
+
+#include <atomic>
+
+
+bpfThreadPool::bpfThreadPool(bpfSize aNumberOfThreads)
+  : mStop(false)
+{
+  if (aNumberOfThreads == 0) {
+    aNumberOfThreads = std::max<bpfSize>(std::thread::hardware_concurrency(), 1);
+  }
+  for (bpfSize vIndex = 0; vIndex < aNumberOfThreads; ++vIndex) {
+    mThreads.emplace_back([this] { Work(); });
+  }
+}
+
+
+bpfThreadPool::~bpfThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> vLock(mMutex);
+    mStop = true;
+  }
+  mCondition.notify_all();
+  for (auto& vThread : mThreads) {
+    vThread.join();
+  }
+}
+
+
+bpfSize bpfThreadPool::GetNumberOfThreads() const
+{
+  return mThreads.size();
+}
+
+
+void bpfThreadPool::ParallelFor(bpfSize aCount, const std::function<void(bpfSize)>& aFunction)
+{
+  if (aCount == 0) {
+    return;
+  }
+
+  struct cState
+  {
+    std::atomic<bpfSize> mNext{ 0 };
+    bpfSize mDone = 0;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+  };
+  auto vState = std::make_shared<cState>();
+
+  // aFunction outlives all calls because this function waits for them
+  auto vRun = [vState, aCount, &aFunction] {
+    bpfSize vDone = 0;
+    for (bpfSize vIndex = vState->mNext++; vIndex < aCount; vIndex = vState->mNext++) {
+      aFunction(vIndex);
+      ++vDone;
+    }
+    if (vDone > 0) {
+      std::lock_guard<std::mutex> vLock(vState->mMutex);
+      vState->mDone += vDone;
+      if (vState->mDone == aCount) {
+        vState->mCondition.notify_all();
+      }
+    }
+  };
+
+  // helpers overtake queued tasks, the caller is already waiting for them
+  bpfSize vNumberOfHelpers = std::min(GetNumberOfThreads(), aCount - 1);
+  for (bpfSize vIndex = 0; vIndex < vNumberOfHelpers; ++vIndex) {
+    Enqueue(vRun, std::numeric_limits<bpfInt32>::max());
+  }
+  vRun();
+
+  std::unique_lock<std::mutex> vLock(vState->mMutex);
+  vState->mCondition.wait(vLock, [&vState, aCount] { return vState->mDone == aCount; });
+}
+
+
+void bpfThreadPool::Enqueue(std::function<void()> aTask, bpfInt32 aPriority)
+{
+  {
+    std::lock_guard<std::mutex> vLock(mMutex);
+    mTasks.emplace(aPriority, std::move(aTask));
+  }
+  mCondition.notify_one();
+}
+
+
+void bpfThreadPool::Work()
+{
+  for (;;) {
+    std::function<void()> vTask;
+    {
+      std::unique_lock<std::mutex> vLock(mMutex);
+      mCondition.wait(vLock, [this] { return mStop || !mTasks.empty(); });
+      if (mStop && mTasks.empty()) {
+        return;
+      }
+      vTask = std::move(mTasks.begin()->second);
+      mTasks.erase(mTasks.begin());
+    }
+    vTask();
+  }
+}
@@ -0,0 +1,75 @@
+/***************************************************************************
+ *   Copyright (c) 2024-present Bitplane AG Zuerich                        *
+ *                                                                         *
+ *   Licensed under the Apache License, Version 2.0 (the "License");       *
+ *   you may not use this file except in compliance with the License.      *
+ *   You may obtain a copy of the License at                               *
+ *                                                                         *
+ *       http://www.apache.org/licenses/LICENSE-2.0                        *
+ *                                                                         *
+ *   Unless required by applicable law or agreed to in writing, software   *
+ *   distributed under the License is distributed on an "AS IS" BASIS,     *
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or imp   *
+ *   See the License for the specific language governing permissions and   *
+ *   limitations under the License.                                        *
+ ***************************************************************************/
+
+
+#ifndef __BPF_THREAD_POOL__
+#define __BPF_THREAD_POOL__
+
+
+#include "ImarisReader/types/bpfTypes.h"
+
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Fixed number of worker threads executing queued tasks. Tasks of higher priority
+ * are started first, tasks of equal priority in the order they were queued.
+ */
+class bpfThreadPool
+{
+public:
+  /**
+   * Starts aNumberOfThreads workers, or one per hardware thread if aNumberOfThreads is 0.
+   */
+  explicit bpfThreadPool(bpfSize aNumberOfThreads);
+  ~bpfThreadPool();
+
+  bpfThreadPool(const bpfThreadPool&) = delete;
+  bpfThreadPool& operator=(const bpfThreadPool&) = delete;
+
+  bpfSize GetNumberOfThreads() const;
+
+  /**
+   * Calls aFunction(vIndex) for every vIndex in [0, aCount) on the workers and on the
+   * calling thread. Returns when all calls have finished.
+   */
+  void ParallelFor(bpfSize aCount, const std::function<void(bpfSize)>& aFunction);
+
+  /**
+   * Queues aTask, which runs on one of the workers. Tasks still queued when the pool
+   * is destroyed are run before the destructor returns.
+   */
+  void Enqueue(std::function<void()> aTask, bpfInt32 aPriority = 0);
+
+private:
+  void Work();
+
+  std::vector<std::thread> mThreads;
+  // highest priority first, equal keys keep their insertion order
+  std::multimap<bpfInt32, std::function<void()>, std::greater<bpfInt32>> mTasks;
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  bool mStop;
+};
+
+
+#endif // __BPF_THREAD_POOL__
@@ -211,6 +211,93 @@ std::vector<bpfString> bpfSplit(const bpfString& aString, const bpfString& aSepa
   return vVector;
 }
 
+// reads the digits at aPos into aValue, returns their number or 0 if there are none or too many
+static bpfSize ParseDigits(const bpfChar*& aPos, const bpfChar* aEnd, bpfUInt64& aValue)
+{
+  bpfSize vNumberOfDigits = 0;
+  for (; aPos != aEnd && *aPos >= '0' && *aPos <= '9'; ++aPos, ++vNumberOfDigits) {
+    if (aValue >= (bpfUInt64(1) << 59)) {
+      return 0;
+    }
+    aValue = 10 * aValue + (*aPos - '0');
+  }
+  return vNumberOfDigits;
+}
+
+
+void bpfFromString(const bpfChar* aBegin, const bpfChar* aEnd, bpfFloat& aResult)
+{
+  // [+-]digits[.digits][(e|E)[+-]digits], with at least one digit before the exponent
+  const bpfChar* vPos = aBegin;
+  bool vIsNegative = vPos != aEnd && *vPos == '-';
+  if (vPos != aEnd && (*vPos == '-' || *vPos == '+')) {
+    ++vPos;
+  }
+  bpfUInt64 vMantissa = 0;
+  bool vHasDigits = ParseDigits(vPos, aEnd, vMantissa) > 0;
+  bpfInt64 vExponent = 0;
+  bool vIsValid = true;
+  if (vPos != aEnd && *vPos == '.') {
+    ++vPos;
+    const bpfChar* vFraction = vPos;
+    bpfSize vNumberOfFractionDigits = ParseDigits(vPos, aEnd, vMantissa);
+    vIsValid = vNumberOfFractionDigits > 0 || vPos == vFraction;
+    vHasDigits = vHasDigits || vNumberOfFractionDigits > 0;
+    vExponent -= static_cast<bpfInt64>(vNumberOfFractionDigits);
+  }
+  vIsValid = vIsValid && vHasDigits;
+  if (vIsValid && vPos != aEnd && (*vPos == 'e' || *vPos == 'E')) {
+    ++vPos;
+    bool vIsNegativeExponent = vPos != aEnd && *vPos == '-';
+    if (vPos != aEnd && (*vPos == '-' || *vPos == '+')) {
+      ++vPos;
+    }
+    bpfUInt64 vExponentValue = 0;
+    vIsValid = ParseDigits(vPos, aEnd, vExponentValue) > 0 && vExponentValue < 1000;
+    vExponent += vIsNegativeExponent ? -static_cast<bpfInt64>(vExponentValue) : static_cast<bpfInt64>(vExponentValue);
+  }
+
+  if (vIsValid && vPos == aEnd) {
+    while (vMantissa != 0 && vMantissa % 10 == 0) {
+      vMantissa /= 10;
+      ++vExponent;
+    }
+    // mantissa and power of ten are exact floats, so one correctly rounded operation gives
+    // the correctly rounded result of the stream (Clinger's fast path)
+    static const bpfFloat vPowersOfTen[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+    if (vMantissa == 0 || (vMantissa <= (bpfUInt64(1) << 24) && vExponent >= -10 && vExponent <= 10)) {
+      bpfFloat vValue = static_cast<bpfFloat>(vMantissa);
+      if (vMantissa != 0 && vExponent < 0) {
+        vValue /= vPowersOfTen[-vExponent];
+      }
+      else if (vMantissa != 0) {
+        vValue *= vPowersOfTen[vExponent];
+      }
+      aResult = vIsNegative ? -vValue : vValue;
+      return;
+    }
+  }
+
+  bpfFromString(bpfString(aBegin, aEnd), aResult);
+}
+
+
+void bpfFromString(const bpfChar* aBegin, const bpfChar* aEnd, bpfSize& aResult)
+{
+  const bpfChar* vPos = aBegin;
+  if (vPos != aEnd && *vPos == '+') {
+    ++vPos;
+  }
+  bpfUInt64 vValue = 0;
+  if (ParseDigits(vPos, aEnd, vValue) > 0 && vPos == aEnd) {
+    aResult = static_cast<bpfSize>(vValue);
+    return;
+  }
+
+  bpfFromString(bpfString(aBegin, aEnd), aResult);
+}
+
+
 bpfString bpfJoin(const std::vector<bpfString>& aStrings, const bpfString& aDelimitor)
 {
   return bpfJoin(aStrings.begin(), aStrings.end(), aDelimitor);
@@ -614,42 +701,3 @@ bool bpfTimeInfoFromAnyFormat(const bpfString& aDateTime, bpfTimeInfo& aTimeInfo
   }
   return false;
 }
-
-
-void FixPadding(bpfChar* aData, const bpfUInt64 (&aSrcDim)[3], const bpfUInt64 (&aDestDim)[3], bpfUInt32 aSizeOfType)
-{
-  if (aSrcDim[0] == aDestDim[0] && aSrcDim[1] == aDestDim[1] && aSrcDim[2] == aDestDim[2]) {
-    return;
-  }
-  else if (aSrcDim[0] > aDestDim[0] || aSrcDim[1] > aDestDim[1] || aSrcDim[2] > aDestDim[2]) {
-    // This would be the right place to throw an exception, but exceptions thrown in ReadDataBlock are silently suppressed.
-    // Anyway, it should be clear that this code position should never be reached, negative padding should never occur.
-    return;
-  }
-
-  bpfUInt64 vSrcBlockSizeBytesX = aSizeOfType * aSrcDim[0];
-  bpfUInt64 vDestBlockSizeBytesX = aSizeOfType * aDestDim[0];
-
-  // starts from the end so that padding does not override data that still has to be copied in a more advanced position
-  const bpfChar* vSrc = aData + vSrcBlockSizeBytesX * aSrcDim[1] * aSrcDim[2];
-  bpfChar* vDest = aData + vDestBlockSizeBytesX * aDestDim[1] * aDestDim[2];
-
-  bpfUInt64 vPadBytesXYZ = (aDestDim[2] - aSrcDim[2]) * aDestDim[1] * vDestBlockSizeBytesX;
-  bpfUInt64 vPadBytesXY = (aDestDim[1] - aSrcDim[1]) * vDestBlockSizeBytesX;
-  bpfUInt64 vPadBytesX = vDestBlockSizeBytesX - vSrcBlockSizeBytesX;
-
-  vDest -= vPadBytesXYZ;
-  memset(vDest, 0, (bpfSize)vPadBytesXYZ);
-  for (bpfSize vIndexZ = 0; vIndexZ < aSrcDim[2]; vIndexZ++) {
-    vDest -= vPadBytesXY;
-    memset(vDest, 0, (bpfSize)vPadBytesXY);
-    for (bpfSize vIndexY = 0; vIndexY < aSrcDim[1]; vIndexY++) {
-      vDest -= vPadBytesX;
-      memset(vDest, 0, (bpfSize)vPadBytesX);
-      vSrc -= vSrcBlockSizeBytesX;
-      vDest -= vSrcBlockSizeBytesX;
-      memcpy(vDest, vSrc, (bpfSize)vSrcBlockSizeBytesX);
-    }
-  }
-
-}
@@ -77,6 +77,14 @@ TValue bpfJoin(TIterator aBegin, TIterator aEnd, const TValue& aDelimitor)
   return vResult;
 }
 
+/**
+ * Same results as bpfFromString(bpfString(aBegin, aEnd), aResult). Plain decimal numbers,
+ * such as "-0.25", "1e2" or "70", are parsed without allocating and independent of the
+ * locale, everything else goes through the stream.
+ */
+void bpfFromString(const bpfChar* aBegin, const bpfChar* aEnd, bpfFloat& aResult);
+void bpfFromString(const bpfChar* aBegin, const bpfChar* aEnd, bpfSize& aResult);
+
 bpfString bpfIntToString(bpfUInt16 aValue);
 
 bpfString bpfGetTemporaryPath();
@@ -111,8 +119,6 @@ bool bpfTimeInfoFromMetamorphFormat(const bpfString& aTime, bpfTimeInfo& aTimeIn
 bool bpfTimeInfoFromAnyFormat(const bpfString& aTime, bpfTimeInfo& aTimeInfo);
 
 
-void FixPadding(bpfChar* aData, const bpfUInt64 (&aSrcDim)[3], const bpfUInt64 (&aDestDim)[3], bpfUInt32 aSizeOfType);
-
 //same values used to check timepoints
 //from base/application/bpData.cxx
 //const bpfTimeInfo mValidTimeInfoMin("1750-01-01");